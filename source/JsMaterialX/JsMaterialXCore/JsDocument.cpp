@@ -24,6 +24,9 @@ EMSCRIPTEN_BINDINGS(document)
         .function("initialize", &mx::Document::initialize)
         .function("copy", &mx::Document::copy)
         .function("importLibrary", &mx::Document::importLibrary)
+        .function("setDataLibrary", &mx::Document::setDataLibrary)
+        .function("getDataLibrary", &mx::Document::getDataLibrary)
+        .function("hasDataLibrary", &mx::Document::hasDataLibrary)
         .function("getReferencedSourceUris", ems::optional_override([](mx::Document &self) {
             mx::StringSet set = self.getReferencedSourceUris();
             return ems::val::array(set.begin(), set.end());
@@ -32,12 +35,21 @@ EMSCRIPTEN_BINDINGS(document)
         .function("getNodeGraph", &mx::Document::getNodeGraph)
         .function("getNodeGraphs", &mx::Document::getNodeGraphs)
         .function("removeNodeGraph", &mx::Document::removeNodeGraph)
-        .function("getMatchingPorts", &mx::Document::getMatchingPorts)
+        .function("getMatchingPorts", ems::optional_override([](mx::Document &self, const std::string& nodeName) {
+            return self.getMatchingPorts(nodeName).getVector();
+        }))
         BIND_MEMBER_FUNC("addGeomInfo", mx::Document, addGeomInfo, 0, 2, stRef, stRef)
         .function("getGeomInfo", &mx::Document::getGeomInfo)
         .function("getGeomInfos", &mx::Document::getGeomInfos)
         .function("removeGeomInfo", &mx::Document::removeGeomInfo)
-        BIND_MEMBER_FUNC("getGeomPropValue", mx::Document, getGeomPropValue, 1, 2, stRef, stRef)
+        .function("getGeomPropValue", ems::optional_override([](mx::Document &self, const std::string& geomPropName) -> mx::ValuePtr {
+            mx::ConstValuePtr value = self.getGeomPropValue(geomPropName);
+            return value ? value->copy() : nullptr;
+        }))
+        .function("getGeomPropValue", ems::optional_override([](mx::Document &self, const std::string& geomPropName, const std::string& geom) -> mx::ValuePtr {
+            mx::ConstValuePtr value = self.getGeomPropValue(geomPropName, geom);
+            return value ? value->copy() : nullptr;
+        }))
         .function("addGeomPropDef", &mx::Document::addGeomPropDef)
         .function("getGeomPropDef", &mx::Document::getGeomPropDef)
         .function("getGeomPropDefs", &mx::Document::getGeomPropDefs)
@@ -64,7 +76,9 @@ EMSCRIPTEN_BINDINGS(document)
         .function("getNodeDef", &mx::Document::getNodeDef)
         .function("getNodeDefs", &mx::Document::getNodeDefs)
         .function("removeNodeDef", &mx::Document::removeNodeDef)
-        .function("getMatchingNodeDefs", &mx::Document::getMatchingNodeDefs)
+        .function("getMatchingNodeDefs", ems::optional_override([](mx::Document &self, const std::string& nodeName) {
+            return self.getMatchingNodeDefs(nodeName).getVector();
+        }))
         BIND_MEMBER_FUNC("addAttributeDef", mx::Document, addAttributeDef, 0, 1, stRef)
         .function("getAttributeDef", &mx::Document::getAttributeDef)
         .function("getAttributeDefs", &mx::Document::getAttributeDefs)
@@ -85,7 +99,9 @@ EMSCRIPTEN_BINDINGS(document)
         .function("getImplementation", &mx::Document::getImplementation)
         .function("getImplementations", &mx::Document::getImplementations)
         .function("removeImplementation", &mx::Document::removeImplementation)
-        .function("getMatchingImplementations", &mx::Document::getMatchingImplementations)
+        .function("getMatchingImplementations", ems::optional_override([](mx::Document &self, const std::string& nodeDef) {
+            return self.getMatchingImplementations(nodeDef).getVector();
+        }))
         .function("addUnitDef", &mx::Document::addUnitDef)
         .function("getUnitDef", &mx::Document::getUnitDef)
         .function("getUnitDefs", &mx::Document::getUnitDefs)
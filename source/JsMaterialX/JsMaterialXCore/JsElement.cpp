@@ -208,9 +208,15 @@ EMSCRIPTEN_BINDINGS(element)
         BIND_VALUE_ELEMENT_FUNC_INSTANCE(FloatArray, mx::FloatVec)
         BIND_VALUE_ELEMENT_FUNC_INSTANCE(StringArray, mx::StringVec)
         .function("hasValue", &mx::ValueElement::hasValue)
-        .function("getValue", &mx::ValueElement::getValue)
+        .function("getValue", ems::optional_override([](mx::ValueElement &self) -> mx::ValuePtr {
+            mx::ConstValuePtr value = self.getValue();
+            return value ? value->copy() : nullptr;
+        }))
         BIND_MEMBER_FUNC("getResolvedValue", mx::ValueElement, getResolvedValue, 0, 1, mx::StringResolverPtr)
-        .function("getDefaultValue", &mx::ValueElement::getDefaultValue)
+        .function("getDefaultValue", ems::optional_override([](mx::ValueElement &self) -> mx::ValuePtr {
+            mx::ConstValuePtr value = self.getDefaultValue();
+            return value ? value->copy() : nullptr;
+        }))
         .function("setUnit", &mx::ValueElement::setUnit)
         .function("hasUnit", &mx::ValueElement::hasUnit)
         .function("getUnit", &mx::ValueElement::getUnit)
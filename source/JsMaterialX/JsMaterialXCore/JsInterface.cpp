@@ -104,7 +104,14 @@ EMSCRIPTEN_BINDINGS(interface)
         BIND_INTERFACE_TYPE_INSTANCE(BooleanArray, mx::BoolVec)
         BIND_INTERFACE_TYPE_INSTANCE(FloatArray, mx::FloatVec)
         BIND_INTERFACE_TYPE_INSTANCE(StringArray, mx::StringVec)
-        BIND_MEMBER_FUNC("getInputValue", mx::InterfaceElement, getInputValue, 1, 2, stRef, stRef)
+        .function("getInputValue", ems::optional_override([](mx::InterfaceElement &self, const std::string& name) -> mx::ValuePtr {
+            mx::ConstValuePtr value = self.getInputValue(name);
+            return value ? value->copy() : nullptr;
+        }))
+        .function("getInputValue", ems::optional_override([](mx::InterfaceElement &self, const std::string& name, const std::string& target) -> mx::ValuePtr {
+            mx::ConstValuePtr value = self.getInputValue(name, target);
+            return value ? value->copy() : nullptr;
+        }))
         .function("setTokenValue", &mx::InterfaceElement::setTokenValue)
         .function("getTokenValue", &mx::InterfaceElement::getTokenValue)
         .function("setTarget", &mx::InterfaceElement::setTarget)
@@ -65,7 +65,10 @@ EMSCRIPTEN_BINDINGS(property)
         BIND_PROPERTYSET_TYPE_INSTANCE(BooleanArray, mx::BoolVec)
         BIND_PROPERTYSET_TYPE_INSTANCE(FloatArray, mx::FloatVec)
         BIND_PROPERTYSET_TYPE_INSTANCE(StringArray, mx::StringVec)
-        .function("getPropertyValue", &mx::PropertySet::getPropertyValue)
+        .function("getPropertyValue", ems::optional_override([](mx::PropertySet &self, const std::string& name) -> mx::ValuePtr {
+            mx::ConstValuePtr value = self.getPropertyValue(name);
+            return value ? value->copy() : nullptr;
+        }))
         .class_property("CATEGORY", &mx::Property::CATEGORY);
         
     ems::class_<mx::PropertySetAssign, ems::base<mx::GeomElement>>("PropertySetAssign")
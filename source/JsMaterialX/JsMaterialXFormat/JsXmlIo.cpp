@@ -30,6 +30,7 @@ EMSCRIPTEN_BINDINGS(xmlio)
             })
         .property("readComments", &mx::XmlReadOptions::readComments)
         .property("upgradeVersion", &mx::XmlReadOptions::upgradeVersion)                
+        .property("readStreaming", &mx::XmlReadOptions::readStreaming)
         .property("parentXIncludes", &mx::XmlReadOptions::parentXIncludes);
 
     ems::class_<mx::XmlWriteOptions>("XmlWriteOptions")
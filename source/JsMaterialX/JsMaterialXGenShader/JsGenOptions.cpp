@@ -43,5 +43,6 @@ EMSCRIPTEN_BINDINGS(GenOptions)
         .property("hwNormalizeUdimTexCoords", &mx::GenOptions::hwNormalizeUdimTexCoords)
         .property("hwWriteAlbedoTable", &mx::GenOptions::hwWriteAlbedoTable)
         .property("hwWriteEnvPrefilter", &mx::GenOptions::hwWriteEnvPrefilter)
+        .property("optimizeShaderGraph", &mx::GenOptions::optimizeShaderGraph)
         ;
 }
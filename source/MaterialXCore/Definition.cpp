@@ -59,41 +59,48 @@ const string& NodeDef::getType() const
 
 InterfaceElementPtr NodeDef::getImplementation(const string& target) const
 {
-    vector<InterfaceElementPtr> interfaces = getDocument()->getMatchingImplementations(getQualifiedName(getName()));
-    vector<InterfaceElementPtr> secondary = getDocument()->getMatchingImplementations(getName());
-    interfaces.insert(interfaces.end(), secondary.begin(), secondary.end());
+    ConstDocumentPtr doc = getDocument();
+    ElementSpan<InterfaceElement> primary = doc->getMatchingImplementations(getQualifiedName(getName()));
+    ElementSpan<InterfaceElement> secondary = doc->getMatchingImplementations(getName());
+    const vector<InterfaceElementPtr>* interfaceLists[] = { &primary.getVector(), &secondary.getVector() };
 
     if (target.empty())
     {
-        return !interfaces.empty() ? interfaces[0] : InterfaceElementPtr();
+        return !primary.empty() ? primary[0] : (!secondary.empty() ? secondary[0] : InterfaceElementPtr());
     }
 
     // Get all candidate targets matching the given target,
     // taking inheritance into account.
-    const TargetDefPtr targetDef = getDocument()->getTargetDef(target);
+    const TargetDefPtr targetDef = doc->getTargetDef(target);
     const StringVec candidateTargets = targetDef ? targetDef->getMatchingTargets() : StringVec();
 
     // First, search for a target-specific match.
     for (const string& candidateTarget : candidateTargets)
     {
-        for (InterfaceElementPtr interface : interfaces)
+        for (const vector<InterfaceElementPtr>* interfaces : interfaceLists)
         {
-            const std::string& interfaceTarget = interface->getTarget();
-            if (!interfaceTarget.empty() && targetStringsMatch(interfaceTarget, candidateTarget))
+            for (const InterfaceElementPtr& interface : *interfaces)
             {
-                return interface;
+                const std::string& interfaceTarget = interface->getTarget();
+                if (!interfaceTarget.empty() && targetStringsMatch(interfaceTarget, candidateTarget))
+                {
+                    return interface;
+                }
             }
         }
     }
 
     // Then search for a generic match.
-    for (InterfaceElementPtr interface : interfaces)
+    for (const vector<InterfaceElementPtr>* interfaces : interfaceLists)
     {
-        // Look for interfaces without targets
-        const std::string& interfaceTarget = interface->getTarget();
-        if (interfaceTarget.empty())
+        for (const InterfaceElementPtr& interface : *interfaces)
         {
-            return interface;
+            // Look for interfaces without targets
+            const std::string& interfaceTarget = interface->getTarget();
+            if (interfaceTarget.empty())
+            {
+                return interface;
+            }
         }
     }
 
@@ -5,6 +5,7 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <atomic>
 #include <mutex>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -28,6 +29,33 @@ DocumentPtr createDocument()
 
 class Document::Cache
 {
+  public:
+    // Entries of a cache map, each paired with the element from which it
+    // was derived.  Entries are kept in document traversal order of their
+    // source elements, matching the order of a full rebuild.
+    //
+    // Values are published as immutable snapshots, which lookups share with
+    // their callers.  Edits build a new snapshot and swap it in atomically,
+    // so snapshots held by callers are never modified.  Layered values
+    // combine the values with those of the data library, and are built on
+    // demand for keys that are matched by both, recording the snapshots
+    // from which they were built.
+    template <class T> struct Entries
+    {
+        using ElementVec = vector<shared_ptr<T>>;
+        struct Layered
+        {
+            shared_ptr<const ElementVec> local;
+            ElementSpan<T> library;
+            ElementVec values;
+        };
+
+        vector<ElementPtr> sources;
+        shared_ptr<ElementVec> values;
+        shared_ptr<const Layered> layered;
+    };
+    template <class T> using EntryMap = std::unordered_map<string, Entries<T>>;
+
   public:
     Cache() :
         valid(false)
@@ -37,91 +65,389 @@ class Document::Cache
 
     void refresh()
     {
+        // Readers of a valid cache proceed without locking.
+        if (valid.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
         // Thread synchronization for multiple concurrent readers of a single document.
         std::lock_guard<std::mutex> guard(mutex);
 
-        if (!valid)
+        if (!valid.load(std::memory_order_relaxed))
         {
             // Clear the existing cache.
             portElementMap.clear();
             nodeDefMap.clear();
             implementationMap.clear();
+            nodeGraphReferences.clear();
 
             // Traverse the document to build a new cache.
             for (ElementPtr elem : doc.lock()->traverseTree())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                addElement(elem, false);
+            }
+
+            valid.store(true, std::memory_order_release);
+        }
+    }
+
+    // Add the given element, and optionally its descendants, to a valid cache.
+    void addTree(ElementPtr elem, bool descendants)
+    {
+        if (!valid || !isAttached(elem) || !checkNodeGraphReferences(elem))
+        {
+            return;
+        }
+        if (descendants)
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                addElement(descendant, true);
+            }
+        }
+        else
+        {
+            addElement(elem, true);
+        }
+    }
+
+    // Remove the given element, and optionally its descendants, from a valid cache.
+    void removeTree(ElementPtr elem, bool descendants)
+    {
+        if (!valid || !isAttached(elem) || !checkNodeGraphReferences(elem))
+        {
+            return;
+        }
+        if (descendants)
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                removeElement(descendant);
+            }
+        }
+        else
+        {
+            removeElement(elem);
+        }
+    }
+
+    // Invalidate the cache if renaming the given element changes the resolution
+    // of implementations that reference nodegraphs by name.
+    void rename(ElementPtr elem, const string& name)
+    {
+        if (valid && isTopLevelNodeGraph(elem) &&
+            (nodeGraphReferences.count(elem->getName()) || nodeGraphReferences.count(name)))
+        {
+            valid = false;
+        }
+    }
+
+    // Return the values of the given cache map matching the given key.
+    template <class T> static ElementSpan<T> getEntries(const EntryMap<T>& map, const string& key)
+    {
+        auto it = map.find(key);
+        if (it == map.end())
+        {
+            return ElementSpan<T>();
+        }
+        return ElementSpan<T>(std::atomic_load(&it->second.values));
+    }
 
-                if (!nodeName.empty())
+    // Return the values of the given cache map matching the given key,
+    // followed by the given values from the data library.  Concurrent
+    // readers may each build the layered values, and the last to finish
+    // publishes them.
+    template <class T> static ElementSpan<T> getLayeredEntries(EntryMap<T>& map, const string& key,
+                                                               const ElementSpan<T>& libraryValues)
+    {
+        auto it = map.find(key);
+        if (it == map.end())
+        {
+            return libraryValues;
+        }
+        Entries<T>& entries = it->second;
+        shared_ptr<const typename Entries<T>::ElementVec> local = std::atomic_load(&entries.values);
+        if (libraryValues.empty())
+        {
+            return ElementSpan<T>(local);
+        }
+
+        shared_ptr<const typename Entries<T>::Layered> layered = std::atomic_load(&entries.layered);
+        if (!layered || layered->local != local || &layered->library.getVector() != &libraryValues.getVector())
+        {
+            auto newLayered = std::make_shared<typename Entries<T>::Layered>();
+            newLayered->local = local;
+            newLayered->library = libraryValues;
+            newLayered->values.reserve(local->size() + libraryValues.size());
+            newLayered->values.insert(newLayered->values.end(), local->begin(), local->end());
+            newLayered->values.insert(newLayered->values.end(), libraryValues.begin(), libraryValues.end());
+            layered = newLayered;
+            std::atomic_store(&entries.layered, layered);
+        }
+        return ElementSpan<T>(shared_ptr<const typename Entries<T>::ElementVec>(layered, &layered->values));
+    }
+
+    // Return true if changes to the given attribute may affect the cache.
+    static bool isCachedAttribute(const string& attrib)
+    {
+        return attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+               attrib == PortElement::NODE_GRAPH_ATTRIBUTE ||
+               attrib == NodeDef::NODE_ATTRIBUTE ||
+               attrib == InterfaceElement::NODE_DEF_ATTRIBUTE ||
+               attrib == Element::NAMESPACE_ATTRIBUTE;
+    }
+
+  private:
+    void addElement(ElementPtr elem, bool ordered)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty() || !nodeGraphName.empty())
+        {
+            PortElementPtr portElem = elem->asA<PortElement>();
+            if (portElem)
+            {
+                const string& key = portElem->getQualifiedName(!nodeName.empty() ? nodeName : nodeGraphName);
+                addEntry(portElementMap[key], elem, portElem, ordered);
+            }
+        }
+        if (!nodeString.empty())
+        {
+            NodeDefPtr nodeDef = elem->asA<NodeDef>();
+            if (nodeDef)
+            {
+                addEntry(nodeDefMap[nodeDef->getQualifiedName(nodeString)], elem, nodeDef, ordered);
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            InterfaceElementPtr interface = elem->asA<InterfaceElement>();
+            if (interface)
+            {
+                if (interface->isA<NodeGraph>())
                 {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap[portElem->getQualifiedName(nodeName)].push_back(portElem);
-                    }
+                    addEntry(implementationMap[interface->getQualifiedName(nodeDefString)], elem, interface, ordered);
                 }
-                else
+                ImplementationPtr impl = interface->asA<Implementation>();
+                if (impl)
                 {
-                    if (!nodeGraphName.empty())
+                    // Check for implementation which specifies a nodegraph as the implementation
+                    const string& nodeGraphString = impl->getNodeGraph();
+                    if (!nodeGraphString.empty())
                     {
-                        PortElementPtr portElem = elem->asA<PortElement>();
-                        if (portElem)
-                        {
-                            portElementMap[portElem->getQualifiedName(nodeGraphName)].push_back(portElem);
-                        }
+                        nodeGraphReferences[nodeGraphString]++;
+                        NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
+                        if (nodeGraph)
+                            addEntry<InterfaceElement>(implementationMap[interface->getQualifiedName(nodeDefString)], elem, nodeGraph, ordered);
                     }
-                }
-                if (!nodeString.empty())
-                {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
+                    else
                     {
-                        nodeDefMap[nodeDef->getQualifiedName(nodeString)].push_back(nodeDef);
+                        addEntry(implementationMap[interface->getQualifiedName(nodeDefString)], elem, interface, ordered);
                     }
                 }
-                if (!nodeDefString.empty())
+            }
+        }
+    }
+
+    void removeElement(ElementPtr elem)
+    {
+        const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
+        const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty() || !nodeGraphName.empty())
+        {
+            removeEntry(portElementMap, elem->getQualifiedName(!nodeName.empty() ? nodeName : nodeGraphName), elem);
+        }
+        if (!nodeString.empty())
+        {
+            removeEntry(nodeDefMap, elem->getQualifiedName(nodeString), elem);
+        }
+        if (!nodeDefString.empty())
+        {
+            removeEntry(implementationMap, elem->getQualifiedName(nodeDefString), elem);
+            ImplementationPtr impl = elem->asA<Implementation>();
+            if (impl && !impl->getNodeGraph().empty())
+            {
+                auto it = nodeGraphReferences.find(impl->getNodeGraph());
+                if (it != nodeGraphReferences.end() && !--it->second)
                 {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface)
-                    {
-                        if (interface->isA<NodeGraph>())
-                        {
-                            implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
-                        }
-                        ImplementationPtr impl = interface->asA<Implementation>();
-                        if (impl)
-                        {
-                            // Check for implementation which specifies a nodegraph as the implementation
-                            const string& nodeGraphString = impl->getNodeGraph();
-                            if (!nodeGraphString.empty())
-                            {
-                                NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
-                                if (nodeGraph)
-                                    implementationMap[interface->getQualifiedName(nodeDefString)].push_back(nodeGraph);
-                            }
-                            else
-                            {
-                                implementationMap[interface->getQualifiedName(nodeDefString)].push_back(interface);
-                            }
-                        }
-                    }
+                    nodeGraphReferences.erase(it);
                 }
             }
+        }
+    }
 
-            valid = true;
+    // Add an entry to the given entries.  Unordered entries are appended
+    // during a full rebuild, before the snapshot is visible to readers, so
+    // they may be added in place.
+    template <class T> static void addEntry(Entries<T>& entries, ElementPtr source, shared_ptr<T> value, bool ordered)
+    {
+        if (!ordered)
+        {
+            if (!entries.values)
+            {
+                entries.values = std::make_shared<typename Entries<T>::ElementVec>();
+            }
+            entries.sources.push_back(source);
+            entries.values->push_back(value);
+            return;
         }
+
+        size_t index = entries.sources.size();
+        if (!entries.sources.empty() && !precedes(entries.sources.back(), source))
+        {
+            index = 0;
+            while (index < entries.sources.size() && precedes(entries.sources[index], source))
+            {
+                index++;
+            }
+        }
+        auto values = entries.values ? std::make_shared<typename Entries<T>::ElementVec>(*entries.values) :
+                                       std::make_shared<typename Entries<T>::ElementVec>();
+        entries.sources.insert(entries.sources.begin() + index, source);
+        values->insert(values->begin() + index, value);
+        publish(entries, values);
+    }
+
+    // Publish a new snapshot of values for the given entries.
+    template <class T> static void publish(Entries<T>& entries, shared_ptr<typename Entries<T>::ElementVec> values)
+    {
+        std::atomic_store(&entries.values, values);
+        std::atomic_store(&entries.layered, shared_ptr<const typename Entries<T>::Layered>());
+    }
+
+    template <class T> static void removeEntry(EntryMap<T>& map, const string& key, ElementPtr source)
+    {
+        auto it = map.find(key);
+        if (it == map.end())
+        {
+            return;
+        }
+        Entries<T>& entries = it->second;
+        shared_ptr<typename Entries<T>::ElementVec> values;
+        for (size_t i = entries.sources.size(); i-- > 0;)
+        {
+            if (entries.sources[i] == source)
+            {
+                if (!values)
+                {
+                    values = std::make_shared<typename Entries<T>::ElementVec>(*entries.values);
+                }
+                entries.sources.erase(entries.sources.begin() + i);
+                values->erase(values->begin() + i);
+            }
+        }
+        if (entries.sources.empty())
+        {
+            map.erase(it);
+        }
+        else if (values)
+        {
+            publish(entries, values);
+        }
+    }
+
+    // Return true if the first element precedes the second in document traversal order.
+    static bool precedes(ConstElementPtr first, ConstElementPtr second)
+    {
+        vector<ConstElementPtr> firstPath, secondPath;
+        for (ConstElementPtr elem = first; elem; elem = elem->getParent())
+        {
+            firstPath.push_back(elem);
+        }
+        for (ConstElementPtr elem = second; elem; elem = elem->getParent())
+        {
+            secondPath.push_back(elem);
+        }
+
+        // Find the children of the closest common ancestor that lead to each element.
+        auto firstIt = firstPath.rbegin();
+        auto secondIt = secondPath.rbegin();
+        ConstElementPtr ancestor;
+        while (firstIt != firstPath.rend() && secondIt != secondPath.rend() && *firstIt == *secondIt)
+        {
+            ancestor = *firstIt++;
+            ++secondIt;
+        }
+        if (secondIt == secondPath.rend())
+        {
+            return false;
+        }
+        if (firstIt == firstPath.rend())
+        {
+            return true;
+        }
+        if (!ancestor)
+        {
+            return false;
+        }
+
+        // Elements are commonly added as the last child of their parent.
+        const vector<ElementPtr>& children = ancestor->getChildren();
+        if (children.back() == *secondIt)
+        {
+            return true;
+        }
+        for (const ElementPtr& child : children)
+        {
+            if (child == *firstIt)
+            {
+                return true;
+            }
+            if (child == *secondIt)
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Return true if the given element is part of the document tree.
+    bool isAttached(ConstElementPtr elem) const
+    {
+        for (ConstElementPtr parent = elem->getParent(); parent; parent = parent->getParent())
+        {
+            if (parent->getChild(elem->getName()) != elem)
+            {
+                return false;
+            }
+            elem = parent;
+        }
+        return elem == doc.lock();
+    }
+
+    bool isTopLevelNodeGraph(ConstElementPtr elem) const
+    {
+        return elem->isA<NodeGraph>() && elem->getParent() && elem->getParent() == doc.lock();
+    }
+
+    // Invalidate the cache if adding or removing the given element changes
+    // the resolution of implementations that reference nodegraphs by name.
+    bool checkNodeGraphReferences(ConstElementPtr elem)
+    {
+        if (isTopLevelNodeGraph(elem) && nodeGraphReferences.count(elem->getName()))
+        {
+            valid = false;
+        }
+        return valid;
     }
 
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
-    bool valid;
-    std::unordered_map<string, std::vector<PortElementPtr>> portElementMap;
-    std::unordered_map<string, std::vector<NodeDefPtr>> nodeDefMap;
-    std::unordered_map<string, std::vector<InterfaceElementPtr>> implementationMap;
+    std::atomic<bool> valid;
+    EntryMap<PortElement> portElementMap;
+    EntryMap<NodeDef> nodeDefMap;
+    EntryMap<InterfaceElement> implementationMap;
+
+    // Reference counts of nodegraph names used by implementations.
+    std::unordered_map<string, size_t> nodeGraphReferences;
 };
 
 //
@@ -299,25 +625,18 @@ std::pair<int, int> Document::getVersionIntegers() const
     return InterfaceElement::getVersionIntegers();
 }
 
-vector<PortElementPtr> Document::getMatchingPorts(const string& nodeName) const
+ElementSpan<PortElement> Document::getMatchingPorts(const string& nodeName) const
 {
     // Refresh the cache.
     _cache->refresh();
 
     // Return all port elements matching the given node name.
-    if (_cache->portElementMap.count(nodeName))
-    {
-        return _cache->portElementMap.at(nodeName);
-    }
-    else
-    {
-        return vector<PortElementPtr>();
-    }
+    return Cache::getEntries(_cache->portElementMap, nodeName);
 }
 
-ValuePtr Document::getGeomPropValue(const string& geomPropName, const string& geom) const
+ConstValuePtr Document::getGeomPropValue(const string& geomPropName, const string& geom) const
 {
-    ValuePtr value;
+    ConstValuePtr value;
     for (GeomInfoPtr geomInfo : getGeomInfos())
     {
         if (!geomStringsMatch(geom, geomInfo->getActiveGeom()))
@@ -356,36 +675,30 @@ vector<OutputPtr> Document::getMaterialOutputs() const
     return materialOutputs;
 }
 
-vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
+ElementSpan<NodeDef> Document::getMatchingNodeDefs(const string& nodeName) const
 {
     // Refresh the cache.
     _cache->refresh();
 
     // Return all nodedefs matching the given node name.
-    if (_cache->nodeDefMap.count(nodeName))
-    {
-        return _cache->nodeDefMap.at(nodeName);
-    }
-    else
+    if (_dataLibrary)
     {
-        return vector<NodeDefPtr>();
+        return Cache::getLayeredEntries(_cache->nodeDefMap, nodeName, _dataLibrary->getMatchingNodeDefs(nodeName));
     }
+    return Cache::getEntries(_cache->nodeDefMap, nodeName);
 }
 
-vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& nodeDef) const
+ElementSpan<InterfaceElement> Document::getMatchingImplementations(const string& nodeDef) const
 {
     // Refresh the cache.
     _cache->refresh();
 
     // Return all implementations matching the given nodedef string.
-    if (_cache->implementationMap.count(nodeDef))
+    if (_dataLibrary)
     {
-        return _cache->implementationMap.at(nodeDef);
-    }
-    else
-    {
-        return vector<InterfaceElementPtr>();
+        return Cache::getLayeredEntries(_cache->implementationMap, nodeDef, _dataLibrary->getMatchingImplementations(nodeDef));
     }
+    return Cache::getEntries(_cache->implementationMap, nodeDef);
 }
 
 bool Document::validate(string* message) const
@@ -397,11 +710,52 @@ bool Document::validate(string* message) const
     return GraphElement::validate(message) && res;
 }
 
+void Document::setDataLibrary(ConstDocumentPtr dataLibrary)
+{
+    if (dataLibrary.get() == this)
+    {
+        throw Exception("A document cannot be its own data library");
+    }
+    _dataLibrary = dataLibrary;
+    invalidateCache();
+}
+
 void Document::invalidateCache()
 {
     _cache->valid = false;
 }
 
+void Document::onAddChild(ElementPtr child)
+{
+    _cache->addTree(child, true);
+}
+
+void Document::onRemoveChild(ElementPtr child)
+{
+    _cache->removeTree(child, true);
+}
+
+void Document::onChangingAttribute(ElementPtr elem, const string& attrib)
+{
+    if (attrib.empty() || Cache::isCachedAttribute(attrib))
+    {
+        _cache->removeTree(elem, attrib.empty() || attrib == NAMESPACE_ATTRIBUTE);
+    }
+}
+
+void Document::onChangedAttribute(ElementPtr elem, const string& attrib)
+{
+    if (attrib.empty() || Cache::isCachedAttribute(attrib))
+    {
+        _cache->addTree(elem, attrib.empty() || attrib == NAMESPACE_ATTRIBUTE);
+    }
+}
+
+void Document::onRename(ElementPtr elem, const string& name)
+{
+    _cache->rename(elem, name);
+}
+
 //
 // Deprecated methods
 //
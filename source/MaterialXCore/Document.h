@@ -23,6 +23,107 @@ using DocumentPtr = shared_ptr<Document>;
 /// A shared pointer to a const Document
 using ConstDocumentPtr = shared_ptr<const Document>;
 
+/// @class ElementSpan
+/// An immutable sequence of elements, returned by the cached lookups of a
+/// Document.  A span shares ownership of the cache snapshot that it refers
+/// to, so its contents remain valid and unchanged when the document is
+/// later modified.
+template <class T> class ElementSpan
+{
+  public:
+    using ElementVec = vector<shared_ptr<T>>;
+    using const_iterator = typename ElementVec::const_iterator;
+
+  public:
+    ElementSpan() { }
+    explicit ElementSpan(shared_ptr<const ElementVec> elements) :
+        _elements(std::move(elements))
+    {
+    }
+
+    /// Return the elements of this span as a vector.
+    const ElementVec& getVector() const
+    {
+        static const ElementVec EMPTY_ELEMENTS;
+        return _elements ? *_elements : EMPTY_ELEMENTS;
+    }
+
+    /// Return a copy of the elements of this span as a vector.
+    operator ElementVec() const
+    {
+        return getVector();
+    }
+
+    /// Return an iterator to the first element of this span.
+    const_iterator begin() const
+    {
+        return getVector().begin();
+    }
+
+    /// Return an iterator past the last element of this span.
+    const_iterator end() const
+    {
+        return getVector().end();
+    }
+
+    /// Return the number of elements in this span.
+    size_t size() const
+    {
+        return getVector().size();
+    }
+
+    /// Return true if this span contains no elements.
+    bool empty() const
+    {
+        return getVector().empty();
+    }
+
+    /// Return the element at the given index.
+    const shared_ptr<T>& operator[](size_t index) const
+    {
+        return getVector()[index];
+    }
+
+    /// Return the first element of this span.
+    const shared_ptr<T>& front() const
+    {
+        return getVector().front();
+    }
+
+    /// Return the last element of this span.
+    const shared_ptr<T>& back() const
+    {
+        return getVector().back();
+    }
+
+    /// Return true if the given span contains the same elements.
+    bool operator==(const ElementSpan& rhs) const
+    {
+        return getVector() == rhs.getVector();
+    }
+
+    /// Return true if the given span contains different elements.
+    bool operator!=(const ElementSpan& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// Return true if the given vector contains the same elements.
+    bool operator==(const ElementVec& rhs) const
+    {
+        return getVector() == rhs;
+    }
+
+    /// Return true if the given vector contains different elements.
+    bool operator!=(const ElementVec& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+  private:
+    shared_ptr<const ElementVec> _elements;
+};
+
 /// @class Document
 /// A MaterialX document, which represents the top-level element in the
 /// MaterialX ownership hierarchy.
@@ -50,6 +151,7 @@ class MX_CORE_API Document : public GraphElement
     {
         DocumentPtr doc = createDocument<Document>();
         doc->copyContentFrom(getSelf());
+        doc->setDataLibrary(_dataLibrary);
         return doc;
     }
 
@@ -59,6 +161,31 @@ class MX_CORE_API Document : public GraphElement
     /// @param library The library document to be imported.
     void importLibrary(const ConstDocumentPtr& library);
 
+    /// @name Data Library
+    /// @{
+
+    /// Set the data library referenced by this document.
+    /// Unlike an imported library, the data library is not copied into this
+    /// document, but is consulted as a read-only layer when resolving
+    /// definitions, such as nodedefs, implementations and typedefs.  A single
+    /// data library may be shared by any number of documents, and must not
+    /// be modified while it is referenced.
+    void setDataLibrary(ConstDocumentPtr dataLibrary);
+
+    /// Return the data library, if any, referenced by this document.
+    ConstDocumentPtr getDataLibrary() const
+    {
+        return _dataLibrary;
+    }
+
+    /// Return true if this document references a data library.
+    bool hasDataLibrary() const
+    {
+        return _dataLibrary != nullptr;
+    }
+
+    /// @}
+
     /// Get a list of source URI's referenced by the document
     StringSet getReferencedSourceUris() const;
 
@@ -96,7 +223,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return a vector of all port elements that match the given node name.
     /// Port elements support spatially-varying upstream connections to
     /// nodes, and include both Input and Output elements.
-    vector<PortElementPtr> getMatchingPorts(const string& nodeName) const;
+    /// The returned span is unaffected by later modifications to the document.
+    ElementSpan<PortElement> getMatchingPorts(const string& nodeName) const;
 
     /// @}
     /// @name GeomInfo Elements
@@ -134,7 +262,7 @@ class MX_CORE_API Document : public GraphElement
     }
 
     /// Return the value of a geometric property for the given geometry string.
-    ValuePtr getGeomPropValue(const string& geomPropName, const string& geom = UNIVERSAL_GEOM_NAME) const;
+    ConstValuePtr getGeomPropValue(const string& geomPropName, const string& geom = UNIVERSAL_GEOM_NAME) const;
 
     /// @}
     /// @name GeomPropDef Elements
@@ -154,13 +282,14 @@ class MX_CORE_API Document : public GraphElement
     /// Return the GeomPropDef, if any, with the given name.
     GeomPropDefPtr getGeomPropDef(const string& name) const
     {
-        return getChildOfType<GeomPropDef>(name);
+        return getLayeredChildOfType<GeomPropDef>(name);
     }
 
-    /// Return a vector of all GeomPropDef elements in the document.
+    /// Return a vector of all GeomPropDef elements in the document
+    /// and its data library.
     vector<GeomPropDefPtr> getGeomPropDefs() const
     {
-        return getChildrenOfType<GeomPropDef>();
+        return getLayeredChildrenOfType<GeomPropDef>();
     }
 
     /// Remove the GeomPropDef, if any, with the given name.
@@ -289,13 +418,14 @@ class MX_CORE_API Document : public GraphElement
     /// Return the TypeDef, if any, with the given name.
     TypeDefPtr getTypeDef(const string& name) const
     {
-        return getChildOfType<TypeDef>(name);
+        return getLayeredChildOfType<TypeDef>(name);
     }
 
-    /// Return a vector of all TypeDef elements in the document.
+    /// Return a vector of all TypeDef elements in the document
+    /// and its data library.
     vector<TypeDefPtr> getTypeDefs() const
     {
-        return getChildrenOfType<TypeDef>();
+        return getLayeredChildrenOfType<TypeDef>();
     }
 
     /// Remove the TypeDef, if any, with the given name.
@@ -345,13 +475,14 @@ class MX_CORE_API Document : public GraphElement
     /// Return the NodeDef, if any, with the given name.
     NodeDefPtr getNodeDef(const string& name) const
     {
-        return getChildOfType<NodeDef>(name);
+        return getLayeredChildOfType<NodeDef>(name);
     }
 
-    /// Return a vector of all NodeDef elements in the document.
+    /// Return a vector of all NodeDef elements in the document
+    /// and its data library.
     vector<NodeDefPtr> getNodeDefs() const
     {
-        return getChildrenOfType<NodeDef>();
+        return getLayeredChildrenOfType<NodeDef>();
     }
 
     /// Remove the NodeDef, if any, with the given name.
@@ -360,8 +491,10 @@ class MX_CORE_API Document : public GraphElement
         removeChildOfType<NodeDef>(name);
     }
 
-    /// Return a vector of all NodeDef elements that match the given node name.
-    vector<NodeDefPtr> getMatchingNodeDefs(const string& nodeName) const;
+    /// Return a vector of all NodeDef elements that match the given node name,
+    /// followed by those of the data library, if any.
+    /// The returned span is unaffected by later modifications to the document.
+    ElementSpan<NodeDef> getMatchingNodeDefs(const string& nodeName) const;
 
     /// @}
     /// @name AttributeDef Elements
@@ -380,13 +513,14 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     AttributeDefPtr getAttributeDef(const string& name) const
     {
-        return getChildOfType<AttributeDef>(name);
+        return getLayeredChildOfType<AttributeDef>(name);
     }
 
-    /// Return a vector of all AttributeDef elements in the document.
+    /// Return a vector of all AttributeDef elements in the document
+    /// and its data library.
     vector<AttributeDefPtr> getAttributeDefs() const
     {
-        return getChildrenOfType<AttributeDef>();
+        return getLayeredChildrenOfType<AttributeDef>();
     }
 
     /// Remove the AttributeDef, if any, with the given name.
@@ -412,13 +546,14 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     TargetDefPtr getTargetDef(const string& name) const
     {
-        return getChildOfType<TargetDef>(name);
+        return getLayeredChildOfType<TargetDef>(name);
     }
 
-    /// Return a vector of all TargetDef elements in the document.
+    /// Return a vector of all TargetDef elements in the document
+    /// and its data library.
     vector<TargetDefPtr> getTargetDefs() const
     {
-        return getChildrenOfType<TargetDef>();
+        return getLayeredChildrenOfType<TargetDef>();
     }
 
     /// Remove the TargetDef, if any, with the given name.
@@ -508,13 +643,14 @@ class MX_CORE_API Document : public GraphElement
     /// Return the Implementation, if any, with the given name.
     ImplementationPtr getImplementation(const string& name) const
     {
-        return getChildOfType<Implementation>(name);
+        return getLayeredChildOfType<Implementation>(name);
     }
 
-    /// Return a vector of all Implementation elements in the document.
+    /// Return a vector of all Implementation elements in the document
+    /// and its data library.
     vector<ImplementationPtr> getImplementations() const
     {
-        return getChildrenOfType<Implementation>();
+        return getLayeredChildrenOfType<Implementation>();
     }
 
     /// Remove the Implementation, if any, with the given name.
@@ -525,8 +661,10 @@ class MX_CORE_API Document : public GraphElement
 
     /// Return a vector of all node implementations that match the given
     /// NodeDef string.  Note that a node implementation may be either an
-    /// Implementation element or NodeGraph element.
-    vector<InterfaceElementPtr> getMatchingImplementations(const string& nodeDef) const;
+    /// Implementation element or NodeGraph element.  Matches from the data
+    /// library, if any, follow those of the document.
+    /// The returned span is unaffected by later modifications to the document.
+    ElementSpan<InterfaceElement> getMatchingImplementations(const string& nodeDef) const;
 
     /// @}
     /// @name UnitDef Elements
@@ -544,13 +682,13 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitDef, if any, with the given name.
     UnitDefPtr getUnitDef(const string& name) const
     {
-        return getChildOfType<UnitDef>(name);
+        return getLayeredChildOfType<UnitDef>(name);
     }
 
     /// Return a vector of all Member elements in the TypeDef.
     vector<UnitDefPtr> getUnitDefs() const
     {
-        return getChildrenOfType<UnitDef>();
+        return getLayeredChildrenOfType<UnitDef>();
     }
 
     /// Remove the UnitDef, if any, with the given name.
@@ -575,13 +713,14 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitTypeDef, if any, with the given name.
     UnitTypeDefPtr getUnitTypeDef(const string& name) const
     {
-        return getChildOfType<UnitTypeDef>(name);
+        return getLayeredChildOfType<UnitTypeDef>(name);
     }
 
-    /// Return a vector of all UnitTypeDef elements in the document.
+    /// Return a vector of all UnitTypeDef elements in the document
+    /// and its data library.
     vector<UnitTypeDefPtr> getUnitTypeDefs() const
     {
-        return getChildrenOfType<UnitTypeDef>();
+        return getLayeredChildrenOfType<UnitTypeDef>();
     }
 
     /// Remove the UnitTypeDef, if any, with the given name.
@@ -677,9 +816,49 @@ class MX_CORE_API Document : public GraphElement
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    friend class Element;
+
+    // Return the child element, if any, with the given name and type,
+    // falling back to the data library if no local child is found.
+    template <class T> shared_ptr<T> getLayeredChildOfType(const string& name) const
+    {
+        shared_ptr<T> child = getChildOfType<T>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getChildOfType<T>(name);
+    }
+
+    // Return all child elements of the given type, followed by those of the
+    // data library that are not overridden by a local child of the same name.
+    template <class T> vector<shared_ptr<T>> getLayeredChildrenOfType() const
+    {
+        vector<shared_ptr<T>> children = getChildrenOfType<T>();
+        if (_dataLibrary)
+        {
+            for (shared_ptr<T> child : _dataLibrary->getChildrenOfType<T>())
+            {
+                if (!getChild(child->getName()))
+                {
+                    children.push_back(child);
+                }
+            }
+        }
+        return children;
+    }
+
+    // Update cached data incrementally for changes to the given element.
+    // Added children are passed after registration, and removed children
+    // before unregistration.  Attribute changes are passed before and after
+    // the change, where an empty attribute name stands for all attributes.
+    void onAddChild(ElementPtr child);
+    void onRemoveChild(ElementPtr child);
+    void onChangingAttribute(ElementPtr elem, const string& attrib);
+    void onChangedAttribute(ElementPtr elem, const string& attrib);
+    void onRename(ElementPtr elem, const string& name);
+
   private:
     class Cache;
     std::unique_ptr<Cache> _cache;
+    ConstDocumentPtr _dataLibrary;
 };
 
 /// Create a new Document.
@@ -9,6 +9,8 @@
 #include <MaterialXCore/Util.h>
 
 #include <iterator>
+#include <mutex>
+#include <shared_mutex>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -42,6 +44,115 @@ const string ValueElement::UNIFORM_ATTRIBUTE = "uniform";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace
+{
+
+// A process-wide pool of interned strings.
+class StringPool
+{
+  public:
+    StringPool()
+    {
+        // Attribute names are interned as the library's own constants, so
+        // that lookups using these constants are matched by address.  Where
+        // constants share a name, the first listed is the interned one.  The
+        // pool is first used once elements are created, after all constants
+        // have been initialized.
+        for (const string* str : { &Element::NAME_ATTRIBUTE, &TypedElement::TYPE_ATTRIBUTE,
+                                   &ValueElement::VALUE_ATTRIBUTE, &PortElement::NODE_NAME_ATTRIBUTE,
+                                   &PortElement::NODE_GRAPH_ATTRIBUTE, &PortElement::OUTPUT_ATTRIBUTE,
+                                   &InterfaceElement::NODE_DEF_ATTRIBUTE, &NodeDef::NODE_ATTRIBUTE,
+                                   &InterfaceElement::TARGET_ATTRIBUTE, &InterfaceElement::VERSION_ATTRIBUTE,
+                                   &InterfaceElement::DEFAULT_VERSION_ATTRIBUTE, &ValueElement::INTERFACE_NAME_ATTRIBUTE,
+                                   &ValueElement::UNIFORM_ATTRIBUTE, &Element::FILE_PREFIX_ATTRIBUTE,
+                                   &Element::GEOM_PREFIX_ATTRIBUTE, &Element::COLOR_SPACE_ATTRIBUTE,
+                                   &Element::INHERIT_ATTRIBUTE, &Element::NAMESPACE_ATTRIBUTE,
+                                   &Element::DOC_ATTRIBUTE, &Element::XPOS_ATTRIBUTE, &Element::YPOS_ATTRIBUTE,
+                                   &ValueElement::ENUM_ATTRIBUTE, &ValueElement::IMPLEMENTATION_NAME_ATTRIBUTE,
+                                   &ValueElement::IMPLEMENTATION_TYPE_ATTRIBUTE, &ValueElement::ENUM_VALUES_ATTRIBUTE,
+                                   &ValueElement::UI_NAME_ATTRIBUTE, &ValueElement::UI_FOLDER_ATTRIBUTE,
+                                   &ValueElement::UI_MIN_ATTRIBUTE, &ValueElement::UI_MAX_ATTRIBUTE,
+                                   &ValueElement::UI_SOFT_MIN_ATTRIBUTE, &ValueElement::UI_SOFT_MAX_ATTRIBUTE,
+                                   &ValueElement::UI_STEP_ATTRIBUTE, &ValueElement::UI_ADVANCED_ATTRIBUTE,
+                                   &ValueElement::UNIT_ATTRIBUTE, &ValueElement::UNITTYPE_ATTRIBUTE,
+                                   &Input::DEFAULT_GEOM_PROP_ATTRIBUTE, &Output::DEFAULT_INPUT_ATTRIBUTE,
+                                   &NodeDef::NODE_GROUP_ATTRIBUTE, &TypeDef::SEMANTIC_ATTRIBUTE,
+                                   &TypeDef::CONTEXT_ATTRIBUTE, &Implementation::FILE_ATTRIBUTE,
+                                   &Implementation::FUNCTION_ATTRIBUTE, &Implementation::NODE_GRAPH_ATTRIBUTE,
+                                   &UnitDef::UNITTYPE_ATTRIBUTE, &AttributeDef::ATTRNAME_ATTRIBUTE,
+                                   &AttributeDef::VALUE_ATTRIBUTE, &AttributeDef::ELEMENTS_ATTRIBUTE,
+                                   &AttributeDef::EXPORTABLE_ATTRIBUTE, &Document::CMS_ATTRIBUTE,
+                                   &Document::CMS_CONFIG_ATTRIBUTE, &GeomElement::GEOM_ATTRIBUTE,
+                                   &GeomElement::COLLECTION_ATTRIBUTE, &GeomPropDef::GEOM_PROP_ATTRIBUTE,
+                                   &GeomPropDef::SPACE_ATTRIBUTE, &GeomPropDef::INDEX_ATTRIBUTE,
+                                   &Collection::INCLUDE_GEOM_ATTRIBUTE, &Collection::EXCLUDE_GEOM_ATTRIBUTE,
+                                   &Collection::INCLUDE_COLLECTION_ATTRIBUTE, &MaterialAssign::MATERIAL_ATTRIBUTE,
+                                   &MaterialAssign::EXCLUSIVE_ATTRIBUTE, &Visibility::VIEWER_GEOM_ATTRIBUTE,
+                                   &Visibility::VIEWER_COLLECTION_ATTRIBUTE, &Visibility::VISIBILITY_TYPE_ATTRIBUTE,
+                                   &Visibility::VISIBLE_ATTRIBUTE, &LookGroup::LOOKS_ATTRIBUTE,
+                                   &LookGroup::ACTIVE_ATTRIBUTE, &Backdrop::CONTAINS_ATTRIBUTE,
+                                   &Backdrop::WIDTH_ATTRIBUTE, &Backdrop::HEIGHT_ATTRIBUTE,
+                                   &PropertyAssign::PROPERTY_ATTRIBUTE, &PropertyAssign::GEOM_ATTRIBUTE,
+                                   &PropertyAssign::COLLECTION_ATTRIBUTE, &PropertySetAssign::PROPERTY_SET_ATTRIBUTE,
+                                   &VariantAssign::VARIANT_SET_ATTRIBUTE, &VariantAssign::VARIANT_ATTRIBUTE })
+        {
+            _strings.emplace(*str, str);
+        }
+    }
+
+    const string& intern(const string& str)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            auto it = _strings.find(str);
+            if (it != _strings.end())
+            {
+                return *it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        auto it = _strings.emplace(str, nullptr).first;
+        if (!it->second)
+        {
+            it->second = &it->first;
+        }
+        return *it->second;
+    }
+
+    const string* find(const string& str)
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _strings.find(str);
+        return it != _strings.end() ? it->second : nullptr;
+    }
+
+  private:
+    std::unordered_map<string, const string*> _strings;
+    std::shared_mutex _mutex;
+};
+
+StringPool& getStringPool()
+{
+    static StringPool pool;
+    return pool;
+}
+
+// A shared sentinel, cached by value elements whose value string fails to
+// parse.
+const ConstValuePtr& getInvalidValue()
+{
+    static const ConstValuePtr invalidValue = Value::createValue(string());
+    return invalidValue;
+}
+
+} // anonymous namespace
+
+const string& internString(const string& str)
+{
+    return getStringPool().intern(str);
+}
+
 //
 // Element methods
 //
@@ -55,13 +166,8 @@ bool Element::operator==(const Element& rhs) const
     }
 
     // Compare attributes.
-    if (getAttributeNames() != rhs.getAttributeNames())
+    if (_attributes != rhs._attributes)
         return false;
-    for (const string& attr : rhs.getAttributeNames())
-    {
-        if (getAttribute(attr) != rhs.getAttribute(attr))
-            return false;
-    }
 
     // Compare children.
     const vector<ElementPtr>& c1 = getChildren();
@@ -89,7 +195,7 @@ void Element::setName(const string& name)
         throw Exception("Element name is not unique at the given scope: " + name);
     }
 
-    getDocument()->invalidateCache();
+    getDocument()->onRename(getSelf(), name);
 
     if (parent)
     {
@@ -135,15 +241,15 @@ ElementPtr Element::getDescendant(const string& namePath) const
 
 void Element::registerChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
-
     _childMap[child->getName()] = child;
     _childOrder.push_back(child);
+
+    getDocument()->onAddChild(child);
 }
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    getDocument()->onRemoveChild(child);
 
     _childMap.erase(child->getName());
     _childOrder.erase(
@@ -175,6 +281,8 @@ void Element::setChildIndex(const string& name, int index)
         throw Exception("Invalid child index");
     }
 
+    getDocument()->invalidateCache();
+
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
 }
@@ -192,25 +300,84 @@ void Element::removeChild(const string& name)
 
 void Element::setAttribute(const string& attrib, const string& value)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getDocument();
+    doc->onChangingAttribute(getSelf(), attrib);
 
-    if (!_attributeMap.count(attrib))
+    const Attribute* attr = findAttribute(attrib);
+    const string* name = attr ? attr->first : &internString(attrib);
+    if (attr)
+    {
+        _attributes[attr - _attributes.data()].second = value;
+    }
+    else
     {
-        _attributeOrder.push_back(attrib);
+        _attributes.emplace_back(name, value);
+        if (_attributeIndex)
+        {
+            _attributeIndex->emplace(name, _attributes.size() - 1);
+        }
+        else if (_attributes.size() > ATTRIBUTE_INDEX_THRESHOLD)
+        {
+            updateAttributeIndex();
+        }
     }
-    _attributeMap[attrib] = value;
+    onAttributeChanged(*name);
+
+    doc->onChangedAttribute(getSelf(), attrib);
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    const Attribute* attr = findAttribute(attrib);
+    if (attr)
     {
-        getDocument()->invalidateCache();
+        DocumentPtr doc = getDocument();
+        doc->onChangingAttribute(getSelf(), attrib);
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        const string& name = *attr->first;
+        _attributes.erase(_attributes.begin() + (attr - _attributes.data()));
+        if (_attributeIndex)
+        {
+            updateAttributeIndex();
+        }
+        onAttributeChanged(name);
+
+        doc->onChangedAttribute(getSelf(), attrib);
+    }
+}
+
+const Element::Attribute* Element::findIndexedAttribute(const string& attrib) const
+{
+    auto it = _attributeIndex->find(&attrib);
+    if (it == _attributeIndex->end())
+    {
+        const string* name = getStringPool().find(attrib);
+        if (!name)
+        {
+            return nullptr;
+        }
+        it = _attributeIndex->find(name);
+        if (it == _attributeIndex->end())
+        {
+            return nullptr;
+        }
+    }
+    return &_attributes[it->second];
+}
+
+void Element::updateAttributeIndex()
+{
+    if (_attributes.size() <= ATTRIBUTE_INDEX_THRESHOLD)
+    {
+        _attributeIndex.reset();
+        return;
+    }
+
+    _attributeIndex = std::make_unique<std::unordered_map<const string*, size_t>>();
+    _attributeIndex->reserve(_attributes.size());
+    for (size_t i = 0; i < _attributes.size(); i++)
+    {
+        _attributeIndex->emplace(_attributes[i].first, i);
     }
 }
 
@@ -361,11 +528,15 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getDocument();
+    doc->onChangingAttribute(getSelf(), EMPTY_STRING);
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributes = source->_attributes;
+    updateAttributeIndex();
+    onAttributeChanged(EMPTY_STRING);
+
+    doc->onChangedAttribute(getSelf(), EMPTY_STRING);
 
     for (auto child : source->getChildren())
     {
@@ -389,12 +560,19 @@ void Element::clearContent()
     getDocument()->invalidateCache();
 
     _sourceUri.clear();
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributes.clear();
+    _attributeIndex.reset();
+    onAttributeChanged(EMPTY_STRING);
     _childMap.clear();
     _childOrder.clear();
 }
 
+ConstElementPtr Element::getDataLibraryRoot() const
+{
+    ConstDocumentPtr doc = getRoot()->asA<Document>();
+    return doc ? doc->getDataLibrary() : nullptr;
+}
+
 bool Element::validate(string* message) const
 {
     bool res = true;
@@ -449,9 +627,9 @@ string Element::asString() const
     {
         res += " name=\"" + getName() + "\"";
     }
-    for (const string& attrName : getAttributeNames())
+    for (const Attribute& attr : _attributes)
     {
-        res += " " + attrName + "=\"" + getAttribute(attrName) + "\"";
+        res += " " + *attr.first + "=\"" + attr.second + "\"";
     }
     res += ">";
     return res;
@@ -495,7 +673,26 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
     return resolver->resolve(getValueString(), getType());
 }
 
-ValuePtr ValueElement::getDefaultValue() const
+ConstValuePtr ValueElement::getValue() const
+{
+    ConstValuePtr value = std::atomic_load(&_cachedValue);
+    if (value)
+    {
+        return value != getInvalidValue() ? value : ConstValuePtr();
+    }
+    if (!hasValue())
+    {
+        return ConstValuePtr();
+    }
+
+    // Failed parses are cached as well, so that invalid values are not
+    // parsed again on each call.
+    value = Value::createValueFromStrings(getValueString(), getType());
+    std::atomic_store(&_cachedValue, value ? value : getInvalidValue());
+    return value;
+}
+
+ConstValuePtr ValueElement::getDefaultValue() const
 {
     ConstElementPtr parent = getParent();
     ConstInterfaceElementPtr interface = parent ? parent->asA<InterfaceElement>() : nullptr;
@@ -511,7 +708,7 @@ ValuePtr ValueElement::getDefaultValue() const
             }
         }
     }
-    return ValuePtr();
+    return ConstValuePtr();
 }
 
 const string& ValueElement::getActiveUnit() const
@@ -534,6 +731,14 @@ const string& ValueElement::getActiveUnit() const
     return EMPTY_STRING;
 }
 
+void ValueElement::onAttributeChanged(const string& attrib)
+{
+    if (attrib.empty() || &attrib == &VALUE_ATTRIBUTE || &attrib == &TYPE_ATTRIBUTE)
+    {
+        std::atomic_store(&_cachedValue, ConstValuePtr());
+    }
+}
+
 bool ValueElement::validate(string* message) const
 {
     bool res = true;
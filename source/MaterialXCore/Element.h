@@ -71,6 +71,13 @@ using ElementMap = std::unordered_map<string, ElementPtr>;
 /// A standard function taking an ElementPtr and returning a boolean.
 using ElementPredicate = std::function<bool(ConstElementPtr)>;
 
+/// Return the interned copy of the given string from a process-wide string
+/// pool.  Interned strings are never released, so the returned reference
+/// remains valid for the lifetime of the process, and two interned strings
+/// are equal if and only if their addresses are equal.  Element categories
+/// and attribute names are stored as interned strings.
+MX_CORE_API const string& internString(const string& str);
+
 /// @class Element
 /// The base class for MaterialX elements.
 ///
@@ -80,7 +87,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
 {
   protected:
     Element(ElementPtr parent, const string& category, const string& name) :
-        _category(category),
+        _category(&internString(category)),
         _name(name),
         _parent(parent),
         _root(parent ? parent->getRoot() : nullptr)
@@ -113,7 +120,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Set the element's category string.
     void setCategory(const string& category)
     {
-        _category = category;
+        _category = &internString(category);
     }
 
     /// Return the element's category string.  The category of a MaterialX
@@ -121,7 +128,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// being "material", "nodegraph", and "image".
     const string& getCategory() const
     {
-        return _category;
+        return *_category;
     }
 
     /// @}
@@ -496,21 +503,46 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != nullptr;
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        return (it != _attributeMap.end()) ? it->second : EMPTY_STRING;
+        const Attribute* attr = findAttribute(attrib);
+        return attr ? attr->second : EMPTY_STRING;
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
-    const StringVec& getAttributeNames() const
+    /// The vector is built on each call; callers visiting every attribute
+    /// should prefer forEachAttribute.
+    StringVec getAttributeNames() const
+    {
+        StringVec names;
+        names.reserve(_attributes.size());
+        for (const Attribute& attr : _attributes)
+        {
+            names.push_back(*attr.first);
+        }
+        return names;
+    }
+
+    /// Return the number of stored attributes.
+    size_t getAttributeCount() const
     {
-        return _attributeOrder;
+        return _attributes.size();
+    }
+
+    /// Call the given function with the name and value string of each stored
+    /// attribute, in the order they were set.  The function must not modify
+    /// the attributes of this element.
+    template <class F> void forEachAttribute(F func) const
+    {
+        for (const Attribute& attr : _attributes)
+        {
+            func(*attr.first, attr.second);
+        }
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -787,14 +819,32 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
   protected:
     // Resolve a reference to a named element at the scope of the given parent,
     // taking the namespace at the scope of this element into account.  If no parent
-    // is provided, then the root scope of the document is used.
+    // is provided, then the root scope of the document is used, followed by the
+    // root scope of its data library, if any.
     template <class T> shared_ptr<T> resolveNameReference(const string& name, ConstElementPtr parent = nullptr) const
     {
         ConstElementPtr scope = parent ? parent : getRoot();
         shared_ptr<T> child = scope->getChildOfType<T>(getQualifiedName(name));
-        return child ? child : scope->getChildOfType<T>(name);
+        if (!child)
+        {
+            child = scope->getChildOfType<T>(name);
+        }
+        if (!child && !parent)
+        {
+            ConstElementPtr library = getDataLibraryRoot();
+            if (library)
+            {
+                child = library->getChildOfType<T>(getQualifiedName(name));
+                return child ? child : library->getChildOfType<T>(name);
+            }
+        }
+        return child;
     }
 
+    // Return the root scope of the data library referenced by the document
+    // of this element, if any.
+    ConstElementPtr getDataLibraryRoot() const;
+
     // Enforce a requirement within a validate method, updating the validation
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, const string& errorDesc) const;
@@ -814,6 +864,11 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Called after the given attribute has been set or removed.  The name is
+    // passed as its interned string, and is empty when all attributes of the
+    // element may have changed.
+    virtual void onAttributeChanged(const string&) { }
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -821,16 +876,54 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
         return std::const_pointer_cast<Element>(shared_from_this());
     }
 
+  private:
+    // An attribute value, paired with its interned attribute name.
+    using Attribute = std::pair<const string*, string>;
+
+    // Elements with more attributes than this threshold maintain a hashed
+    // index alongside their ordered attribute vector.
+    static const size_t ATTRIBUTE_INDEX_THRESHOLD = 16;
+
+    // Return the given attribute, if present.  Callers passing an interned
+    // name are matched by address alone.
+    const Attribute* findAttribute(const string& attrib) const
+    {
+        if (_attributeIndex)
+        {
+            return findIndexedAttribute(attrib);
+        }
+        for (const Attribute& attr : _attributes)
+        {
+            if (attr.first == &attrib)
+            {
+                return &attr;
+            }
+        }
+        for (const Attribute& attr : _attributes)
+        {
+            if (*attr.first == attrib)
+            {
+                return &attr;
+            }
+        }
+        return nullptr;
+    }
+
+    const Attribute* findIndexedAttribute(const string& attrib) const;
+    void updateAttributeIndex();
+
   protected:
-    string _category;
+    const string* _category;
     string _name;
     string _sourceUri;
 
     ElementMap _childMap;
     vector<ElementPtr> _childOrder;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    // Attributes in the order they were set, with an optional index
+    // by interned name for elements with many attributes.
+    vector<Attribute> _attributes;
+    std::unique_ptr<std::unordered_map<const string*, size_t>> _attributeIndex;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
@@ -1023,14 +1116,14 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Return the typed value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
+    /// The value is parsed on first access and cached until the value or type
+    /// of the element is next modified, so repeated calls return the same
+    /// immutable value object.  Callers that need to modify the value should
+    /// call Value::copy on the result.
+    ///
     /// @return A shared pointer to the typed value of this element, or an
-    ///    empty shared pointer if no value is present.
-    ValuePtr getValue() const
-    {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getValueString(), getType());
-    }
+    ///    empty shared pointer if no valid value is present.
+    ConstValuePtr getValue() const;
 
     /// Return the resolved value of an element as a generic value object, which
     /// may be queried to access its data.
@@ -1052,7 +1145,7 @@ class MX_CORE_API ValueElement : public TypedElement
     ///
     /// @return A shared pointer to a typed value, or an empty shared pointer if
     ///    no default value was found.
-    ValuePtr getDefaultValue() const;
+    ConstValuePtr getDefaultValue() const;
 
     /// @}
     /// @name Units
@@ -1124,6 +1217,12 @@ class MX_CORE_API ValueElement : public TypedElement
 
     /// @}
 
+  protected:
+    void onAttributeChanged(const string& attrib) override;
+
+  private:
+    mutable ConstValuePtr _cachedValue;
+
   public:
     static const string VALUE_ATTRIBUTE;
     static const string INTERFACE_NAME_ATTRIBUTE;
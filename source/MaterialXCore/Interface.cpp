@@ -461,7 +461,7 @@ vector<ValueElementPtr> InterfaceElement::getActiveValueElements() const
     return activeValueElems;
 }
 
-ValuePtr InterfaceElement::getInputValue(const string& name, const string& target) const
+ConstValuePtr InterfaceElement::getInputValue(const string& name, const string& target) const
 {
     InputPtr input = getInput(name);
     if (input)
@@ -480,7 +480,7 @@ ValuePtr InterfaceElement::getInputValue(const string& name, const string& targe
         }
     }
 
-    return ValuePtr();
+    return ConstValuePtr();
 }
 
 void InterfaceElement::setVersionIntegers(int majorVersion, int minorVersion)
@@ -504,7 +504,7 @@ class MX_CORE_API InterfaceElement : public TypedElement
     /// @return If the given input is found in this interface or its
     ///    declaration, then a shared pointer to its value is returned;
     ///    otherwise, an empty shared pointer is returned.
-    ValuePtr getInputValue(const string& name, const string& target = EMPTY_STRING) const;
+    ConstValuePtr getInputValue(const string& name, const string& target = EMPTY_STRING) const;
 
     /// Set the string value of a Token by its name, creating a child element
     /// to hold the Token if needed.
@@ -98,33 +98,33 @@ NodeDefPtr Node::getNodeDef(const string& target, bool allowRoughMatch) const
     {
         return resolveNameReference<NodeDef>(getNodeDefString());
     }
-    vector<NodeDefPtr> nodeDefs = getDocument()->getMatchingNodeDefs(getQualifiedName(getCategory()));
-    vector<NodeDefPtr> secondary = getDocument()->getMatchingNodeDefs(getCategory());
-    vector<NodeDefPtr> roughMatches;
-    nodeDefs.insert(nodeDefs.end(), secondary.begin(), secondary.end());
-    for (NodeDefPtr nodeDef : nodeDefs)
-    {
-        if (!targetStringsMatch(nodeDef->getTarget(), target) ||
-            !nodeDef->isVersionCompatible(getVersionString()) ||
-            nodeDef->getType() != getType())
+    ConstDocumentPtr doc = getDocument();
+    ElementSpan<NodeDef> nodeDefs = doc->getMatchingNodeDefs(getQualifiedName(getCategory()));
+    ElementSpan<NodeDef> secondary = doc->getMatchingNodeDefs(getCategory());
+    const vector<NodeDefPtr>* nodeDefLists[] = { &nodeDefs.getVector(), &secondary.getVector() };
+    NodeDefPtr roughMatch;
+    for (const vector<NodeDefPtr>* candidates : nodeDefLists)
+    {
+        for (const NodeDefPtr& nodeDef : *candidates)
         {
-            continue;
-        }
-        if (!hasExactInputMatch(nodeDef))
-        {
-            if (allowRoughMatch)
+            if (!targetStringsMatch(nodeDef->getTarget(), target) ||
+                !nodeDef->isVersionCompatible(getVersionString()) ||
+                nodeDef->getType() != getType())
             {
-                roughMatches.push_back(nodeDef);
+                continue;
             }
-            continue;
+            if (!hasExactInputMatch(nodeDef))
+            {
+                if (allowRoughMatch && !roughMatch)
+                {
+                    roughMatch = nodeDef;
+                }
+                continue;
+            }
+            return nodeDef;
         }
-        return nodeDef;
-    }
-    if (!roughMatches.empty())
-    {
-        return roughMatches[0];
     }
-    return NodeDefPtr();
+    return roughMatch;
 }
 
 Edge Node::getUpstreamEdge(size_t index) const
@@ -209,10 +209,10 @@ class MX_CORE_API PropertySet : public Element
     /// @param name The name of the property to be evaluated.
     /// @return If the given property is found, then a shared pointer to its
     ///    value is returned; otherwise, an empty shared pointer is returned.
-    ValuePtr getPropertyValue(const string& name) const
+    ConstValuePtr getPropertyValue(const string& name) const
     {
         PropertyPtr property = getProperty(name);
-        return property ? property->getValue() : ValuePtr();
+        return property ? property->getValue() : ConstValuePtr();
     }
 
     /// @}
@@ -262,7 +262,7 @@ bool UnitConverterRegistry::convertToUnit(DocumentPtr doc, const string& unitTyp
         for (InputPtr input : pNode->getInputs())
         {
             const std::string type = input->getType();
-            const ValuePtr value = input->getValue();
+            ConstValuePtr value = input->getValue();
             if (value && input->hasUnit() && (input->getUnitType() == unitType))
             {
                 if (type == getTypeString<float>())
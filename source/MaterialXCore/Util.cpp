@@ -156,6 +156,19 @@ string trimSpaces(const string& str)
     return result;
 }
 
+uint64_t hashString(const string& str, uint64_t seed)
+{
+    const uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    uint64_t hash = seed;
+    for (unsigned char c : str)
+    {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
 StringVec splitNamePath(const string& namePath)
 {
     StringVec nameVec = splitString(namePath, NAME_PATH_SEPARATOR);
@@ -60,6 +60,12 @@ template <typename T> void hashCombine(size_t& seed, const T& value)
     seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+/// Return a 64-bit FNV-1a hash of the given string.  Unlike std::hash, the
+/// result is stable across platforms and sessions, so it may be used to key
+/// persistent data.  Hashes of several strings may be chained by passing the
+/// previous result as the seed.
+MX_CORE_API uint64_t hashString(const string& str, uint64_t seed = 0xcbf29ce484222325ull);
+
 /// Split a name path into string vector
 MX_CORE_API StringVec splitNamePath(const string& namePath);
 
@@ -4,9 +4,11 @@
 //
 
 #include <MaterialXCore/Value.h>
+#include <MaterialXCore/ValueStream.inl>
 
-#include <iomanip>
-#include <sstream>
+#include <cctype>
+#include <charconv>
+#include <string_view>
 #include <type_traits>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -18,6 +20,9 @@ int Value::_floatPrecision = 6;
 namespace
 {
 
+// The innermost float formatting scope on the current thread, if any.
+thread_local ScopedFloatFormatting* currentFloatFormatting = nullptr;
+
 template <class T> using enable_if_mx_vector_t =
     typename std::enable_if<std::is_base_of<VectorBase, T>::value, T>::type;
 template <class T> using enable_if_mx_matrix_t =
@@ -28,24 +33,73 @@ template <class T> class is_std_vector<vector<T>> : public std::true_type { };
 template <class T> using enable_if_std_vector_t =
     typename std::enable_if<is_std_vector<T>::value, T>::type;
 
-template <class T> void stringToData(const string& str, T& data)
+// Call the given function with the bounds of each non-empty token in the
+// given string, splitting at any of the given separator characters.
+template <class F> void forEachToken(const string& str, const string& sep, F func)
 {
-    std::stringstream ss(str);
-    ss.imbue(std::locale::classic());
-    if (!(ss >> data))
+    string::size_type lastPos = str.find_first_not_of(sep, 0);
+    string::size_type pos = str.find_first_of(sep, lastPos);
+
+    while (pos != string::npos || lastPos != string::npos)
     {
-        throw ExceptionTypeError("Type mismatch in generic stringToData: " + str);
+        const char* begin = str.data() + lastPos;
+        func(begin, (pos != string::npos) ? str.data() + pos : str.data() + str.size());
+        lastPos = str.find_first_not_of(sep, pos);
+        pos = str.find_first_of(sep, lastPos);
     }
 }
 
-template <> void stringToData(const string& str, bool& data)
+// Parse a numeric token.  As with stream extraction, leading whitespace and
+// a leading plus sign are accepted, and trailing characters are ignored.
+template <class T> bool tokenToData(const char* begin, const char* end, T& data)
+{
+#if defined(__cpp_lib_to_chars)
+    while (begin != end && std::isspace((unsigned char) *begin))
+    {
+        begin++;
+    }
+    if (begin + 1 < end && *begin == '+' && begin[1] != '-')
+    {
+        begin++;
+    }
+    return std::from_chars(begin, end, data).ec == std::errc();
+#else
+    return streamToData(begin, end, data);
+#endif
+}
+
+template <> bool tokenToData(const char* begin, const char* end, bool& data)
 {
-    if (str == VALUE_STRING_TRUE)
+    std::string_view token(begin, end - begin);
+    if (token == VALUE_STRING_TRUE)
         data = true;
-    else if (str == VALUE_STRING_FALSE)
+    else if (token == VALUE_STRING_FALSE)
         data = false;
     else
+        return false;
+    return true;
+}
+
+template <> bool tokenToData(const char* begin, const char* end, string& data)
+{
+    data.assign(begin, end);
+    return true;
+}
+
+template <class T> void stringToData(const string& str, T& data)
+{
+    if (!tokenToData(str.data(), str.data() + str.size(), data))
+    {
+        throw ExceptionTypeError("Type mismatch in generic stringToData: " + str);
+    }
+}
+
+template <> void stringToData(const string& str, bool& data)
+{
+    if (!tokenToData(str.data(), str.data() + str.size(), data))
+    {
         throw ExceptionTypeError("Type mismatch in boolean stringToData: " + str);
+    }
 }
 
 template <> void stringToData(const string& str, string& data)
@@ -55,30 +109,37 @@ template <> void stringToData(const string& str, string& data)
 
 template <class T> void stringToData(const string& str, enable_if_mx_vector_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numElements())
+    size_t index = 0;
+    forEachToken(str, ARRAY_VALID_SEPARATORS, [&](const char* begin, const char* end)
     {
-        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
-    }
-    for (size_t i = 0; i < data.numElements(); i++)
+        if (index >= data.numElements() || !tokenToData(begin, end, data[index]))
+        {
+            throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
+        }
+        index++;
+    });
+    if (index != data.numElements())
     {
-        stringToData(tokens[i], data[i]);
+        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
     }
 }
 
 template <class T> void stringToData(const string& str, enable_if_mx_matrix_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numRows() * data.numColumns())
-    {
-        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
-    }
-    for (size_t i = 0; i < data.numRows(); i++)
+    size_t index = 0;
+    forEachToken(str, ARRAY_VALID_SEPARATORS, [&](const char* begin, const char* end)
     {
-        for (size_t j = 0; j < data.numColumns(); j++)
+        size_t i = index / data.numRows();
+        size_t j = index % data.numRows();
+        if (i >= data.numRows() || j >= data.numColumns() || !tokenToData(begin, end, data[i][j]))
         {
-            stringToData(tokens[i * data.numRows() + j], data[i][j]);
+            throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
         }
+        index++;
+    });
+    if (index != data.numRows() * data.numColumns())
+    {
+        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
     }
 }
 
@@ -87,48 +148,71 @@ template <class T> void stringToData(const string& str, enable_if_std_vector_t<T
     // This code path parses an array of arbitrary substrings, so we split the string
     // in a fashion that preserves substrings with internal spaces.
     const string COMMA_SEPARATOR = ",";
-    for (const string& token : splitString(str, COMMA_SEPARATOR))
+    forEachToken(str, COMMA_SEPARATOR, [&](const char* begin, const char* end)
     {
+        while (begin != end && *begin == ' ')
+        {
+            begin++;
+        }
+        while (begin != end && end[-1] == ' ')
+        {
+            end--;
+        }
         typename T::value_type val;
-        stringToData(trimSpaces(token), val);
+        if (!tokenToData(begin, end, val))
+        {
+            throw ExceptionTypeError("Type mismatch in generic stringToData: " + string(begin, end));
+        }
         data.push_back(val);
-    }
+    });
 }
 
+// Append the value string of the given data to the given string.
 template <class T> void dataToString(const T& data, string& str)
 {
-    std::stringstream ss;
-    ss.imbue(std::locale::classic());
-
-    // Set float format and precision for the stream
-    const Value::FloatFormat fmt = Value::getFloatFormat();
-    ss.setf(std::ios_base::fmtflags(
-            (fmt == Value::FloatFormatFixed ? std::ios_base::fixed :
-            (fmt == Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
-        std::ios_base::floatfield);
-    ss.precision(Value::getFloatPrecision());
-
-    ss << data;
-    str = ss.str();
+#if defined(__cpp_lib_to_chars)
+    char buffer[128];
+    std::to_chars_result result;
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        const Value::FloatFormat fmt = Value::getFloatFormat();
+        result = std::to_chars(buffer, buffer + sizeof(buffer), data,
+                               fmt == Value::FloatFormatFixed ? std::chars_format::fixed :
+                               (fmt == Value::FloatFormatScientific ? std::chars_format::scientific :
+                               std::chars_format::general),
+                               Value::getFloatPrecision());
+    }
+    else
+    {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), data);
+    }
+
+    if (result.ec == std::errc())
+    {
+        str.append(buffer, result.ptr);
+        return;
+    }
+#endif
+
+    // Fall back to stream formatting for values that exceed the buffer.
+    dataToStream(data, str);
 }
 
 template <> void dataToString(const bool& data, string& str)
 {
-    str = data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
+    str += data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
 }
 
 template <> void dataToString(const string& data, string& str)
 {
-    str = data;
+    str += data;
 }
 
 template <class T> void dataToString(const enable_if_mx_vector_t<T>& data, string& str)
 {
     for (size_t i = 0; i < data.numElements(); i++)
     {
-        string token;
-        dataToString(data[i], token);
-        str += token;
+        dataToString(data[i], str);
         if (i + 1 < data.numElements())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -142,9 +226,7 @@ template <class T> void dataToString(const enable_if_mx_matrix_t<T>& data, strin
     {
         for (size_t j = 0; j < data.numColumns(); j++)
         {
-            string token;
-            dataToString(data[i][j], token);
-            str += token;
+            dataToString(data[i][j], str);
             if (i + 1 < data.numRows() ||
                 j + 1 < data.numColumns())
             {
@@ -158,9 +240,7 @@ template <class T> void dataToString(const enable_if_std_vector_t<T>& data, stri
 {
     for (size_t i = 0; i < data.size(); i++)
     {
-        string token;
-        dataToString<typename T::value_type>(data[i], token);
-        str += token;
+        dataToString<typename T::value_type>(data[i], str);
         if (i + 1 < data.size())
         {
             str += ARRAY_PREFERRED_SEPARATOR;
@@ -237,21 +317,51 @@ template <class T> const T& Value::asA() const
     return typedVal->getData();
 }
 
-ScopedFloatFormatting::ScopedFloatFormatting(Value::FloatFormat format, int precision) :
-    _format(Value::getFloatFormat()),
-    _precision(Value::getFloatPrecision())
+void Value::setFloatFormat(FloatFormat format)
 {
-    Value::setFloatFormat(format);
-    if (precision >= 0)
+    if (currentFloatFormatting)
     {
-        Value::setFloatPrecision(precision);
+        currentFloatFormatting->_format = format;
     }
+    else
+    {
+        _floatFormat = format;
+    }
+}
+
+void Value::setFloatPrecision(int precision)
+{
+    if (currentFloatFormatting)
+    {
+        currentFloatFormatting->_precision = precision;
+    }
+    else
+    {
+        _floatPrecision = precision;
+    }
+}
+
+Value::FloatFormat Value::getFloatFormat()
+{
+    return currentFloatFormatting ? currentFloatFormatting->_format : _floatFormat;
+}
+
+int Value::getFloatPrecision()
+{
+    return currentFloatFormatting ? currentFloatFormatting->_precision : _floatPrecision;
+}
+
+ScopedFloatFormatting::ScopedFloatFormatting(Value::FloatFormat format, int precision) :
+    _format(format),
+    _precision(precision >= 0 ? precision : Value::getFloatPrecision()),
+    _parent(currentFloatFormatting)
+{
+    currentFloatFormatting = this;
 }
 
 ScopedFloatFormatting::~ScopedFloatFormatting()
 {
-    Value::setFloatFormat(_format);
-    Value::setFloatPrecision(_precision);
+    currentFloatFormatting = _parent;
 }
 
 //
@@ -98,28 +98,20 @@ class MX_CORE_API Value
     /// Set float formatting for converting values to strings.
     /// Formats to use are FloatFormatFixed, FloatFormatScientific
     /// or FloatFormatDefault to set default format.
-    static void setFloatFormat(FloatFormat format)
-    {
-        _floatFormat = format;
-    }
+    /// If a ScopedFloatFormatting is active on the calling thread, then
+    /// the format applies to that scope, and otherwise it applies to all
+    /// threads without an active scope.
+    static void setFloatFormat(FloatFormat format);
 
     /// Set float precision for converting values to strings.
-    static void setFloatPrecision(int precision)
-    {
-        _floatPrecision = precision;
-    }
+    /// The precision is scoped in the same way as the float format.
+    static void setFloatPrecision(int precision);
 
-    /// Return the current float format.
-    static FloatFormat getFloatFormat()
-    {
-        return _floatFormat;
-    }
+    /// Return the current float format for the calling thread.
+    static FloatFormat getFloatFormat();
 
-    /// Return the current float precision.
-    static int getFloatPrecision()
-    {
-        return _floatPrecision;
-    }
+    /// Return the current float precision for the calling thread.
+    static int getFloatPrecision();
 
   protected:
     template <class T> friend class ValueRegistry;
@@ -195,15 +187,23 @@ template <class T> class MX_CORE_API TypedValue : public Value
 
 /// @class ScopedFloatFormatting
 /// An RAII class for controlling the float formatting of values.
+/// The formatting applies only to the calling thread, so scopes on
+/// concurrent threads do not interfere with one another.
 class MX_CORE_API ScopedFloatFormatting
 {
   public:
     explicit ScopedFloatFormatting(Value::FloatFormat format, int precision = -1);
     ~ScopedFloatFormatting();
 
+    ScopedFloatFormatting(const ScopedFloatFormatting&) = delete;
+    ScopedFloatFormatting& operator=(const ScopedFloatFormatting&) = delete;
+
   private:
+    friend class Value;
+
     Value::FloatFormat _format;
     int _precision;
+    ScopedFloatFormatting* _parent;
 };
 
 /// Return the type string associated with the given data type.
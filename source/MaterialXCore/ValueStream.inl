@@ -0,0 +1,39 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXCore/Value.h>
+
+#include <sstream>
+
+MATERIALX_NAMESPACE_BEGIN
+
+// Parse a numeric token through a classic-locale string stream.  Value.cpp
+// uses this path where the standard library lacks floating-point support in
+// <charconv>.  Leading whitespace and a leading plus sign are accepted, and
+// trailing characters are ignored.
+template <class T> bool streamToData(const char* begin, const char* end, T& data)
+{
+    std::istringstream ss(string(begin, end));
+    ss.imbue(std::locale::classic());
+    return static_cast<bool>(ss >> data);
+}
+
+// Append the classic-locale stream formatting of the given number to the
+// given string, following the current float format and precision.
+template <class T> void dataToStream(const T& data, string& str)
+{
+    std::ostringstream ss;
+    ss.imbue(std::locale::classic());
+    const Value::FloatFormat fmt = Value::getFloatFormat();
+    ss.setf(std::ios_base::fmtflags(
+            (fmt == Value::FloatFormatFixed ? std::ios_base::fixed :
+            (fmt == Value::FloatFormatScientific ? std::ios_base::scientific : 0))),
+        std::ios_base::floatfield);
+    ss.precision(Value::getFloatPrecision());
+    ss << data;
+    str += ss.str();
+}
+
+MATERIALX_NAMESPACE_END
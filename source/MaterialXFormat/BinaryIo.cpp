@@ -0,0 +1,431 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <MaterialXFormat/Environ.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+MATERIALX_NAMESPACE_BEGIN
+
+const string MTLX_BINARY_EXTENSION = "mtlxb";
+
+namespace
+{
+
+const char SNAPSHOT_MAGIC[8] = { 'M', 'T', 'L', 'X', 'S', 'N', 'A', 'P' };
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+// The maximum depth of the element tree in a snapshot, which bounds the
+// recursion of the reader on corrupt input.
+const size_t MAX_TREE_DEPTH = 256;
+
+//
+// Reading
+//
+
+class SnapshotReader
+{
+  public:
+    SnapshotReader(const char* buffer, size_t size) :
+        _pos(buffer),
+        _end(buffer + size)
+    {
+    }
+
+    void readHeader()
+    {
+        if (remaining() < sizeof(SNAPSHOT_MAGIC) || std::memcmp(_pos, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)))
+        {
+            throw ExceptionParseError("Buffer is not a MaterialX binary snapshot");
+        }
+        _pos += sizeof(SNAPSHOT_MAGIC);
+        if (readUint() != SNAPSHOT_VERSION)
+        {
+            throw ExceptionParseError("Unsupported MaterialX binary snapshot version");
+        }
+        if (readUint() != SNAPSHOT_BYTE_ORDER)
+        {
+            throw ExceptionParseError("MaterialX binary snapshot was written with a different byte order");
+        }
+
+        // Read the string table.
+        uint32_t stringCount = readUint();
+        if (stringCount > remaining() / sizeof(uint32_t))
+        {
+            throw ExceptionParseError("Invalid string count in MaterialX binary snapshot");
+        }
+        _strings.reserve(stringCount);
+        for (uint32_t i = 0; i < stringCount; i++)
+        {
+            uint32_t length = readUint();
+            if (length > remaining())
+            {
+                throw ExceptionParseError("Unexpected end of MaterialX binary snapshot");
+            }
+            _strings.emplace_back(_pos, length);
+            _pos += length;
+        }
+    }
+
+    // Read an element record into the given element.  If no element is
+    // given, then the record and its descendants are skipped.
+    void readElement(ElementPtr elem, size_t depth = 0)
+    {
+        if (depth > MAX_TREE_DEPTH)
+        {
+            throw ExceptionParseError("Element tree of MaterialX binary snapshot exceeds the maximum depth");
+        }
+
+        const string& sourceUri = readString();
+        if (elem && !sourceUri.empty())
+        {
+            elem->setSourceUri(sourceUri);
+        }
+
+        uint32_t attributeCount = readUint();
+        for (uint32_t i = 0; i < attributeCount; i++)
+        {
+            const string& attrib = readString();
+            const string& value = readString();
+            if (elem)
+            {
+                elem->setAttribute(attrib, value);
+            }
+        }
+
+        uint32_t childCount = readUint();
+        for (uint32_t i = 0; i < childCount; i++)
+        {
+            const string& category = readString();
+            const string& name = readString();
+
+            // Check for duplicate elements.
+            ElementPtr child;
+            if (elem && !elem->getChild(name))
+            {
+                child = elem->addChildOfCategory(category, name);
+            }
+            readElement(child, depth + 1);
+        }
+    }
+
+    bool atEnd() const
+    {
+        return _pos == _end;
+    }
+
+  private:
+    size_t remaining() const
+    {
+        return (size_t) (_end - _pos);
+    }
+
+    uint32_t readUint()
+    {
+        if (remaining() < sizeof(uint32_t))
+        {
+            throw ExceptionParseError("Unexpected end of MaterialX binary snapshot");
+        }
+        uint32_t value;
+        std::memcpy(&value, _pos, sizeof(uint32_t));
+        _pos += sizeof(uint32_t);
+        return value;
+    }
+
+    const string& readString()
+    {
+        uint32_t index = readUint();
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Invalid string index in MaterialX binary snapshot");
+        }
+        return _strings[index];
+    }
+
+  private:
+    const char* _pos;
+    const char* _end;
+    StringVec _strings;
+};
+
+// A read-only mapping of a file into memory.
+class MappedFile
+{
+  public:
+    explicit MappedFile(const FilePath& filename) :
+        _data(nullptr),
+        _size(0)
+    {
+#if defined(_WIN32)
+        _file = CreateFileA(filename.asString().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        _mapping = nullptr;
+        if (_file == INVALID_HANDLE_VALUE)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(_file, &size) && size.QuadPart > 0)
+        {
+            _size = (size_t) size.QuadPart;
+            _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping)
+            {
+                _data = (const char*) MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+            }
+        }
+#else
+        int fd = open(filename.asString().c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            _size = (size_t) fileStat.st_size;
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = (const char*) data;
+            }
+        }
+        close(fd);
+#endif
+        if (!_data)
+        {
+            release();
+            throw ExceptionParseError("Failed to map file into memory: " + filename.asString());
+        }
+    }
+
+    ~MappedFile()
+    {
+        release();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+  private:
+    void release()
+    {
+#if defined(_WIN32)
+        if (_data)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping)
+        {
+            CloseHandle(_mapping);
+        }
+        if (_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(_file);
+        }
+        _mapping = nullptr;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        if (_data)
+        {
+            munmap((void*) _data, _size);
+        }
+#endif
+        _data = nullptr;
+    }
+
+  private:
+    const char* _data;
+    size_t _size;
+#if defined(_WIN32)
+    HANDLE _file;
+    HANDLE _mapping;
+#endif
+};
+
+//
+// Writing
+//
+
+class SnapshotWriter
+{
+  public:
+    void writeElement(ConstElementPtr elem)
+    {
+        writeString(elem->getSourceUri());
+
+        writeUint((uint32_t) elem->getAttributeCount());
+        elem->forEachAttribute([this](const string& attrib, const string& value)
+        {
+            writeString(attrib);
+            writeString(value);
+        });
+
+        const vector<ElementPtr>& children = elem->getChildren();
+        writeUint((uint32_t) children.size());
+        for (const ElementPtr& child : children)
+        {
+            writeString(child->getCategory());
+            writeString(child->getName());
+            writeElement(child);
+        }
+    }
+
+    void write(std::ostream& stream) const
+    {
+        string header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        appendUint(header, SNAPSHOT_VERSION);
+        appendUint(header, SNAPSHOT_BYTE_ORDER);
+        appendUint(header, (uint32_t) _strings.size());
+        stream.write(header.data(), header.size());
+
+        string length;
+        for (const string* str : _strings)
+        {
+            length.clear();
+            appendUint(length, (uint32_t) str->size());
+            stream.write(length.data(), length.size());
+            stream.write(str->data(), str->size());
+        }
+        stream.write(_elements.data(), _elements.size());
+    }
+
+  private:
+    static void appendUint(string& buffer, uint32_t value)
+    {
+        buffer.append((const char*) &value, sizeof(uint32_t));
+    }
+
+    void writeUint(uint32_t value)
+    {
+        appendUint(_elements, value);
+    }
+
+    void writeString(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it == _stringIndices.end())
+        {
+            it = _stringIndices.emplace(str, (uint32_t) _strings.size()).first;
+            _strings.push_back(&it->first);
+        }
+        writeUint(it->second);
+    }
+
+  private:
+    std::unordered_map<string, uint32_t> _stringIndices;
+    vector<const string*> _strings;
+    string _elements;
+};
+
+} // anonymous namespace
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size)
+{
+    if (!buffer)
+    {
+        throw ExceptionParseError("Empty MaterialX binary snapshot buffer");
+    }
+
+    SnapshotReader reader(buffer, size);
+    reader.readHeader();
+    reader.readElement(doc);
+    if (!reader.atEnd())
+    {
+        throw ExceptionParseError("Unexpected data at end of MaterialX binary snapshot");
+    }
+
+    // As with XML documents, snapshots written by earlier versions of
+    // MaterialX are upgraded to the current version.
+    doc->upgradeVersion();
+}
+
+void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    MappedFile file(filename);
+    readFromBinaryBuffer(doc, file.data(), file.size());
+}
+
+void readFromBinaryString(DocumentPtr doc, const string& str)
+{
+    readFromBinaryBuffer(doc, str.data(), str.size());
+}
+
+//
+// Writing
+//
+
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream)
+{
+    SnapshotWriter writer;
+    writer.writeElement(doc);
+    writer.write(stream);
+    if (!stream)
+    {
+        throw Exception("Failed to write MaterialX binary snapshot to stream");
+    }
+}
+
+void writeToBinaryFile(DocumentPtr doc, const FilePath& filename)
+{
+    std::ofstream ofs(filename.asString(), std::ios::binary);
+    if (!ofs)
+    {
+        throw Exception("Failed to open file for writing: " + filename.asString());
+    }
+    try
+    {
+        writeToBinaryStream(doc, ofs);
+        ofs.close();
+        if (!ofs)
+        {
+            throw Exception("Failed to write MaterialX binary snapshot to stream");
+        }
+    }
+    catch (Exception&)
+    {
+        // Remove the truncated snapshot, so that it is not read later.
+        ofs.close();
+        std::remove(filename.asString().c_str());
+        throw Exception("Failed to write MaterialX binary snapshot: " + filename.asString());
+    }
+}
+
+string writeToBinaryString(DocumentPtr doc)
+{
+    std::ostringstream stream;
+    writeToBinaryStream(doc, stream);
+    return stream.str();
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,89 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for binary document snapshots
+
+#include <MaterialXCore/Library.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/Export.h>
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+extern MX_FORMAT_API const string MTLX_BINARY_EXTENSION;
+
+/// @name Read Functions
+/// @{
+
+/// Read a Document from the given binary snapshot buffer.
+///
+/// A binary snapshot stores the element tree of a document, including the
+/// attributes and source URI of each element, with all strings stored once
+/// in a shared table.  Snapshots are intended as a fast cache of documents
+/// that have already been read and upgraded, such as the data libraries, and
+/// are stored in the native byte order of the writing platform.  Documents
+/// from earlier versions of MaterialX are upgraded to the current version
+/// after reading.
+///
+/// @param doc The Document into which data is read.
+/// @param buffer The buffer from which data is read.
+/// @param size The size of the buffer in bytes.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+MX_FORMAT_API void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size);
+
+/// Read a Document from the given binary snapshot file.  The file is mapped
+/// into memory rather than copied while the document is constructed.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file.  This argument can be
+///    supplied either as a FileSearchPath, or as a standard string with paths
+///    separated by the PATH_SEPARATOR character.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+MX_FORMAT_API void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath = FileSearchPath());
+
+/// Read a Document from the given binary snapshot string.
+/// @param doc The Document into which data is read.
+/// @param str The string from which data is read.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+MX_FORMAT_API void readFromBinaryString(DocumentPtr doc, const string& str);
+
+/// @}
+/// @name Write Functions
+/// @{
+
+/// Write a Document as a binary snapshot to the given output stream.
+/// @param doc The Document to be written.
+/// @param stream The output stream to which data is written.
+/// @throws Exception if the stream reports a write error.
+MX_FORMAT_API void writeToBinaryStream(DocumentPtr doc, std::ostream& stream);
+
+/// Write a Document as a binary snapshot to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @throws Exception if the file cannot be written, in which case no
+///    partial snapshot is left in its place.
+MX_FORMAT_API void writeToBinaryFile(DocumentPtr doc, const FilePath& filename);
+
+/// Write a Document as a binary snapshot to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @return The output string, returned by value
+MX_FORMAT_API string writeToBinaryString(DocumentPtr doc);
+
+/// @}
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -5,9 +5,12 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <atomic>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -90,51 +93,96 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
     FileSearchPath librarySearchPath = searchPath;
     librarySearchPath.append(getEnvironmentPath());
 
+    // Gather library files in load order.
     StringSet loadedLibraries;
-    if (libraryFolders.empty())
+    FilePathVec libraryFiles;
+    auto addLibraryFiles = [&](const FilePath& libraryPath)
     {
-        // No libraries specified so scan in all search paths
-        for (const FilePath& libraryPath : librarySearchPath)
+        for (const FilePath& path : libraryPath.getSubDirectories())
         {
-            for (const FilePath& path : libraryPath.getSubDirectories())
+            for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
+                if (!excludeFiles.count(filename))
                 {
-                    if (!excludeFiles.count(filename))
+                    const FilePath& file = path / filename;
+                    if (loadedLibraries.count(file) == 0)
                     {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
+                        libraryFiles.push_back(file);
+                        loadedLibraries.insert(file.asString());
                     }
                 }
             }
         }
+    };
+    if (libraryFolders.empty())
+    {
+        // No libraries specified so scan in all search paths
+        for (const FilePath& libraryPath : librarySearchPath)
+        {
+            addLibraryFiles(libraryPath);
+        }
     }
     else
     {
         // Look for specific library folders in the search paths
         for (const FilePath& libraryName : libraryFolders)
         {
-            FilePath libraryPath = librarySearchPath.find(libraryName);
-            for (const FilePath& path : libraryPath.getSubDirectories())
+            addLibraryFiles(librarySearchPath.find(libraryName));
+        }
+    }
+
+    // Read library files concurrently into separate documents.
+    vector<DocumentPtr> libDocs(libraryFiles.size());
+    vector<std::exception_ptr> errors(libraryFiles.size());
+    std::atomic<size_t> nextFile(0);
+    auto read = [&]()
+    {
+        for (size_t i = nextFile++; i < libraryFiles.size(); i = nextFile++)
+        {
+            try
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
-                {
-                    if (!excludeFiles.count(filename))
-                    {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
-                    }
-                }
+                DocumentPtr libDoc = createDocument();
+                readFromXmlFile(libDoc, libraryFiles[i], searchPath, readOptions);
+                libDocs[i] = libDoc;
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
             }
         }
+    };
+    // A custom XInclude reader may not be thread-safe, so it is only
+    // called from the calling thread.
+    using ReadFileFunction = void (*)(DocumentPtr, FilePath, FileSearchPath, const XmlReadOptions*);
+    const ReadFileFunction* readXInclude = readOptions ? readOptions->readXIncludeFunction.target<ReadFileFunction>() : nullptr;
+    const bool customXIncludeReader = readOptions && readOptions->readXIncludeFunction &&
+                                      !(readXInclude && *readXInclude == readFromXmlFile);
+    unsigned int threadCount = (unsigned int) std::min<size_t>(std::thread::hardware_concurrency(), libraryFiles.size());
+    if (threadCount <= 1 || customXIncludeReader)
+    {
+        read();
+    }
+    else
+    {
+        vector<std::thread> threads;
+        for (unsigned int i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back(read);
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Libraries are imported in load order on the calling thread.
+    for (size_t i = 0; i < libraryFiles.size(); i++)
+    {
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
+        doc->importLibrary(libDocs[i]);
     }
     return loadedLibraries;
 }
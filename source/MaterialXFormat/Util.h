@@ -44,6 +44,10 @@ MX_FORMAT_API void loadLibrary(const FilePath& file,
 
 /// Load all MaterialX files within the given library folders into a document,
 /// using the given search path to locate the folders on the file system.
+/// Library files are read concurrently, and then imported in load order.
+/// If the given read options provide a readXIncludeFunction other than
+/// readFromXmlFile, then library files are read serially on the calling
+/// thread, since that function is not required to be thread-safe.
 MX_FORMAT_API StringSet loadLibraries(const FilePathVec& libraryFolders,
                                       const FileSearchPath& searchPath,
                                       DocumentPtr doc,
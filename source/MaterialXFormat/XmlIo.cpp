@@ -9,9 +9,12 @@
 
 #include <MaterialXCore/Types.h>
 
+#include <cctype>
 #include <cstring>
 #include <fstream>
+#include <iterator>
 #include <sstream>
+#include <string_view>
 
 using namespace pugi;
 
@@ -88,11 +91,11 @@ void elementToXml(ConstElementPtr elem, xml_node& xmlNode, const XmlWriteOptions
     {
         xmlNode.append_attribute(Element::NAME_ATTRIBUTE.c_str()) = elem->getName().c_str();
     }
-    for (const string& attrName : elem->getAttributeNames())
+    elem->forEachAttribute([&xmlNode](const string& attrName, const string& attrValue)
     {
         xml_attribute xmlAttr = xmlNode.append_attribute(attrName.c_str());
-        xmlAttr.set_value(elem->getAttribute(attrName).c_str());
-    }
+        xmlAttr.set_value(attrValue.c_str());
+    });
 
     // Create child nodes and recurse.
     StringSet writtenSourceFiles;
@@ -151,6 +154,56 @@ void elementToXml(ConstElementPtr elem, xml_node& xmlNode, const XmlWriteOptions
     }
 }
 
+void readXInclude(DocumentPtr doc,
+                  const string& filename,
+                  const FileSearchPath& searchPath,
+                  FileSearchPath& includeSearchPath,
+                  const XmlReadOptions* readOptions)
+{
+    XmlReadFunction readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
+
+    // Check for XInclude cycles.
+    if (readOptions)
+    {
+        const StringVec& parents = readOptions->parentXIncludes;
+        if (std::find(parents.begin(), parents.end(), filename) != parents.end())
+        {
+            throw ExceptionParseError("XInclude cycle detected.");
+        }
+    }
+
+    // Read the included file into a library document.
+    DocumentPtr library = createDocument();
+    XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
+    xiReadOptions.parentXIncludes.push_back(filename);
+
+    // Prepend the directory of the parent to accommodate
+    // includes relative to the parent file location.
+    if (includeSearchPath.isEmpty())
+    {
+        string parentUri = doc->getSourceUri();
+        if (!parentUri.empty())
+        {
+            FilePath filePath = searchPath.find(parentUri);
+            if (!filePath.isEmpty())
+            {
+                // Remove the file name from the path as we want the path to the containing folder.
+                includeSearchPath = searchPath;
+                includeSearchPath.prepend(filePath.getParentPath());
+            }
+        }
+        // Set default search path if no parent path found
+        if (includeSearchPath.isEmpty())
+        {
+            includeSearchPath = searchPath;
+        }
+    }
+    readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
+
+    // Import the library document.
+    doc->importLibrary(library);
+}
+
 void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
 {
     // Search path for includes. Set empty and then evaluated once in the iteration through xml includes.
@@ -165,48 +218,7 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath&
             // Read XInclude references if requested.
             if (readXIncludeFunction)
             {
-                string filename = xmlChild.attribute("href").value();
-
-                // Check for XInclude cycles.
-                if (readOptions)
-                {
-                    const StringVec& parents = readOptions->parentXIncludes;
-                    if (std::find(parents.begin(), parents.end(), filename) != parents.end())
-                    {
-                        throw ExceptionParseError("XInclude cycle detected.");
-                    }
-                }
-
-                // Read the included file into a library document.
-                DocumentPtr library = createDocument();
-                XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
-                xiReadOptions.parentXIncludes.push_back(filename);
-
-                // Prepend the directory of the parent to accommodate
-                // includes relative to the parent file location.
-                if (includeSearchPath.isEmpty())
-                {
-                    string parentUri = doc->getSourceUri();
-                    if (!parentUri.empty())
-                    {
-                        FilePath filePath = searchPath.find(parentUri);
-                        if (!filePath.isEmpty())
-                        {
-                            // Remove the file name from the path as we want the path to the containing folder.
-                            includeSearchPath = searchPath;
-                            includeSearchPath.prepend(filePath.getParentPath());
-                        }
-                    }
-                    // Set default search path if no parent path found
-                    if (includeSearchPath.isEmpty())
-                    {
-                        includeSearchPath = searchPath;
-                    }
-                }
-                readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
-
-                // Import the library document.
-                doc->importLibrary(library);
+                readXInclude(doc, xmlChild.attribute("href").value(), searchPath, includeSearchPath, readOptions);
             }
 
             // Remove include directive.
@@ -282,6 +294,602 @@ unsigned int getParseOptions(const XmlReadOptions* readOptions)
     return parseOptions;
 }
 
+// A streaming XML reader, which constructs elements directly from the text of
+// an XML document without building an intermediate XML tree.  Elements are
+// created following the same rules that elementFromXml applies to a tree
+// parsed by pugixml with the same read options.
+class XmlStreamReader
+{
+  public:
+    XmlStreamReader(const char* begin, const char* end, const XmlReadOptions* readOptions, const FilePath& filename) :
+        _begin(begin),
+        _end(std::find(begin, end, '\0')),
+        _pos(begin),
+        _readComments(readOptions && readOptions->readComments),
+        _readNewlines(readOptions && readOptions->readNewlines),
+        _filename(filename)
+    {
+        // Skip a UTF-8 byte order mark.
+        if (_end - _begin >= 3 && std::memcmp(_begin, "\xEF\xBB\xBF", 3) == 0)
+        {
+            _begin += 3;
+        }
+    }
+
+    // Parse the complete document without constructing elements, throwing
+    // an exception for malformed text, and return the filenames of the
+    // XInclude directives at the root scope, in document order.
+    StringVec readXIncludes()
+    {
+        StringVec filenames;
+        parse(nullptr, &filenames);
+        return filenames;
+    }
+
+    // Read the contents of the document root into the given document.
+    void readDocument(DocumentPtr doc)
+    {
+        parse(doc, nullptr);
+    }
+
+  private:
+    struct Frame
+    {
+        std::string_view tag;
+        ElementPtr elem;
+        bool root;
+    };
+
+    void parse(DocumentPtr doc, StringVec* xincludes)
+    {
+        vector<Frame> frames;
+        bool documentElementFound = false;
+        bool rootFound = false;
+
+        _pos = _begin;
+        while (_pos < _end)
+        {
+            if (*_pos != '<')
+            {
+                const char* text = _pos;
+                _pos = std::find(_pos, _end, '<');
+                if (!frames.empty() && frames.back().elem)
+                {
+                    readText(frames.back().elem, text, _pos);
+                }
+                continue;
+            }
+
+            if (startsWith("<!--"))
+            {
+                const char* content = _pos + 4;
+                const char* contentEnd = find(content, "-->", "Error parsing comment");
+                if (_readComments && !frames.empty() && frames.back().elem)
+                {
+                    ElementPtr child = frames.back().elem->addChildOfCategory(EMPTY_STRING, EMPTY_STRING);
+                    child = frames.back().elem->changeChildCategory(child, CommentElement::CATEGORY);
+                    child->setDocString(normalizeNewlines(content, contentEnd));
+                }
+                _pos = contentEnd + 3;
+            }
+            else if (startsWith("<![CDATA["))
+            {
+                const char* contentEnd = find(_pos + 9, "]]>", "Error parsing CDATA section");
+                if (!frames.empty() && frames.back().elem)
+                {
+                    frames.back().elem->addChildOfCategory(EMPTY_STRING, EMPTY_STRING);
+                }
+                _pos = contentEnd + 3;
+            }
+            else if (startsWith("<!DOCTYPE"))
+            {
+                skipDoctype();
+            }
+            else if (startsWith("<?"))
+            {
+                _pos = find(_pos + 2, "?>", "Error parsing document declaration/processing instruction") + 2;
+            }
+            else if (startsWith("</"))
+            {
+                _pos += 2;
+                std::string_view tag = readName();
+                if (frames.empty() || tag != frames.back().tag)
+                {
+                    error("Start-end tags mismatch");
+                }
+                skipSpaces();
+                if (_pos >= _end || *_pos != '>')
+                {
+                    error("Error parsing end element tag");
+                }
+                _pos++;
+                frames.pop_back();
+            }
+            else
+            {
+                _pos++;
+                std::string_view tag = readName();
+                bool closed = readAttributes();
+
+                Frame frame = { tag, nullptr, false };
+                if (frames.empty())
+                {
+                    // Only the first document element with the MaterialX category
+                    // is read, as with xml_node::child.
+                    documentElementFound = true;
+                    if (!rootFound && tag == Document::CATEGORY)
+                    {
+                        rootFound = true;
+                        frame.root = true;
+                        frame.elem = doc;
+                        if (doc)
+                        {
+                            setAttributes(doc);
+                        }
+                    }
+                }
+                else if (frames.back().root && tag == XINCLUDE_TAG)
+                {
+                    if (xincludes)
+                    {
+                        xincludes->push_back(getAttribute("href"));
+                    }
+                }
+                else if (frames.back().elem)
+                {
+                    frame.elem = addChild(frames.back().elem, tag);
+                }
+
+                if (!closed)
+                {
+                    frames.push_back(frame);
+                }
+            }
+        }
+
+        if (!frames.empty())
+        {
+            error("Start-end tags mismatch");
+        }
+        if (!documentElementFound)
+        {
+            error("No document element found");
+        }
+    }
+
+    // Create a child element from the tag and attributes most recently read,
+    // returning an empty pointer if a child of the same name already exists.
+    ElementPtr addChild(const ElementPtr& parent, std::string_view tag)
+    {
+        const string& name = getAttribute(Element::NAME_ATTRIBUTE);
+        if (parent->getChild(name))
+        {
+            return nullptr;
+        }
+
+        _category.assign(tag.data(), tag.size());
+        ElementPtr child = parent->addChildOfCategory(_category, name);
+        setAttributes(child);
+        return child;
+    }
+
+    void setAttributes(const ElementPtr& elem)
+    {
+        for (size_t i = 0; i < _attrCount; i++)
+        {
+            if (_attrs[i].first != Element::NAME_ATTRIBUTE)
+            {
+                elem->setAttribute(_attrs[i].first, _attrs[i].second);
+            }
+        }
+    }
+
+    const string& getAttribute(const string& attrName) const
+    {
+        for (size_t i = 0; i < _attrCount; i++)
+        {
+            if (_attrs[i].first == attrName)
+            {
+                return _attrs[i].second;
+            }
+        }
+        return EMPTY_STRING;
+    }
+
+    // Read character data between tags, creating newline elements for blank
+    // lines if requested, and a generic element for any other text.
+    void readText(const ElementPtr& parent, const char* begin, const char* end)
+    {
+        const char* text = begin;
+        size_t lineCount = 0;
+        while (text < end && isSpace(*text))
+        {
+            lineCount += (*text == '\n');
+            text++;
+        }
+        if (_readNewlines)
+        {
+            for (size_t i = 1; i < lineCount; i++)
+            {
+                ElementPtr child = parent->addChildOfCategory(EMPTY_STRING, EMPTY_STRING);
+                parent->changeChildCategory(child, NewlineElement::CATEGORY);
+            }
+        }
+        if (text < end)
+        {
+            parent->addChildOfCategory(EMPTY_STRING, EMPTY_STRING);
+        }
+    }
+
+    // Read the attributes of a start tag, returning true if the tag is
+    // self-closing.
+    bool readAttributes()
+    {
+        _attrCount = 0;
+        while (true)
+        {
+            bool separated = skipSpaces();
+            if (_pos >= _end)
+            {
+                error("Error parsing start element tag");
+            }
+            if (*_pos == '>')
+            {
+                _pos++;
+                return false;
+            }
+            if (*_pos == '/')
+            {
+                if (_pos + 1 >= _end || _pos[1] != '>')
+                {
+                    error("Error parsing start element tag");
+                }
+                _pos += 2;
+                return true;
+            }
+            if (!separated)
+            {
+                error("Error parsing attribute name");
+            }
+
+            std::string_view attrName = readName();
+            skipSpaces();
+            if (_pos >= _end || *_pos != '=')
+            {
+                error("Attribute value expected");
+            }
+            _pos++;
+            skipSpaces();
+            if (_pos >= _end || (*_pos != '"' && *_pos != '\''))
+            {
+                error("Attribute value expected");
+            }
+            const char quote = *_pos++;
+            const char* value = _pos;
+            _pos = std::find(_pos, _end, quote);
+            if (_pos >= _end)
+            {
+                error("Error parsing attribute value");
+            }
+
+            if (_attrCount == _attrs.size())
+            {
+                _attrs.emplace_back();
+            }
+            _attrs[_attrCount].first.assign(attrName.data(), attrName.size());
+            decodeAttributeValue(value, _pos, _attrs[_attrCount].second);
+            _attrCount++;
+            _pos++;
+        }
+    }
+
+    // Decode entity references in an attribute value, and replace each
+    // whitespace character or CR/LF pair with a single space.
+    static void decodeAttributeValue(const char* begin, const char* end, string& value)
+    {
+        value.clear();
+        for (const char* p = begin; p < end; p++)
+        {
+            if (*p == '\r')
+            {
+                value += ' ';
+                if (p + 1 < end && p[1] == '\n')
+                {
+                    p++;
+                }
+            }
+            else if (*p == '\n' || *p == '\t')
+            {
+                value += ' ';
+            }
+            else if (*p == '&')
+            {
+                p = decodeEntity(p, end, value);
+            }
+            else
+            {
+                value += *p;
+            }
+        }
+    }
+
+    // Decode the entity reference at the given position, appending it to the
+    // given string and returning the position of its final character.  An
+    // unrecognized reference is appended as a literal ampersand.
+    static const char* decodeEntity(const char* p, const char* end, string& value)
+    {
+        static const std::pair<const char*, char> NAMED_ENTITIES[] = {
+            { "&amp;", '&' }, { "&apos;", '\'' }, { "&gt;", '>' }, { "&lt;", '<' }, { "&quot;", '"' }
+        };
+        for (const auto& entity : NAMED_ENTITIES)
+        {
+            size_t length = std::strlen(entity.first);
+            if ((size_t) (end - p) >= length && std::memcmp(p, entity.first, length) == 0)
+            {
+                value += entity.second;
+                return p + length - 1;
+            }
+        }
+
+        if (p + 1 < end && p[1] == '#')
+        {
+            bool hex = p + 2 < end && p[2] == 'x';
+            const char* digits = p + (hex ? 3 : 2);
+            uint32_t code = 0;
+            const char* q = digits;
+            for (; q < end && *q != ';'; q++)
+            {
+                uint32_t digit;
+                if (*q >= '0' && *q <= '9')
+                    digit = (uint32_t) (*q - '0');
+                else if (hex && (*q | ' ') >= 'a' && (*q | ' ') <= 'f')
+                    digit = (uint32_t) ((*q | ' ') - 'a' + 10);
+                else
+                    break;
+                code = code * (hex ? 16 : 10) + digit;
+            }
+            if (q < end && *q == ';' && q > digits)
+            {
+                appendUtf8(code, value);
+                return q;
+            }
+        }
+
+        value += '&';
+        return p;
+    }
+
+    static void appendUtf8(uint32_t code, string& value)
+    {
+        if (code < 0x80)
+        {
+            value += (char) code;
+        }
+        else if (code < 0x800)
+        {
+            value += (char) (0xC0 | (code >> 6));
+            value += (char) (0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            value += (char) (0xE0 | (code >> 12));
+            value += (char) (0x80 | ((code >> 6) & 0x3F));
+            value += (char) (0x80 | (code & 0x3F));
+        }
+        else
+        {
+            value += (char) (0xF0 | (code >> 18));
+            value += (char) (0x80 | ((code >> 12) & 0x3F));
+            value += (char) (0x80 | ((code >> 6) & 0x3F));
+            value += (char) (0x80 | (code & 0x3F));
+        }
+    }
+
+    // Return the given text with each CR/LF pair or lone CR replaced by LF.
+    static string normalizeNewlines(const char* begin, const char* end)
+    {
+        string text(begin, end);
+        if (std::find(begin, end, '\r') == end)
+        {
+            return text;
+        }
+        string result;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            if (text[i] == '\r')
+            {
+                result += '\n';
+                if (i + 1 < text.size() && text[i + 1] == '\n')
+                {
+                    i++;
+                }
+            }
+            else
+            {
+                result += text[i];
+            }
+        }
+        return result;
+    }
+
+    std::string_view readName()
+    {
+        const char* name = _pos;
+        if (_pos >= _end || !isNameStartChar(*_pos))
+        {
+            error("Unrecognized tag");
+        }
+        while (_pos < _end && isNameChar(*_pos))
+        {
+            _pos++;
+        }
+        return std::string_view(name, _pos - name);
+    }
+
+    void skipDoctype()
+    {
+        size_t depth = 0;
+        for (; _pos < _end; _pos++)
+        {
+            if (*_pos == '"' || *_pos == '\'')
+            {
+                _pos = std::find(_pos + 1, _end, *_pos);
+                if (_pos >= _end)
+                {
+                    break;
+                }
+            }
+            else if (*_pos == '<')
+            {
+                depth++;
+            }
+            else if (*_pos == '>' && --depth == 0)
+            {
+                _pos++;
+                return;
+            }
+        }
+        error("Error parsing document type declaration");
+    }
+
+    // Skip whitespace, returning true if any was found.
+    bool skipSpaces()
+    {
+        const char* start = _pos;
+        while (_pos < _end && isSpace(*_pos))
+        {
+            _pos++;
+        }
+        return _pos != start;
+    }
+
+    bool startsWith(const char* prefix) const
+    {
+        size_t length = std::strlen(prefix);
+        return (size_t) (_end - _pos) >= length && std::memcmp(_pos, prefix, length) == 0;
+    }
+
+    const char* find(const char* start, const char* terminator, const char* errorDesc)
+    {
+        const char* found = std::search(start, _end, terminator, terminator + std::strlen(terminator));
+        if (found == _end)
+        {
+            error(errorDesc);
+        }
+        return found;
+    }
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    static bool isNameStartChar(char c)
+    {
+        return std::isalpha((unsigned char) c) || c == '_' || c == ':' || (unsigned char) c >= 0x80;
+    }
+
+    static bool isNameChar(char c)
+    {
+        return isNameStartChar(c) || std::isdigit((unsigned char) c) || c == '-' || c == '.';
+    }
+
+    [[noreturn]] void error(const string& desc) const
+    {
+        string message = "XML parse error";
+        if (!_filename.isEmpty())
+        {
+            message += " in " + _filename.asString();
+        }
+        message += " (" + desc + " at character " + std::to_string(std::min(_pos, _end) - _begin) + ")";
+        throw ExceptionParseError(message);
+    }
+
+  private:
+    const char* _begin;
+    const char* _end;
+    const char* _pos;
+    bool _readComments;
+    bool _readNewlines;
+    FilePath _filename;
+
+    // Attributes of the most recently read start tag, with storage reused
+    // across tags.
+    vector<std::pair<string, string>> _attrs;
+    size_t _attrCount = 0;
+    string _category;
+};
+
+// Return true if the given XML text can be read by XmlStreamReader, which
+// supports UTF-8 text only.  Other encodings are read through pugixml.
+bool isStreamable(const char* begin, const char* end)
+{
+    if (end - begin >= 2)
+    {
+        const unsigned char c0 = (unsigned char) begin[0];
+        const unsigned char c1 = (unsigned char) begin[1];
+        if (c0 == 0xFE || c0 == 0xFF || c0 == 0 || c1 == 0)
+        {
+            return false;
+        }
+    }
+
+    // Check for a declared encoding other than UTF-8.
+    if (end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0)
+    {
+        begin += 3;
+    }
+    string declaration = stringToLower(string(begin, std::find(begin, end, '>')));
+    if (stringStartsWith(declaration, "<?xml"))
+    {
+        size_t start = declaration.find_first_of("\"'", declaration.find("encoding"));
+        if (start != string::npos)
+        {
+            size_t close = declaration.find(declaration[start], start + 1);
+            string encoding = declaration.substr(start + 1, close - start - 1);
+            return encoding == "utf-8" || encoding == "utf8";
+        }
+    }
+    return true;
+}
+
+void documentFromXmlText(DocumentPtr doc,
+                         const char* begin,
+                         const char* end,
+                         const FileSearchPath& searchPath,
+                         const XmlReadOptions* readOptions,
+                         const FilePath& filename = FilePath(),
+                         const string& sourceUri = EMPTY_STRING)
+{
+    // As with pugixml, the complete text is parsed before the document is
+    // modified, so that malformed text leaves the document unchanged.
+    XmlStreamReader reader(begin, end, readOptions, filename);
+    StringVec xincludes = reader.readXIncludes();
+
+    // The source URI is used in searching for XIncludes.
+    if (!sourceUri.empty())
+    {
+        doc->setSourceUri(sourceUri);
+    }
+
+    // XIncludes are read before any other content, as in documentFromXml.
+    XmlReadFunction readXIncludeFunction = readOptions ? readOptions->readXIncludeFunction : readFromXmlFile;
+    if (readXIncludeFunction)
+    {
+        FileSearchPath includeSearchPath;
+        for (const string& xinclude : xincludes)
+        {
+            readXInclude(doc, xinclude, searchPath, includeSearchPath, readOptions);
+        }
+    }
+    reader.readDocument(doc);
+
+    if (!readOptions || readOptions->upgradeVersion)
+    {
+        doc->upgradeVersion();
+    }
+}
+
 } // anonymous namespace
 
 //
@@ -292,6 +900,7 @@ XmlReadOptions::XmlReadOptions() :
     readComments(false),
     readNewlines(false),
     upgradeVersion(true),
+    readStreaming(false),
     readXIncludeFunction(readFromXmlFile)
 {
 }
@@ -313,6 +922,13 @@ void readFromXmlBuffer(DocumentPtr doc, const char* buffer, FileSearchPath searc
 {
     searchPath.append(getEnvironmentPath());
 
+    const char* bufferEnd = buffer + std::strlen(buffer);
+    if (readOptions && readOptions->readStreaming && isStreamable(buffer, bufferEnd))
+    {
+        documentFromXmlText(doc, buffer, bufferEnd, searchPath, readOptions);
+        return;
+    }
+
     xml_document xmlDoc;
     xml_parse_result result = xmlDoc.load_string(buffer, getParseOptions(readOptions));
     validateParseResult(result);
@@ -325,7 +941,21 @@ void readFromXmlStream(DocumentPtr doc, std::istream& stream, FileSearchPath sea
     searchPath.append(getEnvironmentPath());
 
     xml_document xmlDoc;
-    xml_parse_result result = xmlDoc.load(stream, getParseOptions(readOptions));
+    xml_parse_result result;
+    if (readOptions && readOptions->readStreaming)
+    {
+        string str((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        if (isStreamable(str.data(), str.data() + str.size()))
+        {
+            documentFromXmlText(doc, str.data(), str.data() + str.size(), searchPath, readOptions);
+            return;
+        }
+        result = xmlDoc.load_buffer(str.data(), str.size(), getParseOptions(readOptions));
+    }
+    else
+    {
+        result = xmlDoc.load(stream, getParseOptions(readOptions));
+    }
     validateParseResult(result);
 
     documentFromXml(doc, xmlDoc, searchPath, readOptions);
@@ -336,25 +966,51 @@ void readFromXmlFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPa
     searchPath.append(getEnvironmentPath());
     filename = searchPath.find(filename);
 
+    string text;
     xml_document xmlDoc;
-    xml_parse_result result = xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
-    validateParseResult(result, filename);
+    bool streaming = false;
+    if (readOptions && readOptions->readStreaming)
+    {
+        std::ifstream file(filename.asString(), std::ios::binary);
+        if (!file)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+        text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        streaming = isStreamable(text.data(), text.data() + text.size());
+    }
+    if (!streaming)
+    {
+        xml_parse_result result = xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
+        validateParseResult(result, filename);
+    }
 
-    // This must be done before parsing the XML as the source URI
-    // is used for searching for include files.
-    if (readOptions && !readOptions->parentXIncludes.empty())
+    // This must be done before reading elements from the XML as the source
+    // URI is used for searching for include files.
+    const string sourceUri = (readOptions && !readOptions->parentXIncludes.empty()) ?
+                             readOptions->parentXIncludes[0] :
+                             filename.asString();
+    if (streaming)
     {
-        doc->setSourceUri(readOptions->parentXIncludes[0]);
+        documentFromXmlText(doc, text.data(), text.data() + text.size(), searchPath, readOptions, filename, sourceUri);
     }
     else
     {
-        doc->setSourceUri(filename);
+        doc->setSourceUri(sourceUri);
+        documentFromXml(doc, xmlDoc, searchPath, readOptions);
     }
-    documentFromXml(doc, xmlDoc, searchPath, readOptions);
 }
 
 void readFromXmlString(DocumentPtr doc, const string& str, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
 {
+    if (readOptions && readOptions->readStreaming && isStreamable(str.data(), str.data() + str.size()))
+    {
+        FileSearchPath streamSearchPath = searchPath;
+        streamSearchPath.append(getEnvironmentPath());
+        documentFromXmlText(doc, str.data(), str.data() + str.size(), streamSearchPath, readOptions);
+        return;
+    }
+
     std::istringstream stream(str);
     readFromXmlStream(doc, stream, searchPath, readOptions);
 }
@@ -46,8 +46,19 @@ class MX_FORMAT_API XmlReadOptions
     /// to the current version.  Defaults to true.
     bool upgradeVersion;
 
+    /// If true, then documents will be read by a streaming parser, which
+    /// constructs elements directly from the XML text rather than first
+    /// building a complete XML tree.  This reduces load time for large
+    /// documents, and produces the same documents as the default parser.
+    /// The complete XML text is still held in memory while it is read, and
+    /// as with the default parser, it is fully parsed before the document
+    /// is modified, so a parse error leaves the document unchanged.
+    /// Defaults to false.
+    bool readStreaming;
+
     /// If provided, this function will be invoked when an XInclude reference
     /// needs to be read into a document.  Defaults to readFromXmlFile.
+    /// The function is only called from the thread performing the read.
     XmlReadFunction readXIncludeFunction;
 
     /// The vector of parent XIncludes at the scope of the current document.
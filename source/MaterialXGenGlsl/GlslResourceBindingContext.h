@@ -32,6 +32,12 @@ class MX_GENGLSL_API GlslResourceBindingContext : public HwResourceBindingContex
             uniformBindingLocation, samplerBindingLocation);
     }
 
+    // Return a copy of this context.
+    HwResourceBindingContextPtr clone() const override
+    {
+        return std::make_shared<GlslResourceBindingContext>(*this);
+    }
+
     // Initialize the context before generation starts.
     void initialize() override;
 
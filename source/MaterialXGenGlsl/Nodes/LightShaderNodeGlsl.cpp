@@ -44,7 +44,8 @@ void LightShaderNodeGlsl::initialize(const InterfaceElement& element, GenContext
     NodeDefPtr nodeDef = impl.getNodeDef();
     for (InputPtr input : nodeDef->getActiveInputs())
     {
-        _lightUniforms.add(TypeDesc::get(input->getType()), input->getName(), input->getValue());
+        ConstValuePtr value = input->getValue();
+        _lightUniforms.add(TypeDesc::get(input->getType()), input->getName(), value ? value->copy() : nullptr);
     }
 }
 
@@ -30,6 +30,12 @@ class MX_GENGLSL_API VkResourceBindingContext : public HwResourceBindingContext
         return std::make_shared<VkResourceBindingContext>(uniformBindingLocation);
     }
 
+    // Return a copy of this context.
+    HwResourceBindingContextPtr clone() const override
+    {
+        return std::make_shared<VkResourceBindingContext>(*this);
+    }
+
     // Initialize the context before generation starts.
     void initialize() override;
 
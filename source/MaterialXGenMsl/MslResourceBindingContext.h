@@ -32,6 +32,12 @@ class MX_GENMSL_API MslResourceBindingContext : public HwResourceBindingContext
             uniformBindingLocation, samplerBindingLocation);
     }
 
+    // Return a copy of this context.
+    HwResourceBindingContextPtr clone() const override
+    {
+        return std::make_shared<MslResourceBindingContext>(*this);
+    }
+
     // Initialize the context before generation starts.
     void initialize() override;
 
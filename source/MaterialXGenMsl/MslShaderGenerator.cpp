@@ -216,12 +216,12 @@ ShaderPtr MslShaderGenerator::generate(const string& name, ElementPtr element, G
     // Emit code for vertex shader stage
     ShaderStage& vs = shader->getStage(Stage::VERTEX);
     emitVertexStage(shader->getGraph(), context, vs);
-    replaceTokens(_tokenSubstitutions, vs);
+    replaceTokens(context.getTokenSubstitutions(), vs);
 
     // Emit code for pixel shader stage
     ShaderStage& ps = shader->getStage(Stage::PIXEL);
     emitPixelStage(shader->getGraph(), context, ps);
-    replaceTokens(_tokenSubstitutions, ps);
+    replaceTokens(context.getTokenSubstitutions(), ps);
 
     MetalizeGeneratedShader(ps);
 
@@ -985,17 +985,17 @@ void MslShaderGenerator::emitPixelStage(const ShaderGraph& graph, GenContext& co
         // depending on the vertical flip flag.
         if (context.getOptions().fileTextureVerticalFlip)
         {
-            _tokenSubstitutions[ShaderGenerator::T_FILE_TRANSFORM_UV] = "mx_transform_uv_vflip.glsl";
+            context.setTokenSubstitution(ShaderGenerator::T_FILE_TRANSFORM_UV, "mx_transform_uv_vflip.glsl");
         }
         else
         {
-            _tokenSubstitutions[ShaderGenerator::T_FILE_TRANSFORM_UV] = "mx_transform_uv.glsl";
+            context.setTokenSubstitution(ShaderGenerator::T_FILE_TRANSFORM_UV, "mx_transform_uv.glsl");
         }
 
         // Emit uv transform code globally if needed.
         if (context.getOptions().hwAmbientOcclusion)
         {
-            emitLibraryInclude("stdlib/genglsl/lib/" + _tokenSubstitutions[ShaderGenerator::T_FILE_TRANSFORM_UV], context, stage);
+            emitLibraryInclude("stdlib/genglsl/lib/" + context.getTokenSubstitutions().at(ShaderGenerator::T_FILE_TRANSFORM_UV), context, stage);
         }
 
         emitLightFunctionDefinitions(graph, context, stage);
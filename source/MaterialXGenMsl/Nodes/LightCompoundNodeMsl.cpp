@@ -81,7 +81,10 @@ void LightCompoundNodeMsl::emitFunctionDefinition(const ShaderNode& node, GenCon
         {
             for (ClosureContext* cct : ccts)
             {
-                emitFunctionDefinition(cct, context, stage);
+                // Closure parameters are set on the context during emission,
+                // so use a local copy of the context owned by the generator.
+                ClosureContext localCct(*cct);
+                emitFunctionDefinition(&localCct, context, stage);
             }
         }
     }
@@ -6,6 +6,8 @@
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 
+#include <MaterialXFormat/Util.h>
+
 MATERIALX_NAMESPACE_BEGIN
 
 //
@@ -13,7 +15,8 @@ MATERIALX_NAMESPACE_BEGIN
 //
 
 GenContext::GenContext(ShaderGeneratorPtr sg) :
-    _sg(sg)
+    _sg(sg),
+    _sourceFileCache(SourceFileCache::getDefault())
 {
     if (!_sg)
     {
@@ -27,7 +30,8 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
     reservedWords = _sg->getSyntax().getReservedWords();
 
     // Add token substitution identifiers
-    for (const auto& it : _sg->getTokenSubstitutions())
+    _tokenSubstitutions = _sg->getTokenSubstitutions();
+    for (const auto& it : _tokenSubstitutions)
     {
         if (!it.second.empty())
         {
@@ -40,6 +44,35 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
     _applicationVariableHandler = nullptr;
 }
 
+FilePath GenContext::resolveSourceFile(const FilePath& filename, const FilePath& localPath) const
+{
+    FileSearchPath searchPath = _sourceCodeSearchPath;
+    if (!localPath.isEmpty())
+    {
+        searchPath.prepend(localPath);
+    }
+
+    // Check for files added to the cache, which need not exist on disk.
+    if (_sourceFileCache && _sourceFileCache->hasAddedFiles() && !filename.isEmpty() && !filename.isAbsolute())
+    {
+        for (const FilePath& path : searchPath)
+        {
+            FilePath combined = (path / filename).getNormalized();
+            if (_sourceFileCache->hasAddedFile(combined) || combined.exists())
+            {
+                return combined;
+            }
+        }
+    }
+
+    return searchPath.find(filename).getNormalized();
+}
+
+string GenContext::readSourceFile(const FilePath& filename) const
+{
+    return _sourceFileCache ? _sourceFileCache->readFile(filename) : readFile(filename);
+}
+
 void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
 {
     _nodeImpls[name] = impl;
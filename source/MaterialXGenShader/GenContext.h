@@ -13,7 +13,9 @@
 
 #include <MaterialXGenShader/GenOptions.h>
 #include <MaterialXGenShader/GenUserData.h>
+#include <MaterialXGenShader/ShaderCache.h>
 #include <MaterialXGenShader/ShaderNode.h>
+#include <MaterialXGenShader/SourceFileCache.h>
 
 #include <MaterialXFormat/File.h>
 
@@ -27,6 +29,11 @@ using ApplicationVariableHandler = std::function<void(ShaderNode*, GenContext&)>
 /// @class GenContext
 /// A context class for shader generation.
 /// Used for thread local storage of data needed during shader generation.
+///
+/// A shader generator holds no state that changes during generation, so
+/// a single generator, along with the documents it reads from, may be shared
+/// by any number of threads, provided that each thread generates shaders
+/// with its own GenContext.
 class MX_GENSHADER_API GenContext
 {
   public:
@@ -65,16 +72,48 @@ class MX_GENSHADER_API GenContext
         _sourceCodeSearchPath.append(path);
     }
 
+    /// Return the user search path for finding source code during
+    /// code generation.
+    const FileSearchPath& getSourceCodeSearchPath() const
+    {
+        return _sourceCodeSearchPath;
+    }
+
     /// Resolve a source code filename, first checking the given local path
-    /// then checking any file paths registered by the user.
-    FilePath resolveSourceFile(const FilePath& filename, const FilePath& localPath) const
+    /// then checking any file paths registered by the user.  Files added to
+    /// the source file cache are resolved even if they are not on disk.
+    FilePath resolveSourceFile(const FilePath& filename, const FilePath& localPath) const;
+
+    /// Set the cache used to read source code files during code generation,
+    /// or nullptr to read source code files directly from disk.
+    /// Defaults to the process-wide cache returned by SourceFileCache::getDefault.
+    void setSourceFileCache(SourceFileCachePtr cache)
     {
-        FileSearchPath searchPath = _sourceCodeSearchPath;
-        if (!localPath.isEmpty())
-        {
-            searchPath.prepend(localPath);
-        }
-        return searchPath.find(filename).getNormalized();
+        _sourceFileCache = cache;
+    }
+
+    /// Return the cache used to read source code files during code generation.
+    SourceFileCachePtr getSourceFileCache() const
+    {
+        return _sourceFileCache;
+    }
+
+    /// Return the contents of a resolved source code file, reading it
+    /// through the source file cache if one is set.
+    string readSourceFile(const FilePath& filename) const;
+
+    /// Set the cache used by shader generation utilities to reuse shaders
+    /// generated with this context, or nullptr to disable caching.
+    /// Defaults to nullptr.
+    void setShaderCache(ShaderCachePtr cache)
+    {
+        _shaderCache = cache;
+    }
+
+    /// Return the cache used to reuse shaders generated with this context.
+    ShaderCachePtr getShaderCache() const
+    {
+        return _shaderCache;
     }
 
     /// Add reserved words that should not be used as
@@ -91,6 +130,20 @@ class MX_GENSHADER_API GenContext
         return _reservedWords;
     }
 
+    /// Set the substitution for a token in shader code generated with this
+    /// context, overriding any substitution given by the shader generator.
+    void setTokenSubstitution(const string& token, const string& substitution)
+    {
+        _tokenSubstitutions[token] = substitution;
+    }
+
+    /// Return the map of token substitutions for shader code generated with
+    /// this context, including the substitutions of the shader generator.
+    const StringMap& getTokenSubstitutions() const
+    {
+        return _tokenSubstitutions;
+    }
+
     /// Cache a shader node implementation.
     void addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
 
@@ -226,7 +279,10 @@ class MX_GENSHADER_API GenContext
     ShaderGeneratorPtr _sg;
     GenOptions _options;
     FileSearchPath _sourceCodeSearchPath;
+    SourceFileCachePtr _sourceFileCache;
+    ShaderCachePtr _shaderCache;
     StringSet _reservedWords;
+    StringMap _tokenSubstitutions;
 
     std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
     std::unordered_map<string, vector<GenUserDataPtr>> _userData;
@@ -92,7 +92,8 @@ class MX_GENSHADER_API GenOptions
         hwWriteAlbedoTable(false),
         hwWriteEnvPrefilter(false),
         hwImplicitBitangents(true),
-        emitColorTransforms(true)
+        emitColorTransforms(true),
+        optimizeShaderGraph(false)
     {
     }
     virtual ~GenOptions() { }
@@ -186,6 +187,13 @@ class MX_GENSHADER_API GenOptions
     /// Enable emitting colorspace transform code if a color management
     /// system is defined. Defaults to true.
     bool emitColorTransforms;
+
+    /// Enable additional optimization of shader graphs, folding math nodes
+    /// with constant inputs, removing algebraic identities such as a multiply
+    /// by one, and merging structurally identical nodes. Inputs that are
+    /// published as shader uniforms are never treated as constant.
+    /// Defaults to false.
+    bool optimizeShaderGraph;
 };
 
 MATERIALX_NAMESPACE_END
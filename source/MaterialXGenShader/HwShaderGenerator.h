@@ -375,6 +375,10 @@ class MX_GENSHADER_API HwResourceBindingContext : public GenUserData
   public:
     virtual ~HwResourceBindingContext() { }
 
+    // Return a copy of this context, allowing generation to run concurrently
+    // with separate binding state.  Returns nullptr if the context cannot be copied.
+    virtual HwResourceBindingContextPtr clone() const { return nullptr; }
+
     // Initialize the context before generation starts.
     virtual void initialize() = 0;
 
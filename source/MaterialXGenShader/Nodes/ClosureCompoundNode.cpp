@@ -42,7 +42,10 @@ void ClosureCompoundNode::emitFunctionDefinition(const ShaderNode& node, GenCont
         {
             for (ClosureContext* cct : ccts)
             {
-                emitFunctionDefinition(cct, context, stage);
+                // Closure parameters are set on the context during emission,
+                // so use a local copy of the context owned by the generator.
+                ClosureContext localCct(*cct);
+                emitFunctionDefinition(&localCct, context, stage);
             }
         }
     }
@@ -42,7 +42,7 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
     {
         FilePath localPath = FilePath(impl.getActiveSourceUri()).getParentPath();
         _sourceFilename = context.resolveSourceFile(impl.getAttribute("file"), localPath);
-        _functionSource = readFile(_sourceFilename);
+        _functionSource = context.readSourceFile(_sourceFilename);
         if (_functionSource.empty())
         {
             throw ExceptionShaderGenError("Failed to get source code from file '" + _sourceFilename.asString() +
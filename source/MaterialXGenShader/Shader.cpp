@@ -25,6 +25,23 @@ Shader::Shader(const string& name, ShaderGraphPtr graph) :
 {
 }
 
+ShaderPtr Shader::copy() const
+{
+    ShaderPtr shader = std::make_shared<Shader>(_name, _graph);
+    shader->_attributeMap = _attributeMap;
+
+    std::unordered_map<const VariableBlock*, VariableBlockPtr> blockCopies;
+    std::unordered_map<const ShaderPort*, ShaderPortPtr> portCopies;
+    for (const ShaderStage* stage : _stages)
+    {
+        ShaderStagePtr stageCopy = std::make_shared<ShaderStage>(stage->getName(), stage->_syntax);
+        stageCopy->copyFrom(*stage, blockCopies, portCopies);
+        shader->_stagesMap[stage->getName()] = stageCopy;
+        shader->_stages.push_back(stageCopy.get());
+    }
+    return shader;
+}
+
 ShaderStage& Shader::getStage(size_t index)
 {
     return *_stages[index];
@@ -41,6 +41,11 @@ class MX_GENSHADER_API Shader
     /// Return the shader name
     const string& getName() const { return _name; }
 
+    /// Return a copy of this shader, with its own stages, variable blocks and
+    /// variables, which may be modified without affecting this shader.
+    /// The shader graph is shared with this shader, and should not be modified.
+    ShaderPtr copy() const;
+
     /// Return the number of shader stages for this shader.
     size_t numStages() const { return _stages.size(); }
 
@@ -0,0 +1,479 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+
+#include <MaterialXCore/Document.h>
+#include <MaterialXCore/Util.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <typeinfo>
+#include <unordered_set>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+const string CACHE_FILE_HEADER = "MaterialXShaderCache 1";
+const string CACHE_FILE_EXTENSION = "mtlxshader";
+
+// Append a length-prefixed string, so that distinct sequences of strings
+// always produce distinct descriptions.
+void appendString(string& desc, const string& str)
+{
+    desc += std::to_string(str.size());
+    desc += ':';
+    desc += str;
+}
+
+string formatHash(uint64_t hash)
+{
+    std::ostringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return stream.str();
+}
+
+void appendElement(string& desc, ConstElementPtr elem)
+{
+    appendString(desc, elem->getCategory());
+    appendString(desc, elem->getNamePath());
+    elem->forEachAttribute([&desc](const string& attrName, const string& attrValue)
+    {
+        appendString(desc, attrName);
+        appendString(desc, attrValue);
+    });
+    desc += '{';
+    for (ConstElementPtr child : elem->getChildren())
+    {
+        appendElement(desc, child);
+    }
+    desc += '}';
+}
+
+// Append the given element, along with all elements it depends on for the
+// given target, in a deterministic traversal order.  Elements of the data
+// library are appended by name and a hash of their content, which keeps the
+// description of library-based materials small.
+void appendGraph(string& desc, ElementPtr element, const string& target)
+{
+    ElementPtr root = element->getRoot();
+    std::unordered_set<ElementPtr> visited;
+    vector<ElementPtr> pending;
+    auto addElement = [&visited, &pending](ElementPtr elem)
+    {
+        if (elem && !elem->isA<Document>() && visited.insert(elem).second)
+        {
+            pending.push_back(elem);
+        }
+    };
+
+    addElement(element);
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        ElementPtr elem = pending[i];
+        if (elem->getRoot() != root)
+        {
+            string content;
+            appendElement(content, elem);
+            desc += '@';
+            appendString(desc, elem->getNamePath());
+            appendString(desc, formatHash(hashString(content)));
+        }
+        else
+        {
+            appendElement(desc, elem);
+        }
+        appendString(desc, elem->getActiveFilePrefix());
+        appendString(desc, elem->getActiveColorSpace());
+
+        // Elements within a nodegraph may refer to its interface.
+        ElementPtr parent = elem->getParent();
+        if (parent && parent->isA<NodeGraph>())
+        {
+            addElement(parent);
+        }
+
+        for (ElementPtr child : elem->traverseTree())
+        {
+            if (child != elem)
+            {
+                visited.insert(child);
+            }
+            if (NodePtr node = child->asA<Node>())
+            {
+                addElement(node->getNodeDef(target));
+            }
+            else if (InputPtr input = child->asA<Input>())
+            {
+                addElement(input->getConnectedNode());
+                OutputPtr output = input->getConnectedOutput();
+                if (output)
+                {
+                    addElement(output->getParent());
+                }
+            }
+            else if (OutputPtr output = child->asA<Output>())
+            {
+                addElement(output->getConnectedNode());
+            }
+            else if (NodeDefPtr nodeDef = child->asA<NodeDef>())
+            {
+                addElement(nodeDef->getImplementation(target));
+                addElement(nodeDef->getInheritsFrom());
+            }
+            else if (ImplementationPtr impl = child->asA<Implementation>())
+            {
+                if (impl->hasNodeGraph())
+                {
+                    addElement(impl->getDocument()->getNodeGraph(impl->getNodeGraph()));
+                }
+            }
+        }
+    }
+}
+
+void writeString(std::ostream& stream, const string& str)
+{
+    stream << str.size() << '\n';
+    stream.write(str.data(), (std::streamsize) str.size());
+    stream << '\n';
+}
+
+bool readString(std::istream& stream, string& str)
+{
+    size_t size = 0;
+    if (!(stream >> size) || stream.get() != '\n')
+    {
+        return false;
+    }
+    str.resize(size);
+    if (size && !stream.read(&str[0], (std::streamsize) size))
+    {
+        return false;
+    }
+    return stream.get() == '\n';
+}
+
+} // anonymous namespace
+
+//
+// ShaderCache methods
+//
+
+ShaderPtr ShaderCache::generate(const string& name, ElementPtr element, GenContext& context)
+{
+    const string description = getShaderDescription(name, element, context);
+    const string key = getShaderKey(description);
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second.shader && it->second.description == description)
+        {
+            _hits++;
+            return it->second.shader->copy();
+        }
+    }
+
+    // Generate the shader outside of the lock, allowing other shaders to be
+    // generated concurrently.
+    _misses++;
+    ShaderPtr shader = context.getShaderGenerator().generate(name, element, context);
+    if (!shader)
+    {
+        return nullptr;
+    }
+
+    // Cache a copy of the shader, so that changes made by the caller to the
+    // variables of the returned shader are not seen by later requests.
+    Entry entry;
+    entry.description = description;
+    entry.shader = shader->copy();
+    for (size_t i = 0; i < entry.shader->numStages(); i++)
+    {
+        const ShaderStage& stage = entry.shader->getStage(i);
+        entry.sourceCode[stage.getName()] = stage.getSourceCode();
+    }
+    if (!_directory.isEmpty())
+    {
+        writeEntry(key, entry, context);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _entries[key] = std::move(entry);
+    return shader;
+}
+
+StringMap ShaderCache::generateSourceCode(const string& name, ElementPtr element, GenContext& context)
+{
+    const string description = getShaderDescription(name, element, context);
+    const string key = getShaderKey(description);
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second.description == description)
+        {
+            _hits++;
+            return it->second.sourceCode;
+        }
+    }
+
+    if (!_directory.isEmpty())
+    {
+        Entry entry;
+        if (readEntry(key, description, context, entry))
+        {
+            _hits++;
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            Entry& stored = _entries[key];
+            if (stored.description != description)
+            {
+                stored = std::move(entry);
+            }
+            return stored.sourceCode;
+        }
+    }
+
+    ShaderPtr shader = generate(name, element, context);
+    if (!shader)
+    {
+        return StringMap();
+    }
+    StringMap sourceCode;
+    for (size_t i = 0; i < shader->numStages(); i++)
+    {
+        const ShaderStage& stage = shader->getStage(i);
+        sourceCode[stage.getName()] = stage.getSourceCode();
+    }
+    return sourceCode;
+}
+
+string ShaderCache::getShaderDescription(const string& name, ElementPtr element, GenContext& context)
+{
+    ShaderGenerator& generator = context.getShaderGenerator();
+    string desc;
+
+    // Generator and library state.
+    appendString(desc, getVersionString());
+    appendString(desc, typeid(generator).name());
+    appendString(desc, generator.getTarget());
+    ColorManagementSystemPtr cms = generator.getColorManagementSystem();
+    appendString(desc, cms ? cms->getName() : EMPTY_STRING);
+    UnitSystemPtr unitSystem = generator.getUnitSystem();
+    appendString(desc, unitSystem ? unitSystem->getName() : EMPTY_STRING);
+
+    // Context state.
+    const GenOptions& options = context.getOptions();
+    appendString(desc, name);
+    appendString(desc, std::to_string(options.shaderInterfaceType));
+    appendString(desc, std::to_string(options.fileTextureVerticalFlip));
+    appendString(desc, options.targetColorSpaceOverride);
+    appendString(desc, options.targetDistanceUnit);
+    appendString(desc, std::to_string(options.addUpstreamDependencies));
+    appendString(desc, options.libraryPrefix.asString());
+    appendString(desc, std::to_string(options.hwTransparency));
+    appendString(desc, std::to_string(options.hwSpecularEnvironmentMethod));
+    appendString(desc, std::to_string(options.hwDirectionalAlbedoMethod));
+    appendString(desc, std::to_string(options.hwTransmissionRenderMethod));
+    appendString(desc, std::to_string(options.hwWriteDepthMoments));
+    appendString(desc, std::to_string(options.hwShadowMap));
+    appendString(desc, std::to_string(options.hwAmbientOcclusion));
+    appendString(desc, std::to_string(options.hwMaxActiveLightSources));
+    appendString(desc, std::to_string(options.hwNormalizeUdimTexCoords));
+    appendString(desc, std::to_string(options.hwWriteAlbedoTable));
+    appendString(desc, std::to_string(options.hwWriteEnvPrefilter));
+    appendString(desc, std::to_string(options.hwImplicitBitangents));
+    appendString(desc, std::to_string(options.emitColorTransforms));
+    appendString(desc, std::to_string(options.optimizeShaderGraph));
+    appendString(desc, context.getSourceCodeSearchPath().asString());
+    for (const string& word : context.getReservedWords())
+    {
+        appendString(desc, word);
+    }
+    desc += '|';
+    // The file transform token is assigned by the generator from the
+    // options above, so it is skipped to keep the description stable.
+    vector<std::pair<string, string>> tokens;
+    for (const auto& pair : context.getTokenSubstitutions())
+    {
+        if (pair.first != ShaderGenerator::T_FILE_TRANSFORM_UV)
+        {
+            tokens.emplace_back(pair);
+        }
+    }
+    std::sort(tokens.begin(), tokens.end());
+    for (const auto& token : tokens)
+    {
+        appendString(desc, token.first);
+        appendString(desc, token.second);
+    }
+    desc += '|';
+    HwLightShadersPtr lightShaders = context.getUserData<HwLightShaders>(HW::USER_DATA_LIGHT_SHADERS);
+    if (lightShaders)
+    {
+        vector<std::pair<unsigned int, const ShaderNode*>> lights;
+        for (const auto& pair : lightShaders->get())
+        {
+            lights.emplace_back(pair.first, pair.second.get());
+        }
+        std::sort(lights.begin(), lights.end());
+        for (const auto& light : lights)
+        {
+            appendString(desc, std::to_string(light.first));
+            appendString(desc, light.second->getName());
+            appendString(desc, light.second->getImplementation().getName());
+        }
+    }
+    desc += '|';
+
+    // Element state.
+    DocumentPtr doc = element->getDocument();
+    doc->forEachAttribute([&desc](const string& attrName, const string& attrValue)
+    {
+        appendString(desc, attrName);
+        appendString(desc, attrValue);
+    });
+    desc += '|';
+    appendGraph(desc, element, generator.getTarget());
+
+    return desc;
+}
+
+string ShaderCache::getShaderKey(const string& description)
+{
+    return formatHash(hashString(description));
+}
+
+void ShaderCache::clear()
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _entries.clear();
+}
+
+bool ShaderCache::readEntry(const string& key, const string& description, GenContext& context, Entry& entry) const
+{
+    FilePath filename = _directory / FilePath(key + "." + CACHE_FILE_EXTENSION);
+    std::ifstream stream(filename.asString(), std::ios::in | std::ios::binary);
+    if (!stream)
+    {
+        return false;
+    }
+
+    string header;
+    if (!std::getline(stream, header) || header != CACHE_FILE_HEADER)
+    {
+        return false;
+    }
+    if (!readString(stream, entry.description) || entry.description != description)
+    {
+        return false;
+    }
+
+    // Validate the source code files the entry was generated from.
+    size_t dependencyCount = 0;
+    if (!(stream >> dependencyCount) || stream.get() != '\n')
+    {
+        return false;
+    }
+    for (size_t i = 0; i < dependencyCount; i++)
+    {
+        string dependency, hash;
+        if (!readString(stream, dependency) || !readString(stream, hash))
+        {
+            return false;
+        }
+        if (formatHash(hashString(context.readSourceFile(dependency))) != hash)
+        {
+            return false;
+        }
+    }
+
+    size_t stageCount = 0;
+    if (!(stream >> stageCount) || stream.get() != '\n')
+    {
+        return false;
+    }
+    for (size_t i = 0; i < stageCount; i++)
+    {
+        string stageName;
+        if (!readString(stream, stageName) || !readString(stream, entry.sourceCode[stageName]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShaderCache::writeEntry(const string& key, const Entry& entry, GenContext& context) const
+{
+    StringSet dependencies;
+    for (size_t i = 0; i < entry.shader->numStages(); i++)
+    {
+        const ShaderStage& stage = entry.shader->getStage(i);
+        dependencies.insert(stage.getIncludes().begin(), stage.getIncludes().end());
+        dependencies.insert(stage.getSourceDependencies().begin(), stage.getSourceDependencies().end());
+    }
+
+    if (!_directory.exists())
+    {
+        _directory.createDirectory();
+    }
+
+    // Write to a temporary file and then rename it, so that other threads
+    // and processes never read a partially written entry.
+    FilePath filename = _directory / FilePath(key + "." + CACHE_FILE_EXTENSION);
+    std::ostringstream tempSuffix;
+    tempSuffix << ".tmp" << std::this_thread::get_id();
+    string tempFilename = filename.asString() + tempSuffix.str();
+    {
+        std::ofstream stream(tempFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            return;
+        }
+        stream << CACHE_FILE_HEADER << '\n';
+        writeString(stream, entry.description);
+        stream << dependencies.size() << '\n';
+        for (const string& dependency : dependencies)
+        {
+            writeString(stream, dependency);
+            writeString(stream, formatHash(hashString(context.readSourceFile(dependency))));
+        }
+        stream << entry.sourceCode.size() << '\n';
+        for (const auto& pair : entry.sourceCode)
+        {
+            writeString(stream, pair.first);
+            writeString(stream, pair.second);
+        }
+        if (!stream)
+        {
+            stream.close();
+            std::remove(tempFilename.c_str());
+            return;
+        }
+    }
+    if (std::rename(tempFilename.c_str(), filename.asString().c_str()))
+    {
+        // Renaming over an existing file is not supported on all platforms.
+        std::remove(filename.asString().c_str());
+        if (std::rename(tempFilename.c_str(), filename.asString().c_str()))
+        {
+            std::remove(tempFilename.c_str());
+        }
+    }
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,138 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_SHADERCACHE_H
+#define MATERIALX_SHADERCACHE_H
+
+/// @file
+/// Cache of generated shaders
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <MaterialXCore/Element.h>
+
+#include <atomic>
+#include <shared_mutex>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class ShaderCache;
+
+/// Shared pointer to a ShaderCache
+using ShaderCachePtr = shared_ptr<ShaderCache>;
+
+/// @class ShaderCache
+/// A thread-safe cache of generated shaders, keyed by a description of
+/// everything that contributes to the generated code.
+///
+/// The description of a shader includes the shader name, the target and
+/// options of the generation context, and the element along with its
+/// upstream graph: the categories, names and attributes of all connected
+/// elements, together with the nodedefs and implementations they resolve to.
+/// Definitions from the data library of the document are identified by name
+/// and a hash of their content, which keeps the description of library-based
+/// materials small.
+/// Because shader generators embed the default values of uniforms in the
+/// generated code, input values are part of the description as well.
+///
+/// User data attached to the generation context is not part of the
+/// description, with the exception of bound light shaders, and neither is
+/// the application variable handler.  Contexts that differ only in such
+/// state should use separate caches.
+///
+/// If a directory is given, the source code of generated shader stages is
+/// also written to disk, allowing it to be reused across sessions through
+/// generateSourceCode.  Entries read from disk are validated against the
+/// contents of the source code files they were generated from.
+class MX_GENSHADER_API ShaderCache
+{
+  public:
+    ShaderCache(const FilePath& directory = FilePath()) :
+        _directory(directory),
+        _hits(0),
+        _misses(0)
+    {
+    }
+    virtual ~ShaderCache() { }
+
+    /// Create a new shader cache, optionally backed by the given directory.
+    static ShaderCachePtr create(const FilePath& directory = FilePath())
+    {
+        return std::make_shared<ShaderCache>(directory);
+    }
+
+    /// Return the directory backing this cache, which is empty if the
+    /// cache is held in memory only.
+    const FilePath& getDirectory() const
+    {
+        return _directory;
+    }
+
+    /// Return the shader generated for the given element with the given
+    /// context, generating it only if no matching shader is cached.
+    /// Each call returns a separate shader, whose stages and variables may be
+    /// modified without affecting the cache.  The shader graph is shared with
+    /// the cached shader, and should not be modified.
+    ShaderPtr generate(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the source code of each stage of the shader generated for the
+    /// given element with the given context, keyed by stage name.  The source
+    /// code is read from the cache directory if a valid entry is found there,
+    /// and is otherwise taken from the shader returned by generate.
+    StringMap generateSourceCode(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the description from which the cache key of the shader for the
+    /// given element and context is computed.
+    static string getShaderDescription(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the cache key for the given shader description.
+    static string getShaderKey(const string& description);
+
+    /// Return the number of requests that were served from the cache.
+    size_t getHitCount() const
+    {
+        return _hits;
+    }
+
+    /// Return the number of requests that required shader generation.
+    size_t getMissCount() const
+    {
+        return _misses;
+    }
+
+    /// Remove all shaders held in memory.  Files in the cache directory
+    /// are left untouched.
+    void clear();
+
+  protected:
+    struct Entry
+    {
+        string description;
+        ShaderPtr shader;
+        StringMap sourceCode;
+    };
+
+    // Read the entry with the given key from the cache directory, returning
+    // false if no valid entry is found.
+    bool readEntry(const string& key, const string& description, GenContext& context, Entry& entry) const;
+
+    // Write an entry generated from the given shader to the cache directory.
+    void writeEntry(const string& key, const Entry& entry, GenContext& context) const;
+
+  protected:
+    FilePath _directory;
+    std::unordered_map<string, Entry> _entries;
+    std::atomic<size_t> _hits;
+    std::atomic<size_t> _misses;
+    mutable std::shared_mutex _mutex;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif // MATERIALX_SHADERCACHE_H
@@ -407,7 +407,7 @@ void ShaderGenerator::registerShaderMetadata(const DocumentPtr& doc, GenContext&
 void ShaderGenerator::replaceTokens(const StringMap& substitutions, ShaderStage& stage) const
 {
     // Replace tokens in source code
-    tokenSubstitution(substitutions, stage._code);
+    stage.substituteTokens(substitutions);
 
     // Replace tokens on shader interface
     for (size_t i = 0; i < stage._constants.size(); ++i)
@@ -27,6 +27,8 @@ MATERIALX_NAMESPACE_BEGIN
 /// All third-party shader generators should derive from this class.
 /// Derived classes should use DECLARE_SHADER_GENERATOR / DEFINE_SHADER_GENERATOR
 /// in their declaration / definition, and register with the Registry class.
+/// Generators hold no state that changes during generation, so one generator
+/// may be used by multiple threads, each generating with its own GenContext.
 class MX_GENSHADER_API ShaderGenerator
 {
   public:
@@ -141,6 +143,8 @@ class MX_GENSHADER_API ShaderGenerator
                                          bool assignValue = true) const;
 
     /// Return the closure contexts defined for the given node.
+    /// The returned contexts are shared by all generation calls, so callers
+    /// that set closure parameters should do so on a copy.
     virtual void getClosureContexts(const ShaderNode& node, vector<ClosureContext*>& cct) const;
 
     /// Return the result of an upstream connection or value for an input.
@@ -186,6 +190,8 @@ class MX_GENSHADER_API ShaderGenerator
     }
 
     /// Return the map of token substitutions used by the generator.
+    /// Substitutions that depend on generation options are set on the
+    /// GenContext at generation time.
     const StringMap& getTokenSubstitutions() const
     {
         return _tokenSubstitutions;
@@ -229,9 +235,10 @@ class MX_GENSHADER_API ShaderGenerator
     Factory<ShaderNodeImpl> _implFactory;
     ColorManagementSystemPtr _colorManagementSystem;
     UnitSystemPtr _unitSystem;
-    mutable StringMap _tokenSubstitutions;
+    StringMap _tokenSubstitutions;
 
     friend ShaderGraph;
+    friend class ShaderCache;
 };
 
 /// @class ExceptionShaderGenError
@@ -9,11 +9,185 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <queue>
 
 MATERIALX_NAMESPACE_BEGIN
 
+namespace
+{
+
+const string ADD = "add";
+const string SUBTRACT = "subtract";
+const string MULTIPLY = "multiply";
+const string DIVIDE = "divide";
+const string MIN = "min";
+const string MAX = "max";
+const string MIX = "mix";
+const string CONVERT = "convert";
+
+// Return true if the given type is a float, color or vector type.
+bool isFloatType(TypeDesc type)
+{
+    return type == Type::FLOAT ||
+           type == Type::COLOR3 || type == Type::COLOR4 ||
+           type == Type::VECTOR2 || type == Type::VECTOR3 || type == Type::VECTOR4;
+}
+
+template <class V> bool getVectorComponents(const ValuePtr& value, vector<float>& components)
+{
+    if (!value->isA<V>())
+    {
+        return false;
+    }
+    const V& vec = value->asA<V>();
+    components.assign(vec.begin(), vec.end());
+    return true;
+}
+
+// Return the components of a value of a float, color or vector type.
+bool getComponents(const ValuePtr& value, vector<float>& components)
+{
+    if (!value)
+    {
+        return false;
+    }
+    if (value->isA<float>())
+    {
+        components.assign(1, value->asA<float>());
+        return true;
+    }
+    return getVectorComponents<Color3>(value, components) ||
+           getVectorComponents<Color4>(value, components) ||
+           getVectorComponents<Vector2>(value, components) ||
+           getVectorComponents<Vector3>(value, components) ||
+           getVectorComponents<Vector4>(value, components);
+}
+
+// Create a value of a float, color or vector type from its components.
+ValuePtr createComponentValue(TypeDesc type, const vector<float>& components)
+{
+    if (type == Type::FLOAT)
+    {
+        return Value::createValue<float>(components[0]);
+    }
+    if (type == Type::COLOR3)
+    {
+        return Value::createValue<Color3>(Color3(components));
+    }
+    if (type == Type::COLOR4)
+    {
+        return Value::createValue<Color4>(Color4(components));
+    }
+    if (type == Type::VECTOR2)
+    {
+        return Value::createValue<Vector2>(Vector2(components));
+    }
+    if (type == Type::VECTOR3)
+    {
+        return Value::createValue<Vector3>(Vector3(components));
+    }
+    if (type == Type::VECTOR4)
+    {
+        return Value::createValue<Vector4>(Vector4(components));
+    }
+    return nullptr;
+}
+
+// Return the component of a value at the given index, broadcasting scalars.
+float getComponent(const vector<float>& components, size_t index)
+{
+    return components.size() == 1 ? components[0] : components[index];
+}
+
+// Return true if all components of a value equal the given scalar.
+bool hasAllComponents(const vector<float>& components, float scalar)
+{
+    return std::all_of(components.begin(), components.end(), [scalar](float c) { return c == scalar; });
+}
+
+// Return the components of the named input of a node, if it is a float,
+// color or vector input with a value that may be broadcast to the output.
+bool getInputComponents(const ShaderNode& node, const string& name, vector<float>& components)
+{
+    const ShaderInput* input = node.getInput(name);
+    if (!input || !isFloatType(input->getType()) || !getComponents(input->getValue(), components))
+    {
+        return false;
+    }
+    return components.size() == 1 || components.size() == node.getOutput()->getType().getSize();
+}
+
+// Evaluate a math node using the values of its inputs, returning false
+// if the node or its types are not supported.
+bool evaluateMathNode(const ShaderNode& node, vector<float>& result)
+{
+    const string& op = node.getNodeString();
+    const size_t size = node.getOutput()->getType().getSize();
+    result.resize(size);
+
+    vector<float> a, b, m;
+    if (op == ADD || op == SUBTRACT || op == MULTIPLY || op == DIVIDE || op == MIN || op == MAX)
+    {
+        if (node.numInputs() != 2 || !getInputComponents(node, "in1", a) || !getInputComponents(node, "in2", b))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            const float x = getComponent(a, i);
+            const float y = getComponent(b, i);
+            if (op == ADD)
+                result[i] = x + y;
+            else if (op == SUBTRACT)
+                result[i] = x - y;
+            else if (op == MULTIPLY)
+                result[i] = x * y;
+            else if (op == MIN)
+                result[i] = std::min(x, y);
+            else if (op == MAX)
+                result[i] = std::max(x, y);
+            else if (y != 0.0f)
+                result[i] = x / y;
+            else
+                return false;
+        }
+        return true;
+    }
+    if (op == MIX)
+    {
+        if (node.numInputs() != 3 || !getInputComponents(node, "fg", a) || !getInputComponents(node, "bg", b) || !getInputComponents(node, "mix", m))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            const float t = getComponent(m, i);
+            result[i] = getComponent(b, i) * (1.0f - t) + getComponent(a, i) * t;
+        }
+        return true;
+    }
+    if (op == CONVERT)
+    {
+        // Only conversions that broadcast a float or preserve the number of
+        // components are folded, since padding differs between conversions.
+        if (node.numInputs() != 1 || !getInputComponents(node, "in", a))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            result[i] = getComponent(a, i);
+        }
+        return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
 //
 // ShaderGraph methods
 //
@@ -801,7 +975,7 @@ void ShaderGraph::finalize(GenContext& context)
     _outputUnitTransformMap.clear();
 
     // Optimize the graph, removing redundant paths.
-    optimize();
+    optimize(context);
 
     // Sort the nodes in topological order.
     topologicalSort();
@@ -861,7 +1035,7 @@ void ShaderGraph::disconnect(ShaderNode* node) const
     }
 }
 
-void ShaderGraph::optimize()
+void ShaderGraph::optimize(GenContext& context)
 {
     size_t numEdits = 0;
     for (ShaderNode* node : getNodes())
@@ -886,6 +1060,11 @@ void ShaderGraph::optimize()
         // "uniform" in the NodeDef or to handle very specific cases, like FILENAME.
     }
 
+    if (context.getOptions().optimizeShaderGraph)
+    {
+        numEdits += simplifyNodes(context);
+    }
+
     if (numEdits > 0)
     {
         std::set<ShaderNode*> usedNodesSet;
@@ -927,11 +1106,188 @@ void ShaderGraph::optimize()
     }
 }
 
+size_t ShaderGraph::simplifyNodes(GenContext& context)
+{
+    // Inputs that are published as uniforms may be edited after generation,
+    // so only unpublished inputs with a value are treated as constant.
+    const bool publishInputs = context.getOptions().shaderInterfaceType == SHADER_INTERFACE_COMPLETE;
+    auto isPublished = [publishInputs](const ShaderNode* node, const ShaderInput* input)
+    {
+        return publishInputs && !input->getConnection() &&
+               !input->getType().isClosure() && node->isEditable(*input);
+    };
+    auto isConstant = [&isPublished](const ShaderNode* node, const ShaderInput* input)
+    {
+        return !input->getConnection() && input->getValue() && !isPublished(node, input);
+    };
+
+    // Visit upstream nodes first, so that downstream nodes see the results.
+    topologicalSort();
+
+    size_t numEdits = 0;
+    std::unordered_map<string, ShaderNode*> signatures;
+    const vector<ShaderNode*> nodes = _nodeOrder;
+    for (ShaderNode* node : nodes)
+    {
+        bool isUsed = false;
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            isUsed = isUsed || !output->getConnections().empty();
+        }
+        if (!isUsed)
+        {
+            continue;
+        }
+
+        bool allConstant = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            allConstant = allConstant && isConstant(node, input);
+        }
+
+        const string& op = node->getNodeString();
+        ShaderOutput* output = node->numOutputs() == 1 ? node->getOutput() : nullptr;
+        if (output && isFloatType(output->getType()))
+        {
+            // Fold math nodes whose inputs are all constant.
+            vector<float> result;
+            if (allConstant && evaluateMathNode(*node, result))
+            {
+                ValuePtr value = createComponentValue(output->getType(), result);
+                ShaderInputVec downstreamConnections = output->getConnections();
+                for (ShaderInput* downstream : downstreamConnections)
+                {
+                    output->breakConnection(downstream);
+                    downstream->setValue(value);
+                }
+                ++numEdits;
+                continue;
+            }
+
+            // Remove algebraic identities, passing through the remaining input.
+            ShaderInput* passThrough = nullptr;
+            auto hasConstant = [&isConstant, node](const string& name, float scalar)
+            {
+                const ShaderInput* input = node->getInput(name);
+                vector<float> components;
+                return input && isConstant(node, input) && isFloatType(input->getType()) &&
+                       getComponents(input->getValue(), components) && hasAllComponents(components, scalar);
+            };
+            if (op == MULTIPLY && node->numInputs() == 2)
+            {
+                passThrough = hasConstant("in2", 1.0f) ? node->getInput("in1") :
+                              hasConstant("in1", 1.0f) ? node->getInput("in2") : nullptr;
+            }
+            else if (op == ADD && node->numInputs() == 2)
+            {
+                passThrough = hasConstant("in2", 0.0f) ? node->getInput("in1") :
+                              hasConstant("in1", 0.0f) ? node->getInput("in2") : nullptr;
+            }
+            else if (op == DIVIDE && node->numInputs() == 2)
+            {
+                passThrough = hasConstant("in2", 1.0f) ? node->getInput("in1") : nullptr;
+            }
+            else if (op == SUBTRACT && node->numInputs() == 2)
+            {
+                passThrough = hasConstant("in2", 0.0f) ? node->getInput("in1") : nullptr;
+            }
+            else if (op == MIX && node->numInputs() == 3)
+            {
+                passThrough = hasConstant("mix", 0.0f) ? node->getInput("bg") :
+                              hasConstant("mix", 1.0f) ? node->getInput("fg") : nullptr;
+            }
+            else if (op == CONVERT && node->numInputs() == 1)
+            {
+                // A conversion back to the original type of a preceding
+                // conversion that kept all components is an identity.
+                ShaderOutput* upstream = node->getInput(0)->getConnection();
+                ShaderNode* upstreamNode = upstream ? upstream->getNode() : nullptr;
+                if (upstreamNode && upstreamNode != this &&
+                    upstreamNode->getNodeString() == CONVERT &&
+                    upstreamNode->numInputs() == 1 && upstreamNode->numOutputs() == 1)
+                {
+                    ShaderInput* source = upstreamNode->getInput(0);
+                    const size_t sourceSize = source->getType().getSize();
+                    if (source->getType() == output->getType() &&
+                        isFloatType(upstream->getType()) &&
+                        sourceSize > 1 && upstream->getType().getSize() >= sourceSize)
+                    {
+                        passThrough = source;
+                    }
+                }
+            }
+            if (passThrough && passThrough->getType() == output->getType())
+            {
+                bypass(passThrough, output);
+                ++numEdits;
+                continue;
+            }
+        }
+
+        // Merge nodes that match a previous node in implementation and inputs.
+        const uint32_t closureClassification = Classification::CLOSURE | Classification::SHADER | Classification::MATERIAL;
+        if ((node->getClassification() & closureClassification) != 0 || node->isAGraph())
+        {
+            continue;
+        }
+        // Format values with enough digits to distinguish any two floats.
+        ScopedFloatFormatting fmt(Value::FloatFormatDefault, std::numeric_limits<float>::max_digits10);
+        string signature = std::to_string(reinterpret_cast<uintptr_t>(&node->getImplementation()));
+        signature += ':' + std::to_string(node->getClassification());
+        bool isMergeable = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            signature += '|' + input->getName() + ':' + input->getType().getName() + ':' + input->getVariable() + ':';
+            if (input->getConnection())
+            {
+                signature += std::to_string(reinterpret_cast<uintptr_t>(input->getConnection()));
+            }
+            else if (!isPublished(node, input))
+            {
+                signature += input->getValueString() + ':' + input->getColorSpace() + ':' + input->getUnit();
+            }
+            else
+            {
+                isMergeable = false;
+                break;
+            }
+        }
+        for (const ShaderOutput* nodeOutput : node->getOutputs())
+        {
+            signature += '|' + nodeOutput->getName() + ':' + nodeOutput->getType().getName();
+        }
+        if (!isMergeable)
+        {
+            continue;
+        }
+        auto it = signatures.emplace(signature, node);
+        if (!it.second)
+        {
+            ShaderNode* original = it.first->second;
+            for (size_t i = 0; i < node->numOutputs(); i++)
+            {
+                ShaderOutput* duplicateOutput = node->getOutput(i);
+                ShaderInputVec downstreamConnections = duplicateOutput->getConnections();
+                for (ShaderInput* downstream : downstreamConnections)
+                {
+                    duplicateOutput->breakConnection(downstream);
+                    downstream->makeConnection(original->getOutput(i));
+                }
+            }
+            ++numEdits;
+        }
+    }
+
+    return numEdits;
+}
+
 void ShaderGraph::bypass(ShaderNode* node, size_t inputIndex, size_t outputIndex)
 {
-    ShaderInput* input = node->getInput(inputIndex);
-    ShaderOutput* output = node->getOutput(outputIndex);
+    bypass(node->getInput(inputIndex), node->getOutput(outputIndex));
+}
 
+void ShaderGraph::bypass(ShaderInput* input, ShaderOutput* output)
+{
     ShaderOutput* upstream = input->getConnection();
     if (upstream)
     {
@@ -159,13 +159,23 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     void finalize(GenContext& context);
 
     /// Optimize the graph, removing redundant paths.
-    void optimize();
+    void optimize(GenContext& context);
+
+    /// Fold math nodes with constant inputs, remove algebraic identities
+    /// and merge structurally identical nodes, visiting nodes in topological
+    /// order.  Returns the number of nodes that were made redundant.
+    size_t simplifyNodes(GenContext& context);
 
     /// Bypass a node for a particular input and output,
     /// effectively connecting the input's upstream connection
     /// with the output's downstream connections.
     void bypass(ShaderNode* node, size_t inputIndex, size_t outputIndex = 0);
 
+    /// Bypass an output using the given input, connecting the input's
+    /// upstream connection with the output's downstream connections,
+    /// or pushing the input's value downstream if it is unconnected.
+    void bypass(ShaderInput* input, ShaderOutput* output);
+
     /// For inputs and outputs in the graph set the variable names to be used
     /// in generated code. Making sure variable names are valid and unique
     /// to avoid name conflicts during shader generation.
@@ -7,6 +7,7 @@
 
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/ShaderStage.h>
 #include <MaterialXGenShader/Util.h>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -27,6 +28,15 @@ ShaderPort::ShaderPort(ShaderNode* node, TypeDesc type, const string& name, Valu
 {
 }
 
+void ShaderPort::setPath(const string& path)
+{
+    _path = path;
+    for (VariableBlock* block : _blocks)
+    {
+        block->invalidatePathIndex();
+    }
+}
+
 string ShaderPort::getFullName() const
 {
     return (_node->getName() + "_" + _name);
@@ -165,6 +175,7 @@ ShaderNode::ShaderNode(const ShaderGraph* parent, const string& name) :
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, const NodeDef& nodeDef, GenContext& context)
 {
     ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    newNode->_nodeString = nodeDef.getNodeString();
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
@@ -341,9 +352,10 @@ void ShaderNode::initialize(const Node& node, const NodeDef& nodeDef, GenContext
             if (!portValue)
             {
                 InputPtr interfaceInput = nodeInput->getInterfaceInput();
-                if (interfaceInput)
+                ConstValuePtr interfaceValue = interfaceInput ? interfaceInput->getValue() : nullptr;
+                if (interfaceValue)
                 {
-                    portValue = interfaceInput->getValue();
+                    portValue = interfaceValue->copy();
                 }
             }
             const string& valueString = portValue ? portValue->getValueString() : EMPTY_STRING;
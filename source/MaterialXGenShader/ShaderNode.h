@@ -24,6 +24,7 @@ class ShaderPort;
 class ShaderInput;
 class ShaderOutput;
 class ShaderGraph;
+class VariableBlock;
 
 /// Shared pointer to a ShaderPort
 using ShaderPortPtr = shared_ptr<class ShaderPort>;
@@ -193,7 +194,7 @@ class MX_GENSHADER_API ShaderPort : public std::enable_shared_from_this<ShaderPo
     const string& getGeomProp() const { return _geomprop; }
 
     /// Set the path to this port.
-    void setPath(const string& path) { _path = path; }
+    void setPath(const string& path);
 
     /// Return the path to this port.
     const string& getPath() const { return _path; }
@@ -256,6 +257,13 @@ class MX_GENSHADER_API ShaderPort : public std::enable_shared_from_this<ShaderPo
     string _geomprop;
     ShaderMetadataVecPtr _metadata;
     uint32_t _flags;
+
+  private:
+    friend class VariableBlock;
+
+    // Variable blocks holding this port, whose path indices are
+    // invalidated when the path of this port changes.
+    vector<VariableBlock*> _blocks;
 };
 
 /// @class ShaderInput
@@ -425,6 +433,13 @@ class MX_GENSHADER_API ShaderNode
         return _name;
     }
 
+    /// Return the node string of the nodedef this node was created from,
+    /// or an empty string if the node was created from an implementation.
+    const string& getNodeString() const
+    {
+        return _nodeString;
+    }
+
     /// Return the implementation used for this node.
     const ShaderNodeImpl& getImplementation() const
     {
@@ -490,6 +505,7 @@ class MX_GENSHADER_API ShaderNode
 
     const ShaderGraph* _parent;
     string _name;
+    string _nodeString;
     uint32_t _classification;
 
     std::unordered_map<string, ShaderInputPtr> _inputMap;
@@ -14,8 +14,68 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <algorithm>
+#include <cctype>
+
 MATERIALX_NAMESPACE_BEGIN
 
+namespace
+{
+
+const char TOKEN_PREFIX = '$';
+
+using BlockCopyMap = std::unordered_map<const VariableBlock*, VariableBlockPtr>;
+using PortCopyMap = std::unordered_map<const ShaderPort*, ShaderPortPtr>;
+
+// Return the copy of the given port, creating it on first use.
+ShaderPortPtr copyPort(ShaderPort* port, PortCopyMap& portCopies)
+{
+    ShaderPortPtr& copy = portCopies[port];
+    if (!copy)
+    {
+        copy = std::make_shared<ShaderPort>(port->getNode(), port->getType(), port->getName(), port->getValue());
+        copy->setPath(port->getPath());
+        copy->setSemantic(port->getSemantic());
+        copy->setVariable(port->getVariable());
+        copy->setUnit(port->getUnit());
+        copy->setColorSpace(port->getColorSpace());
+        copy->setGeomProp(port->getGeomProp());
+        copy->setMetadata(port->getMetadata());
+        copy->setFlags(port->getFlags());
+    }
+    return copy;
+}
+
+// Return a block holding copies of the variables of the given block.
+VariableBlock copyBlock(const VariableBlock& block, PortCopyMap& portCopies)
+{
+    VariableBlock copy(block.getName(), block.getInstance());
+    for (ShaderPort* port : block.getVariableOrder())
+    {
+        copy.add(copyPort(port, portCopies));
+    }
+    return copy;
+}
+
+// Return a map holding copies of the blocks of the given map, creating each
+// copy on first use.
+VariableBlockMap copyBlocks(const VariableBlockMap& blocks, BlockCopyMap& blockCopies, PortCopyMap& portCopies)
+{
+    VariableBlockMap copies;
+    for (const auto& it : blocks)
+    {
+        VariableBlockPtr& copy = blockCopies[it.second.get()];
+        if (!copy)
+        {
+            copy = std::make_shared<VariableBlock>(copyBlock(*it.second, portCopies));
+        }
+        copies[it.first] = copy;
+    }
+    return copies;
+}
+
+} // anonymous namespace
+
 namespace Stage
 {
 
@@ -27,6 +87,49 @@ const string PIXEL = "pixel";
 // VariableBlock methods
 //
 
+VariableBlock::VariableBlock(const VariableBlock& other) :
+    _name(other._name),
+    _instance(other._instance),
+    _variableMap(other._variableMap),
+    _variableOrder(other._variableOrder),
+    _pathIndexDirty(true)
+{
+    for (ShaderPort* port : _variableOrder)
+    {
+        registerPort(port);
+    }
+}
+
+VariableBlock& VariableBlock::operator=(const VariableBlock& other)
+{
+    if (this != &other)
+    {
+        for (ShaderPort* port : _variableOrder)
+        {
+            port->_blocks.erase(std::find(port->_blocks.begin(), port->_blocks.end(), this));
+        }
+        _name = other._name;
+        _instance = other._instance;
+        _variableMap = other._variableMap;
+        _variableOrder = other._variableOrder;
+        _pathIndex = PathIndex();
+        _pathIndexDirty = true;
+        for (ShaderPort* port : _variableOrder)
+        {
+            registerPort(port);
+        }
+    }
+    return *this;
+}
+
+VariableBlock::~VariableBlock()
+{
+    for (ShaderPort* port : _variableOrder)
+    {
+        port->_blocks.erase(std::find(port->_blocks.begin(), port->_blocks.end(), this));
+    }
+}
+
 ShaderPort* VariableBlock::operator[](const string& name)
 {
     ShaderPort* v = find(name);
@@ -65,6 +168,126 @@ ShaderPort* VariableBlock::find(const ShaderPortPredicate& predicate)
     return nullptr;
 }
 
+ShaderPort* VariableBlock::findByPath(const string& path)
+{
+    updatePathIndex();
+    return const_cast<ShaderPort*>(static_cast<const VariableBlock*>(this)->findByPath(path));
+}
+
+const ShaderPort* VariableBlock::findByPath(const string& path) const
+{
+    if (_pathIndexDirty)
+    {
+        for (const ShaderPort* port : _variableOrder)
+        {
+            if (port->getPath() == path)
+            {
+                return port;
+            }
+        }
+        return nullptr;
+    }
+
+    auto it = _pathIndex.byPath.find(path);
+    return it != _pathIndex.byPath.end() ? _variableOrder[it->second] : nullptr;
+}
+
+ShaderPort* VariableBlock::findByPathSuffix(const string& suffix)
+{
+    updatePathIndex();
+    return const_cast<ShaderPort*>(static_cast<const VariableBlock*>(this)->findByPathSuffix(suffix));
+}
+
+const ShaderPort* VariableBlock::findByPathSuffix(const string& suffix) const
+{
+    if (_pathIndexDirty)
+    {
+        for (const ShaderPort* port : _variableOrder)
+        {
+            if (stringEndsWith(port->getPath(), suffix))
+            {
+                return port;
+            }
+        }
+        return nullptr;
+    }
+
+    // Paths ending with the suffix are the reversed paths starting with the
+    // reversed suffix, which form a contiguous range of the sorted list.
+    const auto& reversedPaths = _pathIndex.reversedPaths;
+    const string reversedSuffix(suffix.rbegin(), suffix.rend());
+    auto first = std::lower_bound(reversedPaths.begin(), reversedPaths.end(), reversedSuffix,
+                                  [](const std::pair<string, size_t>& entry, const string& value)
+                                  {
+                                      return entry.first < value;
+                                  });
+    auto last = std::partition_point(first, reversedPaths.end(),
+                                     [&reversedSuffix](const std::pair<string, size_t>& entry)
+                                     {
+                                         return !entry.first.compare(0, reversedSuffix.size(), reversedSuffix);
+                                     });
+    if (first == last)
+    {
+        return nullptr;
+    }
+
+    // Return the earliest variable in the range, from two overlapping
+    // power-of-two ranges of the sparse table.
+    size_t begin = (size_t) (first - reversedPaths.begin());
+    size_t length = (size_t) (last - first);
+    size_t level = 0;
+    while (((size_t) 2 << level) <= length)
+    {
+        level++;
+    }
+    const vector<size_t>& minimum = _pathIndex.rangeMinimum[level];
+    size_t position = std::min(minimum[begin], minimum[begin + length - ((size_t) 1 << level)]);
+    return _variableOrder[position];
+}
+
+void VariableBlock::updatePathIndex()
+{
+    if (!_pathIndexDirty)
+    {
+        return;
+    }
+
+    PathIndex index;
+    for (size_t i = 0; i < _variableOrder.size(); i++)
+    {
+        const string& path = _variableOrder[i]->getPath();
+        index.byPath.emplace(path, i);
+        index.reversedPaths.emplace_back(string(path.rbegin(), path.rend()), i);
+    }
+    std::sort(index.reversedPaths.begin(), index.reversedPaths.end());
+
+    const size_t count = index.reversedPaths.size();
+    index.rangeMinimum.emplace_back();
+    for (const auto& entry : index.reversedPaths)
+    {
+        index.rangeMinimum[0].push_back(entry.second);
+    }
+    for (size_t level = 1; ((size_t) 1 << level) <= count; level++)
+    {
+        const vector<size_t>& previous = index.rangeMinimum[level - 1];
+        const size_t half = (size_t) 1 << (level - 1);
+        vector<size_t> current(count - ((size_t) 1 << level) + 1);
+        for (size_t i = 0; i < current.size(); i++)
+        {
+            current[i] = std::min(previous[i], previous[i + half]);
+        }
+        index.rangeMinimum.push_back(std::move(current));
+    }
+
+    _pathIndex = std::move(index);
+    _pathIndexDirty = false;
+}
+
+void VariableBlock::registerPort(ShaderPort* port)
+{
+    port->_blocks.push_back(this);
+}
+
 ShaderPort* VariableBlock::add(TypeDesc type, const string& name, ValuePtr value, bool shouldWiden)
 {
     auto it = _variableMap.find(name);
@@ -91,6 +314,8 @@ ShaderPort* VariableBlock::add(TypeDesc type, const string& name, ValuePtr value
     ShaderPortPtr port = std::make_shared<ShaderPort>(nullptr, type, name, value);
     _variableMap[name] = port;
     _variableOrder.push_back(port.get());
+    registerPort(port.get());
+    _pathIndexDirty = true;
 
     return port.get();
 }
@@ -101,6 +326,8 @@ void VariableBlock::add(ShaderPortPtr port)
     {
         _variableMap[port->getName()] = port;
         _variableOrder.push_back(port.get());
+        registerPort(port.get());
+        _pathIndexDirty = true;
     }
 }
 
@@ -116,6 +343,13 @@ ShaderStage::ShaderStage(const string& name, ConstSyntaxPtr syntax) :
 {
 }
 
+void ShaderStage::setSourceCode(const string& code)
+{
+    _code.clear();
+    _tokenPositions.clear();
+    appendCode(code);
+}
+
 VariableBlockPtr ShaderStage::createUniformBlock(const string& name, const string& instance)
 {
     auto it = _uniforms.find(name);
@@ -213,19 +447,23 @@ void ShaderStage::beginScope(Syntax::Punctuation punc)
     {
         case Syntax::CURLY_BRACKETS:
             beginLine();
-            _code += "{" + _syntax->getNewline();
+            appendCode("{");
+            appendCode(_syntax->getNewline());
             break;
         case Syntax::PARENTHESES:
             beginLine();
-            _code += "(" + _syntax->getNewline();
+            appendCode("(");
+            appendCode(_syntax->getNewline());
             break;
         case Syntax::SQUARE_BRACKETS:
             beginLine();
-            _code += "[" + _syntax->getNewline();
+            appendCode("[");
+            appendCode(_syntax->getNewline());
             break;
         case Syntax::DOUBLE_SQUARE_BRACKETS:
             beginLine();
-            _code += "[[" + _syntax->getNewline();
+            appendCode("[[");
+            appendCode(_syntax->getNewline());
             break;
     }
 
@@ -248,32 +486,32 @@ void ShaderStage::endScope(bool semicolon, bool newline)
     {
         case Syntax::CURLY_BRACKETS:
             beginLine();
-            _code += "}";
+            appendCode("}");
             break;
         case Syntax::PARENTHESES:
             beginLine();
-            _code += ")";
+            appendCode(")");
             break;
         case Syntax::SQUARE_BRACKETS:
             beginLine();
-            _code += "]";
+            appendCode("]");
             break;
         case Syntax::DOUBLE_SQUARE_BRACKETS:
             beginLine();
-            _code += "]]";
+            appendCode("]]");
             break;
     }
     if (semicolon)
-        _code += ";";
+        appendCode(";");
     if (newline)
-        _code += _syntax->getNewline();
+        appendCode(_syntax->getNewline());
 }
 
 void ShaderStage::beginLine()
 {
     for (int i = 0; i < _indentations; ++i)
     {
-        _code += _syntax->getIndentation();
+        appendCode(_syntax->getIndentation());
     }
 }
 
@@ -281,19 +519,118 @@ void ShaderStage::endLine(bool semicolon)
 {
     if (semicolon)
     {
-        _code += ";";
+        appendCode(";");
     }
     newLine();
 }
 
 void ShaderStage::newLine()
 {
-    _code += _syntax->getNewline();
+    appendCode(_syntax->getNewline());
 }
 
 void ShaderStage::addString(const string& str)
 {
-    _code += str;
+    appendCode(str);
+}
+
+void ShaderStage::appendCode(const string& code)
+{
+    size_t offset = _code.size();
+    _code += code;
+    for (size_t pos = code.find(TOKEN_PREFIX); pos != string::npos; pos = code.find(TOKEN_PREFIX, pos + 1))
+    {
+        _tokenPositions.push_back(offset + pos);
+    }
+}
+
+void ShaderStage::substituteTokens(const StringMap& substitutions)
+{
+    struct Substitution
+    {
+        size_t pos;
+        size_t length;
+        const string* value;
+    };
+
+    // Look up the substitution for each recorded token, computing
+    // the final size of the source code.
+    vector<Substitution> found;
+    size_t size = _code.size();
+    string token;
+    for (size_t pos : _tokenPositions)
+    {
+        // As in tokenSubstitution, a prefix at the end of the code is not a token.
+        if (pos + 1 >= _code.size())
+        {
+            break;
+        }
+        size_t end = pos + 1;
+        while (end < _code.size() && std::isalnum((unsigned char) _code[end]))
+        {
+            end++;
+        }
+        token.assign(_code, pos, end - pos);
+        auto it = substitutions.find(token);
+        if (it != substitutions.end())
+        {
+            found.push_back({ pos, end - pos, &it->second });
+            size = size - (end - pos) + it->second.size();
+        }
+    }
+    if (found.empty())
+    {
+        return;
+    }
+
+    // Build the substituted code in a single pass, recording the positions
+    // of any tokens remaining in the result.
+    string result;
+    result.reserve(size);
+    vector<size_t> tokenPositions;
+    size_t last = 0;
+    auto next = found.begin();
+    for (size_t pos : _tokenPositions)
+    {
+        if (next != found.end() && next->pos == pos)
+        {
+            result.append(_code, last, pos - last);
+            for (size_t i = next->value->find(TOKEN_PREFIX); i != string::npos; i = next->value->find(TOKEN_PREFIX, i + 1))
+            {
+                tokenPositions.push_back(result.size() + i);
+            }
+            result += *next->value;
+            last = pos + next->length;
+            ++next;
+        }
+        else
+        {
+            tokenPositions.push_back(result.size() + pos - last);
+        }
+    }
+    result.append(_code, last, string::npos);
+
+    _code.swap(result);
+    _tokenPositions.swap(tokenPositions);
+}
+
+void ShaderStage::copyFrom(const ShaderStage& other,
+                           std::unordered_map<const VariableBlock*, VariableBlockPtr>& blockCopies,
+                           std::unordered_map<const ShaderPort*, ShaderPortPtr>& portCopies)
+{
+    _functionName = other._functionName;
+    _syntax = other._syntax;
+    _indentations = other._indentations;
+    _scopes = other._scopes;
+    _includes = other._includes;
+    _sourceDependencies = other._sourceDependencies;
+    _definedFunctions = other._definedFunctions;
+    _constants = copyBlock(other._constants, portCopies);
+    _uniforms = copyBlocks(other._uniforms, blockCopies, portCopies);
+    _inputs = copyBlocks(other._inputs, blockCopies, portCopies);
+    _outputs = copyBlocks(other._outputs, blockCopies, portCopies);
+    _code = other._code;
+    _tokenPositions = other._tokenPositions;
 }
 
 void ShaderStage::addLine(const string& str, bool semicolon)
@@ -306,7 +643,8 @@ void ShaderStage::addLine(const string& str, bool semicolon)
 void ShaderStage::addComment(const string& str)
 {
     beginLine();
-    _code += _syntax->getSingleLineComment() + str;
+    appendCode(_syntax->getSingleLineComment());
+    appendCode(str);
     endLine(false);
 }
 
@@ -344,12 +682,12 @@ void ShaderStage::addBlock(const string& str, const FilePath& sourceFilename, Ge
 void ShaderStage::addInclude(const FilePath& includeFilename, const FilePath& sourceFilename, GenContext& context)
 {
     string modifiedFile = includeFilename;
-    tokenSubstitution(context.getShaderGenerator().getTokenSubstitutions(), modifiedFile);
+    tokenSubstitution(context.getTokenSubstitutions(), modifiedFile);
     FilePath resolvedFile = context.resolveSourceFile(modifiedFile, sourceFilename.getParentPath());
 
     if (!_includes.count(resolvedFile))
     {
-        string content = readFile(resolvedFile);
+        string content = context.readSourceFile(resolvedFile);
         if (content.empty())
         {
             throw ExceptionShaderGenError("Could not find include file: '" + includeFilename.asString() + "'");
@@ -62,9 +62,13 @@ class MX_GENSHADER_API VariableBlock
   public:
     VariableBlock(const string& name, const string& instance) :
         _name(name),
-        _instance(instance)
+        _instance(instance),
+        _pathIndexDirty(true)
     {
     }
+    VariableBlock(const VariableBlock& other);
+    VariableBlock& operator=(const VariableBlock& other);
+    ~VariableBlock();
 
     /// Get the name of this block.
     const string& getName() const { return _name; }
@@ -112,6 +116,34 @@ class MX_GENSHADER_API VariableBlock
     /// Find a port based on a predicate
     ShaderPort* find(const ShaderPortPredicate& predicate);
 
+    /// Return the first variable, in variable order, with the given element
+    /// path.  Returns nullptr if no variable has the given path.
+    ShaderPort* findByPath(const string& path);
+
+    /// Return the first variable, in variable order, with the given element
+    /// path.  Returns nullptr if no variable has the given path.
+    const ShaderPort* findByPath(const string& path) const;
+
+    /// Return the first variable, in variable order, whose element path ends
+    /// with the given suffix.  Returns nullptr if no variable matches.
+    ///
+    /// Lookups use an index of variable paths, which is invalidated when
+    /// variables are added to this block or the paths of its variables are
+    /// changed, and is rebuilt by the next lookup through a non-const block.
+    /// Lookups with a valid index run in logarithmic time.
+    ShaderPort* findByPathSuffix(const string& suffix);
+
+    /// Return the first variable, in variable order, whose element path ends
+    /// with the given suffix.  Returns nullptr if no variable matches.
+    ///
+    /// The path index is never modified through a const block, so lookups
+    /// may run concurrently, and fall back to a linear scan of the variables
+    /// while the index is invalid.
+    const ShaderPort* findByPathSuffix(const string& suffix) const;
+
+    /// Bring the path index up to date with the current variables and paths.
+    void updatePathIndex();
+
     /// Add a new shader port to this block.
     /// @param type The desired shader port type
     /// @param name The shader port name
@@ -126,10 +158,36 @@ class MX_GENSHADER_API VariableBlock
     void add(ShaderPortPtr port);
 
   private:
+    friend class ShaderPort;
+
+    // Mark the path index as out of date.
+    void invalidatePathIndex() { _pathIndexDirty = true; }
+
+    // Register this block with the given port, so that changes to the path
+    // of the port invalidate the path index.
+    void registerPort(ShaderPort* port);
+
+    // Index of variables by element path, built on demand.
+    struct PathIndex
+    {
+        // First variable order position for each distinct path.
+        std::unordered_map<string, size_t> byPath;
+
+        // Reversed paths in sorted order, so that paths sharing a suffix form
+        // a contiguous range, with their variable order positions.
+        vector<std::pair<string, size_t>> reversedPaths;
+
+        // Sparse table of minimum variable order positions over ranges of
+        // reversedPaths, with level k covering ranges of length 2^k.
+        vector<vector<size_t>> rangeMinimum;
+    };
+
     string _name;
     string _instance;
     std::unordered_map<string, ShaderPortPtr> _variableMap;
     vector<ShaderPort*> _variableOrder;
+    PathIndex _pathIndex;
+    bool _pathIndexDirty;
 };
 
 /// @class ShaderStage
@@ -158,7 +216,7 @@ class MX_GENSHADER_API ShaderStage
     const string& getFunctionName() const { return _functionName; }
 
     /// Set the stage source code.
-    void setSourceCode(const string& code) { _code = code; }
+    void setSourceCode(const string& code);
 
     /// Return the stage source code.
     const string& getSourceCode() const { return _code; }
@@ -268,7 +326,7 @@ class MX_GENSHADER_API ShaderStage
     {
         StringStream str;
         str << value;
-        _code += str.str();
+        appendCode(str.str());
     }
 
     /// Add the function definition for a node's implementation.
@@ -289,6 +347,22 @@ class MX_GENSHADER_API ShaderStage
         _functionName = functionName;
     }
 
+  private:
+    /// Append code to the stage, recording the positions of any tokens.
+    void appendCode(const string& code);
+
+    /// Replace the recorded tokens according to the given substitutions map,
+    /// building the resulting source code in a single pass.
+    void substituteTokens(const StringMap& substitutions);
+
+    /// Copy the state of the given stage into this stage, giving this stage
+    /// copies of its variable blocks and variables.  The given stage is not
+    /// modified.  Blocks and variables shared between stages are copied only
+    /// once, using the given maps from originals to copies.
+    void copyFrom(const ShaderStage& other,
+                  std::unordered_map<const VariableBlock*, VariableBlockPtr>& blockCopies,
+                  std::unordered_map<const ShaderPort*, ShaderPortPtr>& portCopies);
+
   private:
     /// Name of the stage
     const string _name;
@@ -329,7 +403,11 @@ class MX_GENSHADER_API ShaderStage
     /// Resulting source code for this stage.
     string _code;
 
+    /// Positions of token prefixes in the source code.
+    vector<size_t> _tokenPositions;
+
     friend class ShaderGenerator;
+    friend class Shader;
 };
 
 /// Shared pointer to a ShaderStage
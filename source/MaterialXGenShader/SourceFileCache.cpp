@@ -0,0 +1,158 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXGenShader/SourceFileCache.h>
+
+#include <MaterialXFormat/Util.h>
+
+#include <mutex>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+// Return the modification time and size of the given file, or false
+// if the file cannot be found.
+bool getFileStamp(const FilePath& filename, int64_t& modifiedTime, int64_t& fileSize)
+{
+#if defined(_WIN32)
+    struct _stat64 sb;
+    if (_stat64(filename.asString().c_str(), &sb))
+    {
+        return false;
+    }
+#else
+    struct stat sb;
+    if (stat(filename.asString().c_str(), &sb))
+    {
+        return false;
+    }
+#endif
+    modifiedTime = (int64_t) sb.st_mtime;
+    fileSize = (int64_t) sb.st_size;
+    return true;
+}
+
+} // anonymous namespace
+
+//
+// SourceFileCache methods
+//
+
+SourceFileCachePtr SourceFileCache::getDefault()
+{
+    static SourceFileCachePtr cache = create();
+    return cache;
+}
+
+string SourceFileCache::readFile(const FilePath& filename)
+{
+    const string& key = filename.asString();
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end() && it->second.added)
+        {
+            return it->second.contents;
+        }
+    }
+
+    int64_t modifiedTime = 0;
+    int64_t fileSize = 0;
+    if (!getFileStamp(filename, modifiedTime, fileSize))
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end())
+        {
+            if (it->second.added)
+            {
+                return it->second.contents;
+            }
+            _entries.erase(it);
+        }
+        return EMPTY_STRING;
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end() &&
+            it->second.modifiedTime == modifiedTime &&
+            it->second.fileSize == fileSize)
+        {
+            return it->second.contents;
+        }
+    }
+
+    // Read the file outside of the lock, allowing other files to be
+    // read concurrently.
+    Entry entry;
+    entry.contents = MaterialX::readFile(filename);
+    entry.modifiedTime = modifiedTime;
+    entry.fileSize = fileSize;
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    auto it = _entries.find(key);
+    if (it != _entries.end() && it->second.added)
+    {
+        return it->second.contents;
+    }
+    Entry& stored = _entries[key];
+    stored = std::move(entry);
+    return stored.contents;
+}
+
+void SourceFileCache::addFile(const FilePath& filename, const string& contents)
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    Entry& entry = _entries[filename.asString()];
+    if (!entry.added)
+    {
+        entry.added = true;
+        _addedCount++;
+    }
+    entry.contents = contents;
+}
+
+bool SourceFileCache::hasAddedFile(const FilePath& filename) const
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    auto it = _entries.find(filename.asString());
+    return it != _entries.end() && it->second.added;
+}
+
+bool SourceFileCache::hasAddedFiles() const
+{
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _addedCount > 0;
+}
+
+void SourceFileCache::removeFile(const FilePath& filename)
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    auto it = _entries.find(filename.asString());
+    if (it != _entries.end())
+    {
+        if (it->second.added)
+        {
+            _addedCount--;
+        }
+        _entries.erase(it);
+    }
+}
+
+void SourceFileCache::clear()
+{
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _entries.clear();
+    _addedCount = 0;
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,85 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_SOURCEFILECACHE_H
+#define MATERIALX_SOURCEFILECACHE_H
+
+/// @file
+/// Cache of source code files for shader generation
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <shared_mutex>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class SourceFileCache;
+
+/// Shared pointer to a SourceFileCache
+using SourceFileCachePtr = shared_ptr<SourceFileCache>;
+
+/// @class SourceFileCache
+/// A thread-safe cache of source code files, keyed by resolved file path.
+///
+/// Files read from disk are cached along with their modification time and
+/// size, and are read again when either of these changes.  Files may also be
+/// added to the cache directly, for example from an archive embedded in the
+/// application, in which case they are never read from disk.
+class MX_GENSHADER_API SourceFileCache
+{
+  public:
+    SourceFileCache() { }
+    virtual ~SourceFileCache() { }
+
+    /// Create a new source file cache.
+    static SourceFileCachePtr create()
+    {
+        return std::make_shared<SourceFileCache>();
+    }
+
+    /// Return the process-wide source file cache, which is used by default
+    /// by all generation contexts.
+    static SourceFileCachePtr getDefault();
+
+    /// Return the contents of the given file, reading it from disk only if
+    /// it is not yet cached or has been modified since it was cached.
+    /// Returns an empty string if the file cannot be read.
+    string readFile(const FilePath& filename);
+
+    /// Add the contents of a file to the cache.  The given filename should
+    /// match the resolved path by which the file will be requested.
+    void addFile(const FilePath& filename, const string& contents);
+
+    /// Return true if the given file has been added to the cache with addFile.
+    bool hasAddedFile(const FilePath& filename) const;
+
+    /// Return true if any files have been added to the cache with addFile.
+    bool hasAddedFiles() const;
+
+    /// Remove the given file from the cache.
+    void removeFile(const FilePath& filename);
+
+    /// Remove all files from the cache.
+    void clear();
+
+  protected:
+    struct Entry
+    {
+        string contents;
+        int64_t modifiedTime = 0;
+        int64_t fileSize = 0;
+        bool added = false;
+    };
+
+    std::unordered_map<string, Entry> _entries;
+    size_t _addedCount = 0;
+    mutable std::shared_mutex _mutex;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif // MATERIALX_SOURCEFILECACHE_H
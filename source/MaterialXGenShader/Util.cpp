@@ -31,7 +31,7 @@ bool isEqual(float v1, float v2)
     return std::abs(v1 - v2) < EPSILON;
 }
 
-bool isEqual(ValuePtr value, float f)
+bool isEqual(ConstValuePtr value, float f)
 {
     if (value->isA<float>() && isEqual(value->asA<float>(), f))
     {
@@ -82,7 +82,7 @@ bool hasTransparentInputs(const OpaqueTestPairList& opaqueInputList, NodePtr nod
             {
                 return true;
             }
-            ValuePtr value = interfaceInput->getValue();
+            ConstValuePtr value = interfaceInput->getValue();
             if (value && !isEqual(value, opaqueInput.second))
             {
                 return true;
@@ -177,7 +177,7 @@ bool isTransparentShaderNode(NodePtr node, NodePtr interfaceNode)
             }
             else
             {
-                ValuePtr value = checkInput->getValue();
+                ConstValuePtr value = checkInput->getValue();
                 if (value && !isEqual(value, inputPair.second))
                 {
                     return true;
@@ -446,30 +446,39 @@ const char TOKEN_PREFIX = '$';
 
 void tokenSubstitution(const StringMap& substitutions, string& source)
 {
+    size_t pos = source.find(TOKEN_PREFIX);
+    if (pos == string::npos)
+    {
+        return;
+    }
+
     string buffer;
-    size_t pos = 0, len = source.length();
+    buffer.reserve(source.length());
+    buffer.append(source, 0, pos);
+    string token;
+    size_t len = source.length();
     while (pos < len)
     {
-        size_t p1 = source.find_first_of(TOKEN_PREFIX, pos);
+        size_t p1 = source.find(TOKEN_PREFIX, pos);
         if (p1 != string::npos && p1 + 1 < len)
         {
-            buffer += source.substr(pos, p1 - pos);
+            buffer.append(source, pos, p1 - pos);
             pos = p1 + 1;
-            string token = { TOKEN_PREFIX };
-            while (pos < len && isalnum(source[pos]))
+            while (pos < len && isalnum((unsigned char) source[pos]))
             {
-                token += source[pos++];
+                pos++;
             }
+            token.assign(source, p1, pos - p1);
             auto it = substitutions.find(token);
             buffer += (it != substitutions.end() ? it->second : token);
         }
         else
         {
-            buffer += source.substr(pos);
+            buffer.append(source, pos, string::npos);
             break;
         }
     }
-    source = buffer;
+    source.swap(buffer);
 }
 
 vector<Vector2> getUdimCoordinates(const StringVec& udimIdentifiers)
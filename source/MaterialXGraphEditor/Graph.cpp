@@ -869,7 +869,7 @@ void Graph::setRenderMaterial(UiNodePtr node)
     }
 }
 
-void Graph::updateMaterials(mx::InputPtr input /* = nullptr */, mx::ValuePtr value /* = nullptr */)
+void Graph::updateMaterials(mx::InputPtr input /* = nullptr */, mx::ConstValuePtr value /* = nullptr */)
 {
     std::string renderablePath;
     if (_currRenderNode)
@@ -906,7 +906,7 @@ void Graph::updateMaterials(mx::InputPtr input /* = nullptr */, mx::ValuePtr val
             // Note that if there is a topogical change due to
             // this value change or a transparency change, then
             // this is not currently caught here.
-            _renderer->getMaterials()[0]->modifyUniform(name, value);
+            _renderer->getMaterials()[0]->modifyUniform(name, value ? value->copy() : nullptr);
         }
     }
 }
@@ -921,7 +921,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     // If input is a float set the float slider UI to the value
     if (input->getType() == "float")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
 
         if (val && val->isA<float>())
         {
@@ -943,7 +943,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "integer")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<int>())
         {
             int prev = val->asA<int>(), temp = val->asA<int>();
@@ -963,7 +963,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "color3")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<mx::Color3>())
         {
             mx::Color3 prev = val->asA<mx::Color3>(), temp = val->asA<mx::Color3>();
@@ -987,7 +987,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "color4")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<mx::Color4>())
         {
             mx::Color4 prev = val->asA<mx::Color4>(), temp = val->asA<mx::Color4>();
@@ -1013,7 +1013,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "vector2")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<mx::Vector2>())
         {
             mx::Vector2 prev = val->asA<mx::Vector2>(), temp = val->asA<mx::Vector2>();
@@ -1033,7 +1033,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "vector3")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<mx::Vector3>())
         {
             mx::Vector3 prev = val->asA<mx::Vector3>(), temp = val->asA<mx::Vector3>();
@@ -1053,7 +1053,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "vector4")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<mx::Vector4>())
         {
             mx::Vector4 prev = val->asA<mx::Vector4>(), temp = val->asA<mx::Vector4>();
@@ -1073,7 +1073,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "string")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<std::string>())
         {
             std::string prev = val->asA<std::string>(), temp = val->asA<std::string>();
@@ -1090,7 +1090,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "filename")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
 
         if (val && val->isA<std::string>())
         {
@@ -1139,7 +1139,7 @@ void Graph::setConstant(UiNodePtr node, mx::InputPtr& input, const mx::UIPropert
     }
     else if (input->getType() == "boolean")
     {
-        mx::ValuePtr val = input->getValue();
+        mx::ConstValuePtr val = input->getValue();
         if (val && val->isA<bool>())
         {
             bool prev = val->asA<bool>(), temp = val->asA<bool>();
@@ -2765,7 +2765,7 @@ void Graph::deleteLinkInfo(int startAttr, int endAttr)
             if ((int) pin->_pinId.Get() == endAttr)
             {
                 removeEdge(downNode, upNode, pin);
-                mx::ValuePtr val = nodeDef->getActiveInput(pin->_input->getName())->getValue();
+                mx::ConstValuePtr val = nodeDef->getActiveInput(pin->_input->getName())->getValue();
                 if (_graphNodes[downNode]->getNode()->getType() == mx::SURFACE_SHADER_TYPE_STRING && _graphNodes[upNode]->getNodeGraph())
                 {
                     pin->_input->setConnectedOutput(nullptr);
@@ -2891,7 +2891,7 @@ void Graph::deleteNode(UiNodePtr node)
         // Update downNode info
         for (UiPinPtr pin : outputPin.get()->getConnections())
         {
-            mx::ValuePtr val;
+            mx::ConstValuePtr val;
             if (pin->_pinNode->getNode())
             {
                 mx::NodeDefPtr nodeDef = pin->_pinNode->getNode()->getNodeDef(pin->_pinNode->getNode()->getName());
@@ -3319,7 +3319,7 @@ void Graph::propertyEditor()
                                 if (input->getInterfaceInput() == _currUiNode->getInput())
                                 {
                                     _currUiNode->getInput()->setName(name);
-                                    mx::ValuePtr val = _currUiNode->getInput()->getValue();
+                                    mx::ConstValuePtr val = _currUiNode->getInput()->getValue();
                                     input->setInterfaceName(name);
                                     mx::InputPtr pt = input->getInterfaceInput();
                                 }
@@ -213,7 +213,7 @@ class Graph
     // Compiling shaders message
     void shaderPopup();
 
-    void updateMaterials(mx::InputPtr input = nullptr, mx::ValuePtr value = nullptr);
+    void updateMaterials(mx::InputPtr input = nullptr, mx::ConstValuePtr value = nullptr);
 
     // Allow for camera manipulation of render view window
     void handleRenderViewInputs();
@@ -89,7 +89,7 @@ void applyModifiers(mx::DocumentPtr doc, const DocumentModifiers& modifiers)
         if (node && node->getCategory() == "texcoord")
         {
             mx::InputPtr index = node->getInput("index");
-            mx::ValuePtr value = index ? index->getValue() : nullptr;
+            mx::ConstValuePtr value = index ? index->getValue() : nullptr;
             if (value && value->isA<int>() && value->asA<int>() != 0)
             {
                 index->setValue(0);
@@ -411,7 +411,7 @@ void RenderView::updateMaterials(mx::TypedElementPtr typedElem)
         applyDirectLights(_document);
 
         // Check for any udim set.
-        mx::ValuePtr udimSetValue = _document->getGeomPropValue(mx::UDIM_SET_PROPERTY);
+        mx::ConstValuePtr udimSetValue = _document->getGeomPropValue(mx::UDIM_SET_PROPERTY);
 
         // Skip material nodes without upstream shaders.
         mx::NodePtr node = typedElem ? typedElem->asA<mx::Node>() : nullptr;
@@ -905,7 +905,7 @@ void RenderView::updateCameras()
         float r = (sphereCenter - _geometryHandler->getMinimumBounds()).getMagnitude();
         _shadowCamera->setWorldMatrix(meshRotation * mx::Matrix44::createTranslation(-sphereCenter));
         _shadowCamera->setProjectionMatrix(mx::Camera::createOrthographicMatrix(-r, r, -r, r, 0.0f, r * 2.0f));
-        mx::ValuePtr value = dirLight->getInputValue("direction");
+        mx::ConstValuePtr value = dirLight->getInputValue("direction");
         if (value->isA<mx::Vector3>())
         {
             mx::Vector3 dir = mx::Matrix44::createRotationY(_lightRotation / 180.0f * PI).transformVector(value->asA<mx::Vector3>());
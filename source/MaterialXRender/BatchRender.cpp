@@ -0,0 +1,385 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXRender/BatchRender.h>
+
+#include <MaterialXRender/ShaderRenderer.h>
+
+#include <MaterialXCore/Util.h>
+#include <MaterialXCore/Value.h>
+
+#include <algorithm>
+#include <sstream>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+const string COMMENT_PREFIX = "#";
+const string GENERATED_SHADER = "generated";
+
+// Split a line into its leading token and the remainder, without surrounding spaces.
+void splitToken(const string& line, string& token, string& remainder)
+{
+    const string WHITESPACE = " \t";
+    size_t tokenEnd = line.find_first_of(WHITESPACE);
+    token = line.substr(0, tokenEnd);
+    remainder = tokenEnd != string::npos ? trimSpaces(line.substr(tokenEnd)) : EMPTY_STRING;
+}
+
+} // anonymous namespace
+
+//
+// BatchJobReader methods
+//
+
+BatchJobReader::BatchJobReader(std::istream& stream, const BatchJob& defaults) :
+    _stream(stream),
+    _state(defaults),
+    _lineNumber(0),
+    _jobCount(0)
+{
+    _state.uniformPaths.clear();
+    _state.uniformValues.clear();
+    _state.outputFilename = FilePath();
+}
+
+bool BatchJobReader::readJob(BatchJob& job)
+{
+    string line;
+    while (std::getline(_stream, line))
+    {
+        _lineNumber++;
+        line = trimSpaces(line);
+        if (line.empty() || stringStartsWith(line, COMMENT_PREFIX))
+        {
+            continue;
+        }
+
+        string command, arguments;
+        splitToken(line, command, arguments);
+        const string errorPrefix = "Batch job line " + std::to_string(_lineNumber) + ": ";
+
+        if (command == "material")
+        {
+            if (arguments.empty())
+            {
+                throw ExceptionRenderError(errorPrefix + "Expected a material filename");
+            }
+            _state.materialFilename = arguments;
+        }
+        else if (command == "shader")
+        {
+            std::istringstream tokens(arguments);
+            string vertexShader, pixelShader, extra;
+            tokens >> vertexShader >> pixelShader >> extra;
+            if (vertexShader == GENERATED_SHADER && pixelShader.empty())
+            {
+                _state.vertexShaderFilename = FilePath();
+                _state.pixelShaderFilename = FilePath();
+            }
+            else if (!pixelShader.empty() && extra.empty())
+            {
+                _state.vertexShaderFilename = vertexShader;
+                _state.pixelShaderFilename = pixelShader;
+            }
+            else
+            {
+                throw ExceptionRenderError(errorPrefix + "Expected vertex and pixel shader filenames");
+            }
+        }
+        else if (command == "uniform")
+        {
+            string path, value;
+            splitToken(arguments, path, value);
+            if (path.empty() || value.empty())
+            {
+                throw ExceptionRenderError(errorPrefix + "Expected a uniform path and value");
+            }
+            auto it = std::find(_state.uniformPaths.begin(), _state.uniformPaths.end(), path);
+            if (it != _state.uniformPaths.end())
+            {
+                _state.uniformValues[it - _state.uniformPaths.begin()] = value;
+            }
+            else
+            {
+                _state.uniformPaths.push_back(path);
+                _state.uniformValues.push_back(value);
+            }
+        }
+        else if (command == "camera")
+        {
+            std::istringstream tokens(arguments);
+            string position, target, angle, extra;
+            tokens >> position >> target >> angle >> extra;
+            if (target.empty() || !extra.empty())
+            {
+                throw ExceptionRenderError(errorPrefix + "Expected a camera position, target, and optional view angle");
+            }
+            try
+            {
+                _state.cameraPosition = fromValueString<Vector3>(position);
+                _state.cameraTarget = fromValueString<Vector3>(target);
+                if (!angle.empty())
+                {
+                    _state.cameraViewAngle = fromValueString<float>(angle);
+                }
+            }
+            catch (ExceptionTypeError& e)
+            {
+                throw ExceptionRenderError(errorPrefix + e.what());
+            }
+        }
+        else if (command == "resolution")
+        {
+            std::istringstream tokens(arguments);
+            string width, height, extra;
+            tokens >> width >> height >> extra;
+            int widthValue = 0, heightValue = 0;
+            try
+            {
+                widthValue = !width.empty() ? fromValueString<int>(width) : 0;
+                heightValue = !height.empty() ? fromValueString<int>(height) : 0;
+            }
+            catch (ExceptionTypeError&)
+            {
+            }
+            if (widthValue <= 0 || heightValue <= 0 || !extra.empty())
+            {
+                throw ExceptionRenderError(errorPrefix + "Expected a positive width and height");
+            }
+            _state.width = (unsigned int) widthValue;
+            _state.height = (unsigned int) heightValue;
+        }
+        else if (command == "render")
+        {
+            if (_state.materialFilename.isEmpty())
+            {
+                throw ExceptionRenderError(errorPrefix + "No material was specified before rendering");
+            }
+            job = _state;
+            job.index = _jobCount++;
+            job.line = _lineNumber;
+            job.outputFilename = arguments;
+
+            // Uniform overrides only apply to the submitted job.
+            _state.uniformPaths.clear();
+            _state.uniformValues.clear();
+            return true;
+        }
+        else
+        {
+            throw ExceptionRenderError(errorPrefix + "Unknown command: " + command);
+        }
+    }
+    return false;
+}
+
+//
+// BatchImageWriter methods
+//
+
+void BatchImageWriter::write(const BatchJob& job, ConstImagePtr image)
+{
+    if (job.outputFilename.isEmpty())
+    {
+        throw ExceptionRenderError("No output filename for batch job " + std::to_string(job.index));
+    }
+    if (!_imageHandler->saveImage(job.outputFilename, image, true))
+    {
+        throw ExceptionRenderError("Failed to write frame to " + job.outputFilename.asString());
+    }
+}
+
+//
+// BatchStreamWriter methods
+//
+
+const uint32_t BatchStreamWriter::FRAME_MAGIC = 0x4642584d; // "MXBF"
+
+void BatchStreamWriter::write(const BatchJob& job, ConstImagePtr image)
+{
+    FrameHeader header = {};
+    header.magic = FRAME_MAGIC;
+    header.width = image->getWidth();
+    header.height = image->getHeight();
+    header.channels = image->getChannelCount();
+    header.baseType = (uint32_t) image->getBaseType();
+    header.jobIndex = job.index;
+    header.byteSize = (uint64_t) image->getRowStride() * image->getHeight();
+
+    _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _stream.write(static_cast<const char*>(image->getResourceBuffer()), (std::streamsize) header.byteSize);
+    if (!_stream)
+    {
+        throw ExceptionRenderError("Failed to write frame of batch job " + std::to_string(job.index) + " to stream");
+    }
+}
+
+bool BatchStreamWriter::readFrame(std::istream& stream, FrameHeader& header, vector<char>& pixels)
+{
+    stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (stream.gcount() == 0 && stream.eof())
+    {
+        return false;
+    }
+    if (stream.gcount() != (std::streamsize) sizeof(header) || header.magic != FRAME_MAGIC)
+    {
+        throw ExceptionRenderError("Invalid frame header in batch stream");
+    }
+
+    pixels.resize((size_t) header.byteSize);
+    stream.read(pixels.data(), (std::streamsize) header.byteSize);
+    if (stream.gcount() != (std::streamsize) header.byteSize)
+    {
+        throw ExceptionRenderError("Truncated frame in batch stream");
+    }
+    return true;
+}
+
+//
+// BatchRunner methods
+//
+
+BatchRunner::BatchRunner(BatchRendererPtr renderer, BatchFrameWriterPtr writer) :
+    _renderer(renderer),
+    _writer(writer),
+    _groupJobs(false)
+{
+    if (!_renderer || !_writer)
+    {
+        throw ExceptionRenderError("Batch runner requires a valid renderer and writer");
+    }
+}
+
+size_t BatchRunner::run(BatchJobReader& reader)
+{
+    _currentMaterial = FilePath();
+    _currentVertexShader = FilePath();
+    _currentPixelShader = FilePath();
+    _currentUniforms.clear();
+    _failures.clear();
+    _stats = Stats();
+
+    try
+    {
+        BatchJob job;
+        if (_groupJobs)
+        {
+            vector<BatchJob> jobs;
+            while (reader.readJob(job))
+            {
+                jobs.push_back(job);
+            }
+            std::stable_sort(jobs.begin(), jobs.end(), [](const BatchJob& a, const BatchJob& b)
+            {
+                if (a.materialFilename != b.materialFilename)
+                {
+                    return a.materialFilename.asString() < b.materialFilename.asString();
+                }
+                if (a.vertexShaderFilename != b.vertexShaderFilename)
+                {
+                    return a.vertexShaderFilename.asString() < b.vertexShaderFilename.asString();
+                }
+                return a.pixelShaderFilename.asString() < b.pixelShaderFilename.asString();
+            });
+            for (const BatchJob& groupedJob : jobs)
+            {
+                renderJob(groupedJob);
+            }
+        }
+        else
+        {
+            while (reader.readJob(job))
+            {
+                renderJob(job);
+            }
+        }
+    }
+    catch (...)
+    {
+        // Write the frames of jobs submitted before the error.
+        _renderer->flush();
+        throw;
+    }
+
+    _renderer->flush();
+    return _stats.framesWritten;
+}
+
+void BatchRunner::renderJob(const BatchJob& job)
+{
+    _stats.jobs++;
+    try
+    {
+        if (job.materialFilename != _currentMaterial)
+        {
+            _currentMaterial = FilePath();
+            _renderer->loadMaterial(job.materialFilename);
+            _currentMaterial = job.materialFilename;
+            _currentVertexShader = FilePath();
+            _currentPixelShader = FilePath();
+            _currentUniforms.clear();
+            _stats.materialLoads++;
+        }
+
+        if (job.vertexShaderFilename != _currentVertexShader ||
+            job.pixelShaderFilename != _currentPixelShader)
+        {
+            _renderer->setShader(job.vertexShaderFilename, job.pixelShaderFilename);
+            _currentVertexShader = job.vertexShaderFilename;
+            _currentPixelShader = job.pixelShaderFilename;
+            _stats.shaderChanges++;
+        }
+
+        // Restore uniforms overridden by the previous job, so that each frame
+        // depends only on the settings of its own job.
+        for (const string& path : _currentUniforms)
+        {
+            if (std::find(job.uniformPaths.begin(), job.uniformPaths.end(), path) == job.uniformPaths.end())
+            {
+                _renderer->resetUniform(path);
+            }
+        }
+        _currentUniforms.clear();
+        for (size_t i = 0; i < job.uniformPaths.size(); i++)
+        {
+            _currentUniforms.push_back(job.uniformPaths[i]);
+            _renderer->setUniform(job.uniformPaths[i], job.uniformValues[i]);
+        }
+
+        _renderer->setCamera(job.cameraPosition, job.cameraTarget, job.cameraViewAngle);
+        _renderer->render(job.width, job.height, [this, job](uint64_t, ImagePtr image)
+        {
+            try
+            {
+                if (!image)
+                {
+                    throw ExceptionRenderError("No frame was rendered");
+                }
+                _writer->write(job, image);
+                _stats.framesWritten++;
+            }
+            catch (std::exception& e)
+            {
+                addFailure(job, e.what());
+            }
+        });
+    }
+    catch (std::exception& e)
+    {
+        // The renderer state is unknown after a failure, so reload the material for the next job.
+        _currentMaterial = FilePath();
+        addFailure(job, e.what());
+    }
+}
+
+void BatchRunner::addFailure(const BatchJob& job, const string& message)
+{
+    _failures.push_back({ job.index, job.line, message });
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,352 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_BATCHRENDER_H
+#define MATERIALX_BATCHRENDER_H
+
+/// @file
+/// Batch rendering of jobs read from a job file
+
+#include <MaterialXRender/Export.h>
+
+#include <MaterialXRender/FrameReadback.h>
+#include <MaterialXRender/ImageHandler.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <MaterialXCore/Types.h>
+
+#include <istream>
+#include <ostream>
+
+MATERIALX_NAMESPACE_BEGIN
+
+/// A shared pointer to a BatchRenderer
+using BatchRendererPtr = std::shared_ptr<class BatchRenderer>;
+
+/// A shared pointer to a BatchFrameWriter
+using BatchFrameWriterPtr = std::shared_ptr<class BatchFrameWriter>;
+
+/// A shared pointer to a BatchImageWriter
+using BatchImageWriterPtr = std::shared_ptr<class BatchImageWriter>;
+
+/// A shared pointer to a BatchStreamWriter
+using BatchStreamWriterPtr = std::shared_ptr<class BatchStreamWriter>;
+
+/// A shared pointer to a BatchRunner
+using BatchRunnerPtr = std::shared_ptr<class BatchRunner>;
+
+/// @class BatchJob
+/// A single render job of a batch, holding the complete state needed to
+/// render one frame.
+class MX_RENDER_API BatchJob
+{
+  public:
+    BatchJob() :
+        index(0),
+        line(0),
+        cameraPosition(0.0f, 0.0f, 5.0f),
+        cameraViewAngle(45.0f),
+        width(512),
+        height(512)
+    {
+    }
+    ~BatchJob() { }
+
+    /// The position of this job in the job stream, starting at zero.
+    size_t index;
+
+    /// The job file line on which this job was submitted.
+    size_t line;
+
+    /// The MaterialX document to be rendered.
+    FilePath materialFilename;
+
+    /// Optional vertex and pixel shader source files, overriding the shader
+    /// generated for the material.  Both are empty if the generated shader
+    /// should be used.
+    FilePath vertexShaderFilename;
+    FilePath pixelShaderFilename;
+
+    /// Uniform overrides for this job, as pairs of uniform paths and value
+    /// strings.  Uniforms that are not overridden keep their material values.
+    StringVec uniformPaths;
+    StringVec uniformValues;
+
+    /// Camera position, target, and view angle in degrees.
+    Vector3 cameraPosition;
+    Vector3 cameraTarget;
+    float cameraViewAngle;
+
+    /// Resolution of the rendered frame.
+    unsigned int width;
+    unsigned int height;
+
+    /// The file to which the rendered frame is written, if any.
+    FilePath outputFilename;
+};
+
+/// @class BatchJobReader
+/// Reads render jobs from a line-based job file.
+///
+/// Each line holds a command followed by its arguments, and lines starting
+/// with '#' are comments.  Settings persist from one job to the next, except
+/// for uniform overrides, which apply to the next job only:
+///
+///     material <filename>           Set the MaterialX document to render
+///     shader <vertex> <pixel>       Override the generated shader with source files
+///     shader generated              Return to the generated shader
+///     uniform <path> <value>        Override a uniform value for the next job
+///     camera <position> <target> [<angle>]
+///                                   Set the camera, with vectors given as
+///                                   comma-separated floats
+///     resolution <width> <height>   Set the resolution of rendered frames
+///     render [<filename>]           Submit a job, writing its frame to the
+///                                   given file if any
+class MX_RENDER_API BatchJobReader
+{
+  public:
+    /// Construct a reader for the given stream, with initial settings taken
+    /// from the given job.
+    BatchJobReader(std::istream& stream, const BatchJob& defaults = BatchJob());
+    ~BatchJobReader() { }
+
+    /// Read the next job from the stream.
+    /// @param job Job receiving the settings of the next job.
+    /// @return True if a job was read, or false at the end of the stream.
+    /// @throws ExceptionRenderError if a malformed line is encountered.
+    bool readJob(BatchJob& job);
+
+    /// Return the number of lines read so far.
+    size_t getLineNumber() const
+    {
+        return _lineNumber;
+    }
+
+  private:
+    std::istream& _stream;
+    BatchJob _state;
+    size_t _lineNumber;
+    size_t _jobCount;
+};
+
+/// @class BatchRenderer
+/// Abstract interface to the rendering backend of a batch.
+///
+/// Methods report failures by throwing exceptions, which cause the current
+/// job to be skipped.
+class MX_RENDER_API BatchRenderer
+{
+  public:
+    virtual ~BatchRenderer() { }
+
+    /// Load the given MaterialX document, making its first renderable
+    /// element the current material with its generated shader.
+    virtual void loadMaterial(const FilePath& filename) = 0;
+
+    /// Override the shader of the current material with the given source
+    /// files, or restore its generated shader if both are empty.
+    virtual void setShader(const FilePath& vertexShaderFilename, const FilePath& pixelShaderFilename) = 0;
+
+    /// Set the uniform with the given path to the given value string.
+    virtual void setUniform(const string& path, const string& value) = 0;
+
+    /// Restore the uniform with the given path to its material value.
+    virtual void resetUniform(const string& path) = 0;
+
+    /// Set the camera for subsequent renders.
+    virtual void setCamera(const Vector3& position, const Vector3& target, float viewAngle) = 0;
+
+    /// Render a frame at the given resolution, invoking the callback with
+    /// its image once available, which may be during a later call.
+    virtual void render(unsigned int width, unsigned int height, FrameReadbackQueue::FrameCallback callback) = 0;
+
+    /// Complete all frames in flight.
+    virtual void flush() = 0;
+};
+
+/// @class BatchFrameWriter
+/// Abstract interface for the output of rendered batch frames.
+class MX_RENDER_API BatchFrameWriter
+{
+  public:
+    virtual ~BatchFrameWriter() { }
+
+    /// Write the frame rendered for the given job.
+    /// @throws Exception if the frame could not be written.
+    virtual void write(const BatchJob& job, ConstImagePtr image) = 0;
+};
+
+/// @class BatchImageWriter
+/// Writes each batch frame to the image file named by its job.
+class MX_RENDER_API BatchImageWriter : public BatchFrameWriter
+{
+  public:
+    /// Create a writer saving images through the given image handler.
+    static BatchImageWriterPtr create(ImageHandlerPtr imageHandler)
+    {
+        return BatchImageWriterPtr(new BatchImageWriter(imageHandler));
+    }
+
+    void write(const BatchJob& job, ConstImagePtr image) override;
+
+  protected:
+    BatchImageWriter(ImageHandlerPtr imageHandler) :
+        _imageHandler(imageHandler)
+    {
+    }
+
+  private:
+    ImageHandlerPtr _imageHandler;
+};
+
+/// @class BatchStreamWriter
+/// Writes batch frames to a single packed binary stream.
+///
+/// Each frame is stored as a FrameHeader followed by its pixels, in the
+/// order in which frames complete.  Header fields are in native byte order,
+/// and pixel rows are stored from bottom to top, as read from the renderer.
+class MX_RENDER_API BatchStreamWriter : public BatchFrameWriter
+{
+  public:
+    /// Identifier at the start of each frame header.
+    static const uint32_t FRAME_MAGIC;
+
+    /// Header preceding the pixels of each frame.
+    struct FrameHeader
+    {
+        uint32_t magic;
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t baseType;
+        uint32_t reserved;
+        uint64_t jobIndex;
+        uint64_t byteSize;
+    };
+
+  public:
+    /// Create a writer for the given stream, which must remain valid for
+    /// the lifetime of the writer.
+    static BatchStreamWriterPtr create(std::ostream& stream)
+    {
+        return BatchStreamWriterPtr(new BatchStreamWriter(stream));
+    }
+
+    void write(const BatchJob& job, ConstImagePtr image) override;
+
+    /// Read the next frame from a stream written by this class.
+    /// @param stream Stream to read from.
+    /// @param header Header receiving the frame description.
+    /// @param pixels Buffer receiving the frame pixels.
+    /// @return True if a frame was read, or false at the end of the stream.
+    /// @throws ExceptionRenderError if the stream is malformed.
+    static bool readFrame(std::istream& stream, FrameHeader& header, vector<char>& pixels);
+
+  protected:
+    BatchStreamWriter(std::ostream& stream) :
+        _stream(stream)
+    {
+    }
+
+  private:
+    std::ostream& _stream;
+};
+
+/// @class BatchRunner
+/// Renders the jobs of a batch through a BatchRenderer, passing completed
+/// frames to a BatchFrameWriter.
+///
+/// State changes between consecutive jobs are minimized: a material is
+/// only reloaded when its document changes, and shaders are only replaced
+/// when their source files change.  Failed jobs are recorded and skipped.
+class MX_RENDER_API BatchRunner
+{
+  public:
+    /// A job that could not be rendered or written.
+    struct Failure
+    {
+        size_t jobIndex;
+        size_t line;
+        string message;
+    };
+
+    /// Batch counters.
+    struct Stats
+    {
+        size_t jobs = 0;
+        size_t framesWritten = 0;
+        size_t materialLoads = 0;
+        size_t shaderChanges = 0;
+    };
+
+  public:
+    virtual ~BatchRunner() { }
+
+    /// Create a runner for the given renderer and writer.
+    static BatchRunnerPtr create(BatchRendererPtr renderer, BatchFrameWriterPtr writer)
+    {
+        return BatchRunnerPtr(new BatchRunner(renderer, writer));
+    }
+
+    /// Set whether all jobs are read before rendering and grouped by
+    /// material and shader, which minimizes reloads when jobs for different
+    /// materials are interleaved.  Frames are then written out of job order.
+    /// Defaults to false, where jobs are rendered as they are read.
+    void setGroupJobs(bool enable)
+    {
+        _groupJobs = enable;
+    }
+
+    /// Return whether jobs are grouped by material and shader.
+    bool getGroupJobs() const
+    {
+        return _groupJobs;
+    }
+
+    /// Render all jobs from the given reader.
+    /// @return The number of jobs that were rendered and written.
+    /// @throws ExceptionRenderError if the job file is malformed.
+    size_t run(BatchJobReader& reader);
+
+    /// Return the jobs that failed during the last run.
+    const vector<Failure>& getFailures() const
+    {
+        return _failures;
+    }
+
+    /// Return the counters of the last run.
+    const Stats& getStats() const
+    {
+        return _stats;
+    }
+
+  protected:
+    BatchRunner(BatchRendererPtr renderer, BatchFrameWriterPtr writer);
+
+    // Apply the state of the given job and submit its frame.
+    void renderJob(const BatchJob& job);
+
+    // Record a failed job.
+    void addFailure(const BatchJob& job, const string& message);
+
+  private:
+    BatchRendererPtr _renderer;
+    BatchFrameWriterPtr _writer;
+    bool _groupJobs;
+
+    // State currently applied to the renderer.
+    FilePath _currentMaterial;
+    FilePath _currentVertexShader;
+    FilePath _currentPixelShader;
+    StringVec _currentUniforms;
+
+    vector<Failure> _failures;
+    Stats _stats;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
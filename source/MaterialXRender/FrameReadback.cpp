@@ -0,0 +1,111 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXRender/FrameReadback.h>
+
+#include <MaterialXRender/ShaderRenderer.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+//
+// FrameReadbackQueue methods
+//
+
+const size_t FrameReadbackQueue::DEFAULT_SLOT_COUNT = 3;
+
+FrameReadbackQueue::FrameReadbackQueue(ReadbackTargetPtr target, size_t slotCount) :
+    _target(target),
+    _slotCount(std::max<size_t>(slotCount, 1)),
+    _width(0),
+    _height(0),
+    _nextSlot(0),
+    _nextFrame(1)
+{
+    if (!_target)
+    {
+        throw ExceptionRenderError("Frame readback queue requires a valid target");
+    }
+}
+
+bool FrameReadbackQueue::setResolution(unsigned int width, unsigned int height)
+{
+    if (width == 0 || height == 0)
+    {
+        throw ExceptionRenderError("Invalid frame readback resolution: " +
+                                   std::to_string(width) + "x" + std::to_string(height));
+    }
+    if (width == _width && height == _height)
+    {
+        return false;
+    }
+
+    // Slots are sized for the current resolution, so drain them first.
+    flush();
+    _target->allocate(width, height, _slotCount);
+    _width = width;
+    _height = height;
+    _nextSlot = 0;
+    _stats.reallocations++;
+    return true;
+}
+
+uint64_t FrameReadbackQueue::submit(FrameCallback callback)
+{
+    if (!_width || !_height)
+    {
+        throw ExceptionRenderError("Frame readback queue has no resolution");
+    }
+
+    // Slots are assigned round-robin and completed in order, so the next
+    // slot is free as soon as fewer than slotCount frames are in flight.
+    if (_inFlight.size() >= _slotCount)
+    {
+        _stats.stalls++;
+        completeOldest();
+    }
+
+    PendingFrame pending { _nextFrame++, _nextSlot, callback };
+    _nextSlot = (_nextSlot + 1) % _slotCount;
+    _target->beginReadback(pending.slot);
+    _inFlight.push_back(std::move(pending));
+    _stats.submitted++;
+    return _inFlight.back().frame;
+}
+
+size_t FrameReadbackQueue::poll()
+{
+    size_t count = 0;
+    while (!_inFlight.empty() && _target->isReadbackComplete(_inFlight.front().slot))
+    {
+        completeOldest();
+        count++;
+    }
+    return count;
+}
+
+size_t FrameReadbackQueue::flush()
+{
+    size_t count = _inFlight.size();
+    while (!_inFlight.empty())
+    {
+        completeOldest();
+    }
+    return count;
+}
+
+void FrameReadbackQueue::completeOldest()
+{
+    PendingFrame pending = std::move(_inFlight.front());
+    _inFlight.pop_front();
+
+    ImagePtr image = _target->endReadback(pending.slot);
+    _stats.completed++;
+    if (pending.callback)
+    {
+        pending.callback(pending.frame, image);
+    }
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,170 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_FRAMEREADBACK_H
+#define MATERIALX_FRAMEREADBACK_H
+
+/// @file
+/// Pipelined readback of rendered frames
+
+#include <MaterialXRender/Export.h>
+
+#include <MaterialXRender/Image.h>
+
+#include <deque>
+#include <functional>
+
+MATERIALX_NAMESPACE_BEGIN
+
+/// A shared pointer to a ReadbackTarget
+using ReadbackTargetPtr = std::shared_ptr<class ReadbackTarget>;
+
+/// A shared pointer to a FrameReadbackQueue
+using FrameReadbackQueuePtr = std::shared_ptr<class FrameReadbackQueue>;
+
+/// @class ReadbackTarget
+/// Abstract interface to an offscreen render target, whose contents are
+/// copied back to the host asynchronously through a fixed set of slots.
+class MX_RENDER_API ReadbackTarget
+{
+  public:
+    virtual ~ReadbackTarget() { }
+
+    /// Reallocate the render target and its readback slots for the given
+    /// resolution.  No readbacks are in flight when this is called.
+    virtual void allocate(unsigned int width, unsigned int height, size_t slotCount) = 0;
+
+    /// Start copying the current contents of the render target into the
+    /// given slot, without waiting for the copy to complete.
+    virtual void beginReadback(size_t slot) = 0;
+
+    /// Return true if the copy into the given slot has completed.  This
+    /// method must not block.
+    virtual bool isReadbackComplete(size_t slot) = 0;
+
+    /// Return the contents of the given slot as an image, blocking until
+    /// the copy into the slot has completed.
+    virtual ImagePtr endReadback(size_t slot) = 0;
+};
+
+/// @class FrameReadbackQueue
+/// Schedules the readback of rendered frames across the slots of a
+/// ReadbackTarget, so that the next frame can be rendered while the pixels
+/// of earlier frames are still in flight.
+///
+/// Frames are completed strictly in submission order.  A frame is only
+/// waited on when every slot is in flight, when the resolution changes, or
+/// when the queue is flushed.
+class MX_RENDER_API FrameReadbackQueue
+{
+  public:
+    /// Callback receiving the number and image of a completed frame.
+    using FrameCallback = std::function<void(uint64_t frame, ImagePtr image)>;
+
+    /// Default number of readback slots, allowing two frames in flight
+    /// while a third is rendered.
+    static const size_t DEFAULT_SLOT_COUNT;
+
+    /// Queue usage counters.
+    struct Stats
+    {
+        size_t submitted = 0;
+        size_t completed = 0;
+        size_t stalls = 0;
+        size_t reallocations = 0;
+    };
+
+  public:
+    virtual ~FrameReadbackQueue() { }
+
+    /// Create a queue for the given target and number of readback slots.
+    static FrameReadbackQueuePtr create(ReadbackTargetPtr target, size_t slotCount = DEFAULT_SLOT_COUNT)
+    {
+        return FrameReadbackQueuePtr(new FrameReadbackQueue(target, slotCount));
+    }
+
+    /// Set the resolution of subsequently rendered frames.  If the resolution
+    /// differs from the current one, frames in flight are completed and the
+    /// target is reallocated.
+    /// @return True if the target was reallocated.
+    bool setResolution(unsigned int width, unsigned int height);
+
+    /// Start the readback of a frame that has just been rendered into the
+    /// target.  If every slot is in flight, the oldest frame is completed first.
+    /// @param callback Callback invoked with the image once the frame is complete.
+    /// @return The number of the submitted frame.
+    uint64_t submit(FrameCallback callback);
+
+    /// Complete frames whose readback has finished, without blocking.
+    /// @return The number of frames completed.
+    size_t poll();
+
+    /// Complete all frames in flight, blocking as needed.
+    /// @return The number of frames completed.
+    size_t flush();
+
+    /// Return the render target of this queue.
+    ReadbackTargetPtr getTarget() const
+    {
+        return _target;
+    }
+
+    /// Return the number of readback slots.
+    size_t getSlotCount() const
+    {
+        return _slotCount;
+    }
+
+    /// Return the number of frames whose readback is in flight.
+    size_t getInFlightCount() const
+    {
+        return _inFlight.size();
+    }
+
+    /// Return the width of the current resolution.
+    unsigned int getWidth() const
+    {
+        return _width;
+    }
+
+    /// Return the height of the current resolution.
+    unsigned int getHeight() const
+    {
+        return _height;
+    }
+
+    /// Return the queue usage counters.
+    const Stats& getStats() const
+    {
+        return _stats;
+    }
+
+  protected:
+    FrameReadbackQueue(ReadbackTargetPtr target, size_t slotCount);
+
+    // Complete the oldest frame in flight, blocking until its readback is done.
+    void completeOldest();
+
+  private:
+    struct PendingFrame
+    {
+        uint64_t frame;
+        size_t slot;
+        FrameCallback callback;
+    };
+
+    ReadbackTargetPtr _target;
+    size_t _slotCount;
+    unsigned int _width;
+    unsigned int _height;
+    std::deque<PendingFrame> _inFlight;
+    size_t _nextSlot;
+    uint64_t _nextFrame;
+    Stats _stats;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -0,0 +1,338 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXRender/ProgramBinaryCache.h>
+
+#include <MaterialXCore/Util.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+const string ENTRY_EXTENSION = "mxpb";
+const char ENTRY_MAGIC[4] = { 'M', 'X', 'P', 'B' };
+const uint32_t ENTRY_VERSION = 2;
+
+uint64_t hashBinaryData(const vector<unsigned char>& data)
+{
+    return hashString(string(reinterpret_cast<const char*>(data.data()), data.size()));
+}
+
+template <class T> void writeScalar(std::ostream& stream, T value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T> bool readScalar(std::istream& stream, T& value)
+{
+    return (bool) stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+size_t getFileSize(const FilePath& path)
+{
+    std::ifstream stream(path.asString(), std::ios::binary | std::ios::ate);
+    return stream ? (size_t) stream.tellg() : 0;
+}
+
+// Return a temporary file suffix that is unique to the calling process and
+// thread, so that concurrent writers of the same entry never share a file.
+string getTempSuffix()
+{
+#if defined(_WIN32)
+    int processId = _getpid();
+#else
+    int processId = (int) getpid();
+#endif
+    std::ostringstream suffix;
+    suffix << ".tmp" << processId << "_" << std::this_thread::get_id();
+    return suffix.str();
+}
+
+} // anonymous namespace
+
+//
+// ProgramBinaryCache methods
+//
+
+const size_t ProgramBinaryCache::DEFAULT_MAX_SIZE = 256 * 1024 * 1024;
+
+ProgramBinaryCache::ProgramBinaryCache(const FilePath& directory, size_t maxSize) :
+    _directory(directory),
+    _maxSize(maxSize),
+    _totalSize(0)
+{
+    if (!_directory.isDirectory())
+    {
+        _directory.createDirectory();
+    }
+
+    // Register existing entries in a deterministic order.
+    FilePathVec files = _directory.getFilesInDirectory(ENTRY_EXTENSION);
+    std::sort(files.begin(), files.end(), [](const FilePath& a, const FilePath& b)
+    {
+        return a.asString() < b.asString();
+    });
+    for (FilePath file : files)
+    {
+        size_t size = getFileSize(_directory / file);
+        file.removeExtension();
+        _entries.emplace_front(file.asString(), size);
+        _index[file.asString()] = _entries.begin();
+        _totalSize += size;
+    }
+    evict();
+}
+
+bool ProgramBinaryCache::build(const StringMap& stages, ProgramBinaryBackend& backend)
+{
+    const string sourceDescription = getSourceDescription(stages, backend.getDriverIdentity());
+    const string key = computeKey(stages, backend.getDriverIdentity());
+
+    ProgramBinary binary;
+    if (readBinary(key, sourceDescription, binary))
+    {
+        if (backend.loadBinary(binary))
+        {
+            _stats.hits++;
+            return true;
+        }
+
+        // The driver no longer accepts this binary, so replace it below.
+        _stats.rejections++;
+        removeBinary(key);
+    }
+
+    _stats.misses++;
+    backend.buildFromSource();
+
+    ProgramBinary builtBinary;
+    if (backend.getBinary(builtBinary) && !builtBinary.data.empty())
+    {
+        writeBinary(key, sourceDescription, builtBinary);
+    }
+    return false;
+}
+
+string ProgramBinaryCache::computeKey(const StringMap& stages, const string& driverIdentity)
+{
+    // Hash stages in name order, so the key is independent of map ordering.
+    StringVec stageNames;
+    for (const auto& stage : stages)
+    {
+        stageNames.push_back(stage.first);
+    }
+    std::sort(stageNames.begin(), stageNames.end());
+
+    uint64_t hash = hashString(driverIdentity);
+    for (const string& stageName : stageNames)
+    {
+        hash = hashString(stageName, hash);
+        hash = hashString(stages.at(stageName), hash);
+    }
+
+    std::ostringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return stream.str();
+}
+
+string ProgramBinaryCache::getSourceDescription(const StringMap& stages, const string& driverIdentity)
+{
+    StringVec stageNames;
+    for (const auto& stage : stages)
+    {
+        stageNames.push_back(stage.first);
+    }
+    std::sort(stageNames.begin(), stageNames.end());
+
+    // Prefix each string with its length, so that no two distinct sets of
+    // sources share a description.
+    string description;
+    auto append = [&description](const string& str)
+    {
+        description += std::to_string(str.size());
+        description += ':';
+        description += str;
+    };
+    append(driverIdentity);
+    for (const string& stageName : stageNames)
+    {
+        append(stageName);
+        append(stages.at(stageName));
+    }
+    return description;
+}
+
+bool ProgramBinaryCache::readBinary(const string& key, const string& sourceDescription, ProgramBinary& binary)
+{
+    if (!hasBinary(key))
+    {
+        return false;
+    }
+
+    std::ifstream stream(getEntryPath(key).asString(), std::ios::binary);
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint32_t keyLength = 0;
+    string storedKey;
+    uint64_t sourceLength = 0;
+    string storedSource;
+    uint32_t format = 0;
+    uint64_t dataSize = 0;
+    uint64_t checksum = 0;
+
+    bool valid = stream.read(magic, sizeof(magic)) &&
+                 std::equal(magic, magic + sizeof(magic), ENTRY_MAGIC) &&
+                 readScalar(stream, version) && version == ENTRY_VERSION &&
+                 readScalar(stream, keyLength) && keyLength == key.size();
+    if (valid)
+    {
+        storedKey.resize(keyLength);
+        valid = stream.read(&storedKey[0], keyLength) && storedKey == key &&
+                readScalar(stream, sourceLength) &&
+                sourceLength <= _index[key]->second;
+    }
+    if (valid)
+    {
+        storedSource.resize((size_t) sourceLength);
+        valid = stream.read(&storedSource[0], (std::streamsize) sourceLength) &&
+                readScalar(stream, format) &&
+                readScalar(stream, dataSize) &&
+                readScalar(stream, checksum) &&
+                dataSize > 0 && dataSize <= _index[key]->second;
+    }
+    if (valid)
+    {
+        binary.format = format;
+        binary.data.resize((size_t) dataSize);
+        valid = stream.read(reinterpret_cast<char*>(binary.data.data()), (std::streamsize) dataSize) &&
+                hashBinaryData(binary.data) == checksum;
+    }
+
+    if (!valid)
+    {
+        _stats.corruptions++;
+        stream.close();
+        removeBinary(key);
+        binary = ProgramBinary();
+        return false;
+    }
+
+    // An intact entry built from other sources shares the key of these
+    // sources by hash collision, and is left to be replaced by the caller.
+    if (storedSource != sourceDescription)
+    {
+        _stats.collisions++;
+        binary = ProgramBinary();
+        return false;
+    }
+
+    touch(key);
+    return true;
+}
+
+void ProgramBinaryCache::writeBinary(const string& key, const string& sourceDescription, const ProgramBinary& binary)
+{
+    removeBinary(key);
+
+    // Write to a temporary file first and then rename it, so that readers
+    // in other processes never observe a partially written entry.
+    FilePath entryPath = getEntryPath(key);
+    FilePath tempPath = _directory / (key + getTempSuffix());
+    {
+        std::ofstream stream(tempPath.asString(), std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            return;
+        }
+        stream.write(ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+        writeScalar(stream, ENTRY_VERSION);
+        writeScalar(stream, (uint32_t) key.size());
+        stream.write(key.data(), (std::streamsize) key.size());
+        writeScalar(stream, (uint64_t) sourceDescription.size());
+        stream.write(sourceDescription.data(), (std::streamsize) sourceDescription.size());
+        writeScalar(stream, (uint32_t) binary.format);
+        writeScalar(stream, (uint64_t) binary.data.size());
+        writeScalar(stream, hashBinaryData(binary.data));
+        stream.write(reinterpret_cast<const char*>(binary.data.data()), (std::streamsize) binary.data.size());
+        if (!stream)
+        {
+            stream.close();
+            std::remove(tempPath.asString().c_str());
+            return;
+        }
+    }
+    if (std::rename(tempPath.asString().c_str(), entryPath.asString().c_str()) != 0)
+    {
+        std::remove(tempPath.asString().c_str());
+        return;
+    }
+
+    size_t size = getFileSize(entryPath);
+    _entries.emplace_front(key, size);
+    _index[key] = _entries.begin();
+    _totalSize += size;
+    evict();
+}
+
+void ProgramBinaryCache::removeBinary(const string& key)
+{
+    auto it = _index.find(key);
+    if (it == _index.end())
+    {
+        return;
+    }
+
+    std::remove(getEntryPath(key).asString().c_str());
+    _totalSize -= it->second->second;
+    _entries.erase(it->second);
+    _index.erase(it);
+}
+
+void ProgramBinaryCache::clear()
+{
+    while (!_entries.empty())
+    {
+        removeBinary(_entries.back().first);
+    }
+}
+
+FilePath ProgramBinaryCache::getEntryPath(const string& key) const
+{
+    return _directory / (key + "." + ENTRY_EXTENSION);
+}
+
+void ProgramBinaryCache::touch(const string& key)
+{
+    auto it = _index.find(key);
+    if (it != _index.end())
+    {
+        _entries.splice(_entries.begin(), _entries, it->second);
+    }
+}
+
+void ProgramBinaryCache::evict()
+{
+    // The most recently written entry is always retained.
+    while (_totalSize > _maxSize && _entries.size() > 1)
+    {
+        removeBinary(_entries.back().first);
+        _stats.evictions++;
+    }
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,195 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_PROGRAMBINARYCACHE_H
+#define MATERIALX_PROGRAMBINARYCACHE_H
+
+/// @file
+/// Persistent on-disk cache of linked program binaries
+
+#include <MaterialXRender/Export.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <list>
+
+MATERIALX_NAMESPACE_BEGIN
+
+/// A shared pointer to a ProgramBinaryCache
+using ProgramBinaryCachePtr = std::shared_ptr<class ProgramBinaryCache>;
+
+/// @struct ProgramBinary
+/// A driver-specific binary representation of a linked program.
+struct MX_RENDER_API ProgramBinary
+{
+    /// Driver-specific binary format identifier.
+    unsigned int format = 0;
+    /// Binary program data.
+    vector<unsigned char> data;
+};
+
+/// @class ProgramBinaryBackend
+/// Abstract interface through which a ProgramBinaryCache builds, loads and
+/// retrieves the binaries of a single program.
+class MX_RENDER_API ProgramBinaryBackend
+{
+  public:
+    virtual ~ProgramBinaryBackend() { }
+
+    /// Return a string identifying the driver that produces binaries.
+    /// Binaries stored under one identity are never offered to another.
+    virtual string getDriverIdentity() = 0;
+
+    /// Build the program from its source code.  An exception should be
+    /// thrown if the program cannot be built.
+    virtual void buildFromSource() = 0;
+
+    /// Build the program from the given binary, returning false if the
+    /// binary was rejected by the driver.
+    virtual bool loadBinary(const ProgramBinary& binary) = 0;
+
+    /// Retrieve the binary of a program built from source, returning false
+    /// if no binary is available.
+    virtual bool getBinary(ProgramBinary& binary) = 0;
+};
+
+/// @class ProgramBinaryCache
+/// A persistent cache of linked program binaries, stored as one file per
+/// program in a cache directory.
+///
+/// Binaries are keyed by a hash of the program's stage sources and the
+/// identity of the driver that produced them.  Each entry also stores the full
+/// sources it was built from, which are compared on load, so that a hash
+/// collision never results in the binary of another program being used.
+/// Entries that are corrupt or rejected by the driver are removed, and the
+/// program is rebuilt from source.
+/// When the total size of cached binaries exceeds the configured maximum, the
+/// least recently used entries are evicted.
+///
+/// Entries are written atomically, so a directory may be shared by several
+/// processes, each of which reads only complete entries.  The index of
+/// entries and their total size are per process, however: they are built
+/// from the directory at construction, and track only the entries this
+/// instance later writes or removes.  The size limit and least recently used
+/// order therefore do not account for entries written by other processes.
+/// An instance is not safe for concurrent use by multiple threads.
+class MX_RENDER_API ProgramBinaryCache
+{
+  public:
+    /// Default maximum size in bytes of all cached binaries.
+    static const size_t DEFAULT_MAX_SIZE;
+
+    /// Cache usage counters.
+    struct Stats
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t rejections = 0;
+        size_t corruptions = 0;
+        size_t collisions = 0;
+        size_t evictions = 0;
+    };
+
+  public:
+    virtual ~ProgramBinaryCache() { }
+
+    /// Create a cache backed by the given directory, which is created if it
+    /// does not yet exist.  Existing entries in the directory are reused.
+    static ProgramBinaryCachePtr create(const FilePath& directory, size_t maxSize = DEFAULT_MAX_SIZE)
+    {
+        return ProgramBinaryCachePtr(new ProgramBinaryCache(directory, maxSize));
+    }
+
+    /// Build a program with the given stage sources through the given backend,
+    /// loading its binary from the cache when possible, and storing the binary
+    /// of a program built from source.
+    /// @return True if the program was built from a cached binary.
+    bool build(const StringMap& stages, ProgramBinaryBackend& backend);
+
+    /// Return the cache key for the given stage sources and driver identity.
+    static string computeKey(const StringMap& stages, const string& driverIdentity);
+
+    /// Return the description of the given stage sources and driver identity
+    /// that is stored with each entry, and from which its key is computed.
+    static string getSourceDescription(const StringMap& stages, const string& driverIdentity);
+
+    /// Read the binary stored for the given key, which must have been built
+    /// from sources with the given description.  A corrupt entry is removed.
+    /// @return True if a valid binary was found.
+    bool readBinary(const string& key, const string& sourceDescription, ProgramBinary& binary);
+
+    /// Store a binary built from sources with the given description under
+    /// the given key, evicting older entries if needed.
+    void writeBinary(const string& key, const string& sourceDescription, const ProgramBinary& binary);
+
+    /// Remove the binary stored for the given key, if any.
+    void removeBinary(const string& key);
+
+    /// Return true if a binary is stored for the given key.
+    bool hasBinary(const string& key) const
+    {
+        return _index.count(key) != 0;
+    }
+
+    /// Remove all binaries from the cache.
+    void clear();
+
+    /// Return the directory backing this cache.
+    const FilePath& getDirectory() const
+    {
+        return _directory;
+    }
+
+    /// Set the maximum size in bytes of all cached binaries.
+    void setMaxSize(size_t maxSize)
+    {
+        _maxSize = maxSize;
+        evict();
+    }
+
+    /// Return the maximum size in bytes of all cached binaries.
+    size_t getMaxSize() const
+    {
+        return _maxSize;
+    }
+
+    /// Return the total size in bytes of all cached binary files.
+    size_t getTotalSize() const
+    {
+        return _totalSize;
+    }
+
+    /// Return the cache usage counters.
+    const Stats& getStats() const
+    {
+        return _stats;
+    }
+
+  protected:
+    ProgramBinaryCache(const FilePath& directory, size_t maxSize);
+
+    // Return the file path for the given key.
+    FilePath getEntryPath(const string& key) const;
+
+    // Mark the given key as most recently used.
+    void touch(const string& key);
+
+    // Evict least recently used entries until within the maximum size.
+    void evict();
+
+  private:
+    using EntryList = std::list<std::pair<string, size_t>>;
+
+    FilePath _directory;
+    size_t _maxSize;
+    size_t _totalSize;
+    EntryList _entries;
+    std::unordered_map<string, EntryList::iterator> _index;
+    Stats _stats;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
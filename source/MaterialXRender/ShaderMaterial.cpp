@@ -4,10 +4,122 @@
 //
 
 #include <MaterialXRender/ShaderMaterial.h>
+#include <MaterialXRender/Util.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 MATERIALX_NAMESPACE_BEGIN
 
+//
+// UniformHandleTable methods
+//
+
+const int UniformHandleTable::INVALID_HANDLE = -1;
+
+void UniformHandleTable::reset(ShaderPtr shader)
+{
+    _shader = shader;
+    _uniforms.clear();
+    _handles.clear();
+    _generation++;
+}
+
+int UniformHandleTable::addUniform(ShaderPort* uniform)
+{
+    if (!uniform)
+    {
+        return INVALID_HANDLE;
+    }
+    auto it = _handles.find(uniform);
+    if (it != _handles.end())
+    {
+        return it->second;
+    }
+    int handle = (int) _uniforms.size();
+    _uniforms.push_back(uniform);
+    _handles[uniform] = handle;
+    return handle;
+}
+
+size_t UniformHandleTable::getPackedSize(TypeDesc type)
+{
+    if (type == Type::FLOAT || type == Type::INTEGER || type == Type::BOOLEAN)
+    {
+        return 1;
+    }
+    if (type.isFloat2() || type.isFloat3() || type.isFloat4())
+    {
+        return type.getSize();
+    }
+    if (type == Type::MATRIX33)
+    {
+        return 9;
+    }
+    if (type == Type::MATRIX44)
+    {
+        return 16;
+    }
+    return 0;
+}
+
+ValuePtr UniformHandleTable::createPackedValue(TypeDesc type, const float* data)
+{
+    if (type == Type::FLOAT)
+    {
+        return Value::createValue(data[0]);
+    }
+    if (type == Type::INTEGER)
+    {
+        return Value::createValue((int) data[0]);
+    }
+    if (type == Type::BOOLEAN)
+    {
+        return Value::createValue(data[0] != 0.0f);
+    }
+    if (type == Type::VECTOR2)
+    {
+        return Value::createValue(Vector2(data[0], data[1]));
+    }
+    if (type == Type::VECTOR3)
+    {
+        return Value::createValue(Vector3(data[0], data[1], data[2]));
+    }
+    if (type == Type::VECTOR4)
+    {
+        return Value::createValue(Vector4(data[0], data[1], data[2], data[3]));
+    }
+    if (type == Type::COLOR3)
+    {
+        return Value::createValue(Color3(data[0], data[1], data[2]));
+    }
+    if (type == Type::COLOR4)
+    {
+        return Value::createValue(Color4(data[0], data[1], data[2], data[3]));
+    }
+    if (type == Type::MATRIX33)
+    {
+        return Value::createValue(Matrix33(data[0], data[1], data[2],
+                                           data[3], data[4], data[5],
+                                           data[6], data[7], data[8]));
+    }
+    if (type == Type::MATRIX44)
+    {
+        return Value::createValue(Matrix44(data[0], data[1], data[2], data[3],
+                                           data[4], data[5], data[6], data[7],
+                                           data[8], data[9], data[10], data[11],
+                                           data[12], data[13], data[14], data[15]));
+    }
+    return nullptr;
+}
+
+//
+// ShaderMaterial methods
+//
+
 ShaderMaterial::ShaderMaterial() : _hasTransparency(false) { }
 ShaderMaterial::~ShaderMaterial() { }
 
@@ -61,6 +173,96 @@ bool ShaderMaterial::hasTransparency() const
     return _hasTransparency;
 }
 
+int ShaderMaterial::resolveUniformHandle(const std::string& path)
+{
+    if (_uniformHandles.getShader() != _hwShader)
+    {
+        _uniformHandles.reset(_hwShader);
+    }
+
+    ShaderPort* uniform = findUniform(path);
+    if (!uniform || !UniformHandleTable::getPackedSize(uniform->getType()))
+    {
+        return UniformHandleTable::INVALID_HANDLE;
+    }
+    return _uniformHandles.addUniform(uniform);
+}
+
+ShaderPort* ShaderMaterial::getUniformFromHandle(int handle) const
+{
+    if (_uniformHandles.getShader() != _hwShader)
+    {
+        return nullptr;
+    }
+    return _uniformHandles.getUniform(handle);
+}
+
+bool ShaderMaterial::modifyUniforms(const vector<int>& handles, const float* data, size_t dataSize)
+{
+    // Validate all handles before modifying any values.
+    size_t expectedSize = 0;
+    for (int handle : handles)
+    {
+        ShaderPort* uniform = getUniformFromHandle(handle);
+        if (!uniform)
+        {
+            return false;
+        }
+        expectedSize += UniformHandleTable::getPackedSize(uniform->getType());
+    }
+    if (expectedSize != dataSize || !bindShader())
+    {
+        return false;
+    }
+
+    for (int handle : handles)
+    {
+        ShaderPort* uniform = _uniformHandles.getUniform(handle);
+        uniform->setValue(UniformHandleTable::createPackedValue(uniform->getType(), data));
+        bindUniformData(handle, uniform, data);
+        data += UniformHandleTable::getPackedSize(uniform->getType());
+    }
+    return true;
+}
+
+void ShaderMaterial::bindUniformData(int, ShaderPort*, const float*)
+{
+}
+
+void ShaderMaterial::updateUniformValue(ShaderPort* uniform, ConstValuePtr value, std::string valueString)
+{
+    if (valueString.empty())
+    {
+        valueString = value->getValueString();
+    }
+    uniform->setValue(Value::createValueFromStrings(valueString, uniform->getType().getName()));
+    if (_doc)
+    {
+        ElementPtr element = _doc->getDescendant(uniform->getPath());
+        if (element)
+        {
+            ValueElementPtr valueElement = element->asA<ValueElement>();
+            if (valueElement)
+            {
+                valueElement->setValueString(valueString);
+            }
+        }
+    }
+}
+
+ShaderPtr ShaderMaterial::generateHwShader(GenContext& context)
+{
+    if (!_elem)
+    {
+        return nullptr;
+    }
+    _hasTransparency = isTransparentSurface(_elem, context.getShaderGenerator().getTarget());
+
+    GenContext materialContext = context;
+    materialContext.getOptions().hwTransparency = true;
+    return createShader("Shader", materialContext, _elem);
+}
+
 bool ShaderMaterial::generateEnvironmentShader(GenContext& context,
                                                const FilePath& filename,
                                                DocumentPtr stdLib,
@@ -100,4 +302,91 @@ bool ShaderMaterial::generateEnvironmentShader(GenContext& context,
     return generateShader(_hwShader);
 }
 
+//
+// Global functions
+//
+
+void generateShaders(const vector<MaterialPtr>& materials, GenContext& context, unsigned int threadCount)
+{
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min<size_t>(threadCount, materials.size());
+
+    vector<ShaderPtr> shaders(materials.size());
+    vector<std::exception_ptr> errors(materials.size());
+    std::atomic<size_t> nextMaterial(0);
+    auto generate = [&](GenContext& threadContext)
+    {
+        for (size_t i = nextMaterial++; i < materials.size(); i = nextMaterial++)
+        {
+            try
+            {
+                shaders[i] = materials[i]->generateHwShader(threadContext);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    // Node implementations and resource binding contexts hold generation
+    // state, so each thread starts from a copy of the context without node
+    // implementations, and with its own copy of any binding context.
+    vector<GenContext> threadContexts;
+    if (threadCount > 1)
+    {
+        threadContexts.assign(threadCount, context);
+        for (GenContext& threadContext : threadContexts)
+        {
+            threadContext.clearNodeImplementations();
+            HwResourceBindingContextPtr bindingContext =
+                threadContext.getUserData<HwResourceBindingContext>(HW::USER_DATA_BINDING_CONTEXT);
+            if (bindingContext)
+            {
+                HwResourceBindingContextPtr threadBindingContext = bindingContext->clone();
+                if (!threadBindingContext)
+                {
+                    // Binding contexts that cannot be copied are only used serially.
+                    threadContexts.clear();
+                    break;
+                }
+                threadContext.pushUserData(HW::USER_DATA_BINDING_CONTEXT, threadBindingContext);
+            }
+        }
+    }
+
+    if (threadContexts.empty())
+    {
+        generate(context);
+    }
+    else
+    {
+        vector<std::thread> threads;
+        for (GenContext& threadContext : threadContexts)
+        {
+            threads.emplace_back(generate, std::ref(threadContext));
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Programs are created in material order on the calling thread.
+    for (size_t i = 0; i < materials.size(); i++)
+    {
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
+        if (shaders[i])
+        {
+            materials[i]->generateShader(shaders[i]);
+        }
+    }
+}
+
 MATERIALX_NAMESPACE_END
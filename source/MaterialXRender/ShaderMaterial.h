@@ -34,6 +34,64 @@ class MX_RENDER_API ShadowState
     float ambientOcclusionGain = 0.0f;
 };
 
+/// @class UniformHandleTable
+/// Assigns stable integer handles to the public uniforms of a shader, so that
+/// uniforms can be updated repeatedly from packed float data, without path
+/// lookups or conversions through strings.
+class MX_RENDER_API UniformHandleTable
+{
+  public:
+    /// The handle value of an unresolved uniform.
+    static const int INVALID_HANDLE;
+
+    /// Remove all handles, and associate the table with the given shader.
+    void reset(ShaderPtr shader);
+
+    /// Return the shader whose uniforms are referenced by this table.
+    ShaderPtr getShader() const
+    {
+        return _shader;
+    }
+
+    /// Return the number of times this table has been reset.  Handles are
+    /// only valid within a single generation.
+    size_t getGeneration() const
+    {
+        return _generation;
+    }
+
+    /// Return the handle of the given uniform, assigning the next handle
+    /// if the uniform has not been seen before.
+    int addUniform(ShaderPort* uniform);
+
+    /// Return the uniform for the given handle, or nullptr if the handle
+    /// is not valid.
+    ShaderPort* getUniform(int handle) const
+    {
+        return (handle >= 0 && (size_t) handle < _uniforms.size()) ? _uniforms[handle] : nullptr;
+    }
+
+    /// Return the number of handles in this table.
+    size_t size() const
+    {
+        return _uniforms.size();
+    }
+
+    /// Return the number of floats in the packed representation of the
+    /// given type, or zero if the type has no packed representation.
+    static size_t getPackedSize(TypeDesc type);
+
+    /// Create a value of the given type from its packed representation.
+    /// Integer and boolean values are converted from floats.
+    static ValuePtr createPackedValue(TypeDesc type, const float* data);
+
+  private:
+    ShaderPtr _shader;
+    vector<ShaderPort*> _uniforms;
+    std::unordered_map<ShaderPort*, int> _handles;
+    size_t _generation = 0;
+};
+
 /// @class ShaderMaterial
 /// Abstract class for shader generation and rendering of a ShaderMaterial
 class MX_RENDER_API ShaderMaterial
@@ -81,6 +139,14 @@ class MX_RENDER_API ShaderMaterial
     /// Generate a shader from the given hardware shader.
     virtual bool generateShader(ShaderPtr hwShader) = 0;
 
+    /// Generate a hardware shader for the element of this ShaderMaterial,
+    /// without creating a program for it.  The result may be passed to
+    /// generateShader(ShaderPtr).
+    ///
+    /// This method does not access the rendering API, so it may be called
+    /// concurrently for distinct materials, each with its own generator context.
+    virtual ShaderPtr generateHwShader(GenContext& context);
+
     /// Generate an environment background shader
     virtual bool generateEnvironmentShader(GenContext& context,
                                            const FilePath& filename,
@@ -143,6 +209,35 @@ class MX_RENDER_API ShaderMaterial
 
     virtual void clearShader() = 0;
 
+    /// Resolve the public uniform with the given MaterialX path to an integer
+    /// handle, which remains valid until the shader of this material changes.
+    /// @return The uniform handle, or UniformHandleTable::INVALID_HANDLE if
+    ///    no such uniform exists.
+    int resolveUniformHandle(const std::string& path);
+
+    /// Return the public uniform for the given handle, or nullptr if the
+    /// handle is not valid for the current shader.
+    ShaderPort* getUniformFromHandle(int handle) const;
+
+    /// Modify the values of the uniforms with the given handles from packed
+    /// float data, in which each value occupies the number of floats given by
+    /// UniformHandleTable::getPackedSize.  Values are bound to the program and
+    /// stored on the uniforms without conversion through strings, and the
+    /// document of this material is not updated.
+    /// @return False if a handle is not valid or the size of the data does not
+    ///    match, in which case no values are modified.
+    bool modifyUniforms(const vector<int>& handles, const float* data, size_t dataSize);
+
+  protected:
+    // Bind the packed data of the uniform with the given handle to the
+    // underlying program, which has already been bound.
+    virtual void bindUniformData(int handle, ShaderPort* uniform, const float* data);
+
+    // Store a value modified through modifyUniform on the given uniform and
+    // on the matching element of the document, converting it through its
+    // value string.  If no value string is given, it is taken from the value.
+    void updateUniformValue(ShaderPort* uniform, ConstValuePtr value, std::string valueString);
+
   protected:
     ShaderPtr _hwShader;
     MeshPtr _boundMesh;
@@ -155,8 +250,21 @@ class MX_RENDER_API ShaderMaterial
     bool _hasTransparency;
 
     ImageVec _boundImages;
+
+    UniformHandleTable _uniformHandles;
 };
 
+/// Generate shaders for the given materials.  Hardware shaders are generated
+/// concurrently on the given number of threads, each with its own copy of the
+/// given context, and programs are then created serially on the calling thread
+/// through ShaderMaterial::generateShader(ShaderPtr).
+/// @param materials Materials for which shaders are generated.
+/// @param context Generator context, which is copied for each thread.
+/// @param threadCount Number of generation threads, where zero selects the
+///    number of hardware threads.  Defaults to zero.
+/// @throws The first exception, in material order, raised during generation.
+MX_RENDER_API void generateShaders(const vector<MaterialPtr>& materials, GenContext& context, unsigned int threadCount = 0);
+
 MATERIALX_NAMESPACE_END
 
 #endif
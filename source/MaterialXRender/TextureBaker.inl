@@ -563,7 +563,7 @@ void TextureBaker<Renderer, ShaderGen>::bakeAllMaterials(DocumentPtr doc, const
     std::vector<TypedElementPtr> renderableMaterials = findRenderableElements(doc);
 
     // Compute the UDIM set.
-    ValuePtr udimSetValue = doc->getGeomPropValue(UDIM_SET_PROPERTY);
+    ConstValuePtr udimSetValue = doc->getGeomPropValue(UDIM_SET_PROPERTY);
     StringVec udimSet;
     if (udimSetValue && udimSetValue->isA<StringVec>())
     {
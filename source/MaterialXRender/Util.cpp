@@ -14,6 +14,11 @@ const Color3 DEFAULT_SCREEN_COLOR_LIN_REC709(DEFAULT_SCREEN_COLOR_SRGB.srgbToLin
 
 ShaderPtr createShader(const string& shaderName, GenContext& context, ElementPtr elem)
 {
+    ShaderCachePtr cache = context.getShaderCache();
+    if (cache)
+    {
+        return cache->generate(shaderName, elem, context);
+    }
     return context.getShaderGenerator().generate(shaderName, elem, context);
 }
 
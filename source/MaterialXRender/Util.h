@@ -25,7 +25,8 @@ extern MX_RENDER_API const Color3 DEFAULT_SCREEN_COLOR_LIN_REC709;
 /// @name Shader Utilities
 /// @{
 
-/// Create a shader for a given element.
+/// Create a shader for a given element, reusing a shader from the
+/// shader cache of the given context if one is set.
 MX_RENDER_API ShaderPtr createShader(const string& shaderName, GenContext& context, ElementPtr elem);
 
 /// Create a shader with a constant color output, using the given standard libraries
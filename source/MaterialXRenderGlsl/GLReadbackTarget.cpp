@@ -0,0 +1,150 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXRenderGlsl/GLReadbackTarget.h>
+
+#include <MaterialXRenderGlsl/GlslProgram.h>
+
+#include <MaterialXRender/ShaderRenderer.h>
+
+#include <MaterialXRenderGlsl/External/Glad/glad.h>
+
+#include <cstring>
+
+MATERIALX_NAMESPACE_BEGIN
+
+namespace
+{
+
+const unsigned int READBACK_CHANNELS = 3;
+const GLuint64 WAIT_TIMEOUT_NANOSECONDS = 1000000000;
+
+} // anonymous namespace
+
+//
+// GLReadbackTarget methods
+//
+
+GLReadbackTarget::GLReadbackTarget()
+{
+    if (!glGenBuffers)
+    {
+        gladLoadGL();
+    }
+}
+
+GLReadbackTarget::~GLReadbackTarget()
+{
+    releaseSlots();
+}
+
+void GLReadbackTarget::allocate(unsigned int width, unsigned int height, size_t slotCount)
+{
+    releaseSlots();
+
+    // Render into an sRGB target, so that results match rendering to the back buffer.
+    _framebuffer = GLFramebuffer::create(width, height, 4, Image::BaseType::UINT8);
+
+    size_t byteSize = (size_t) width * height * READBACK_CHANNELS;
+    _slots.resize(slotCount);
+    for (Slot& slot : _slots)
+    {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) byteSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, GlslProgram::UNDEFINED_OPENGL_RESOURCE_ID);
+}
+
+void GLReadbackTarget::beginReadback(size_t slotIndex)
+{
+    if (!_framebuffer || slotIndex >= _slots.size())
+    {
+        throw ExceptionRenderError("Invalid readback slot: " + std::to_string(slotIndex));
+    }
+    Slot& slot = _slots[slotIndex];
+
+    // Pack the framebuffer into the slot's pixel buffer, which returns immediately.
+    _framebuffer->bind();
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glReadPixels(0, 0, _framebuffer->getWidth(), _framebuffer->getHeight(), GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, GlslProgram::UNDEFINED_OPENGL_RESOURCE_ID);
+    _framebuffer->unbind();
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+}
+
+bool GLReadbackTarget::isReadbackComplete(size_t slotIndex)
+{
+    if (slotIndex >= _slots.size() || !_slots[slotIndex].fence)
+    {
+        return false;
+    }
+    GLenum status = glClientWaitSync((GLsync) _slots[slotIndex].fence, 0, 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+ImagePtr GLReadbackTarget::endReadback(size_t slotIndex)
+{
+    if (slotIndex >= _slots.size() || !_slots[slotIndex].fence)
+    {
+        throw ExceptionRenderError("No readback in flight for slot: " + std::to_string(slotIndex));
+    }
+    Slot& slot = _slots[slotIndex];
+
+    GLsync fence = (GLsync) slot.fence;
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    while (status == GL_TIMEOUT_EXPIRED)
+    {
+        status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NANOSECONDS);
+    }
+    glDeleteSync(fence);
+    slot.fence = nullptr;
+    if (status == GL_WAIT_FAILED)
+    {
+        throw ExceptionRenderError("Failed to wait for frame readback");
+    }
+
+    ImagePtr image = Image::create(_framebuffer->getWidth(), _framebuffer->getHeight(), READBACK_CHANNELS);
+    image->createResourceBuffer();
+    size_t byteSize = (size_t) image->getWidth() * image->getHeight() * READBACK_CHANNELS;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr) byteSize, GL_MAP_READ_BIT);
+    if (data)
+    {
+        std::memcpy(image->getResourceBuffer(), data, byteSize);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, GlslProgram::UNDEFINED_OPENGL_RESOURCE_ID);
+    if (!data)
+    {
+        throw ExceptionRenderError("Failed to map frame readback buffer");
+    }
+
+    return image;
+}
+
+void GLReadbackTarget::releaseSlots()
+{
+    for (Slot& slot : _slots)
+    {
+        if (slot.fence)
+        {
+            glDeleteSync((GLsync) slot.fence);
+        }
+        if (slot.buffer)
+        {
+            glDeleteBuffers(1, &slot.buffer);
+        }
+    }
+    _slots.clear();
+    _framebuffer = nullptr;
+}
+
+MATERIALX_NAMESPACE_END
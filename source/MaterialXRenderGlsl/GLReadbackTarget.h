@@ -0,0 +1,73 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_GLREADBACKTARGET_H
+#define MATERIALX_GLREADBACKTARGET_H
+
+/// @file
+/// OpenGL offscreen target with asynchronous readback
+
+#include <MaterialXRenderGlsl/Export.h>
+
+#include <MaterialXRenderGlsl/GLFramebuffer.h>
+
+#include <MaterialXRender/FrameReadback.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+/// Shared pointer to a GLReadbackTarget
+using GLReadbackTargetPtr = std::shared_ptr<class GLReadbackTarget>;
+
+/// @class GLReadbackTarget
+/// An offscreen OpenGL framebuffer whose color contents are read back
+/// asynchronously through a set of pixel buffer objects.
+///
+/// Each readback packs the framebuffer into a pixel buffer object and
+/// inserts a fence, so that the copy proceeds on the GPU while subsequent
+/// frames are rendered.  Images are returned as 8-bit RGB.
+class MX_RENDERGLSL_API GLReadbackTarget : public ReadbackTarget
+{
+  public:
+    /// Create a new readback target
+    static GLReadbackTargetPtr create()
+    {
+        return GLReadbackTargetPtr(new GLReadbackTarget());
+    }
+
+    /// Destructor
+    virtual ~GLReadbackTarget();
+
+    void allocate(unsigned int width, unsigned int height, size_t slotCount) override;
+    void beginReadback(size_t slot) override;
+    bool isReadbackComplete(size_t slot) override;
+    ImagePtr endReadback(size_t slot) override;
+
+    /// Return the framebuffer into which frames are rendered, or nullptr
+    /// if the target has not been allocated.
+    GLFramebufferPtr getFramebuffer() const
+    {
+        return _framebuffer;
+    }
+
+  protected:
+    GLReadbackTarget();
+
+    // Release the pixel buffer objects and fences of all slots.
+    void releaseSlots();
+
+  private:
+    struct Slot
+    {
+        unsigned int buffer = 0;
+        void* fence = nullptr;
+    };
+
+    GLFramebufferPtr _framebuffer;
+    vector<Slot> _slots;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -13,6 +13,8 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <atomic>
+
 MATERIALX_NAMESPACE_BEGIN
 
 const std::string DISTANCE_UNIT_TARGET_NAME = "u_distanceUnitTarget";
@@ -70,24 +72,16 @@ bool GlslMaterial::generateShader(GenContext& context)
     {
         return false;
     }
-    updateTransparency(context);
-
-    GenContext materialContext = context;
-    materialContext.getOptions().hwTransparency = true;
 
     // Initialize in case creation fails and throws an exception
     clearShader();
 
-    _hwShader = createShader("Shader", materialContext, _elem);
-    if (!_hwShader)
+    ShaderPtr hwShader = generateHwShader(context);
+    if (!hwShader)
     {
         return false;
     }
-
-    _glProgram = GlslProgram::create();
-    _glProgram->setStages(_hwShader);
-
-    return true;
+    return generateShader(hwShader);
 }
 
 bool GlslMaterial::generateShader(ShaderPtr hwShader)
@@ -111,7 +105,41 @@ bool GlslMaterial::bindShader() const
     {
         _glProgram->build();
     }
-    return _glProgram->bind();
+    if (!_glProgram->bind())
+    {
+        return false;
+    }
+
+    // A program may be shared by materials with identical sources, so bind
+    // this material's uniform values whenever another material's are bound.
+    if (_glProgram->getUniformOwner() != _uniformOwner)
+    {
+        bindUniformValues();
+        _glProgram->setUniformOwner(_uniformOwner);
+    }
+    return true;
+}
+
+void GlslMaterial::bindUniformValues() const
+{
+    VariableBlock* publicUniforms = getPublicUniforms();
+    if (!publicUniforms)
+    {
+        return;
+    }
+    for (ShaderPort* uniform : publicUniforms->getVariableOrder())
+    {
+        if (uniform->getValue() && UniformHandleTable::getPackedSize(uniform->getType()))
+        {
+            _glProgram->bindUniform(uniform->getVariable(), uniform->getValue(), false);
+        }
+    }
+}
+
+uint64_t GlslMaterial::createUniformOwner()
+{
+    static std::atomic<uint64_t> nextOwner(1);
+    return nextOwner++;
 }
 
 void GlslMaterial::bindMesh(MeshPtr mesh)
@@ -335,12 +363,8 @@ ShaderPort* GlslMaterial::findUniform(const std::string& path) const
     VariableBlock* publicUniforms = getPublicUniforms();
     if (publicUniforms)
     {
-        // Scan block based on path match predicate
-        port = publicUniforms->find(
-            [path](ShaderPort* port)
-            {
-                return (port && stringEndsWith(port->getPath(), path));
-            });
+        // Look up the first port whose path ends with the given path
+        port = publicUniforms->findByPathSuffix(path);
 
         // Check if the uniform exists in the shader program
         if (port && !_glProgram->getUniformsList().count(port->getVariable()))
@@ -365,24 +389,29 @@ void GlslMaterial::modifyUniform(const std::string& path, ConstValuePtr value, s
     }
 
     _glProgram->bindUniform(uniform->getVariable(), value);
+    updateUniformValue(uniform, value, valueString);
+}
 
-    if (valueString.empty())
+void GlslMaterial::bindUniformData(int handle, ShaderPort* uniform, const float* data)
+{
+    const int UNRESOLVED_LOCATION = -2;
+    if (_uniformLocationProgram != _glProgram || _uniformLocationGeneration != _uniformHandles.getGeneration())
     {
-        valueString = value->getValueString();
+        _uniformLocations.clear();
+        _uniformLocationProgram = _glProgram;
+        _uniformLocationGeneration = _uniformHandles.getGeneration();
     }
-    uniform->setValue(Value::createValueFromStrings(valueString, uniform->getType().getName()));
-    if (_doc)
+    if ((size_t) handle >= _uniformLocations.size())
     {
-        ElementPtr element = _doc->getDescendant(uniform->getPath());
-        if (element)
-        {
-            ValueElementPtr valueElement = element->asA<ValueElement>();
-            if (valueElement)
-            {
-                valueElement->setValueString(valueString);
-            }
-        }
+        _uniformLocations.resize((size_t) handle + 1, UNRESOLVED_LOCATION);
+    }
+
+    int& location = _uniformLocations[handle];
+    if (location == UNRESOLVED_LOCATION)
+    {
+        location = _glProgram->getUniformLocation(uniform->getVariable());
     }
+    _glProgram->bindUniformData(location, uniform->getType(), data);
 }
 
 void GlslMaterial::updateTransparency(GenContext& context)
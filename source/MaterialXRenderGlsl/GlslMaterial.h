@@ -25,7 +25,8 @@ class MX_RENDERGLSL_API GlslMaterial : public ShaderMaterial
 {
   public:
     GlslMaterial() :
-        ShaderMaterial()
+        ShaderMaterial(),
+        _uniformOwner(createUniformOwner())
     {
     }
     ~GlslMaterial() { }
@@ -123,8 +124,27 @@ class MX_RENDERGLSL_API GlslMaterial : public ShaderMaterial
 
     void clearProgram();
 
+  protected:
+    void bindUniformData(int handle, ShaderPort* uniform, const float* data) override;
+
+    // Bind the values of all public uniforms to the program, which has
+    // already been bound.
+    void bindUniformValues() const;
+
+    // Return a new identifier for the uniform values of a material.
+    static uint64_t createUniformOwner();
+
   protected:
     GlslProgramPtr _glProgram;
+
+    // Identifier of this material's uniform values, compared against the
+    // owner of a program that may be shared with other materials
+    uint64_t _uniformOwner;
+
+    // Program locations of uniform handles, valid for one program and handle generation
+    vector<int> _uniformLocations;
+    GlslProgramPtr _uniformLocationProgram;
+    size_t _uniformLocationGeneration = 0;
 };
 
 MATERIALX_NAMESPACE_END
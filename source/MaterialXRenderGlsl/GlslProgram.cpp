@@ -23,6 +23,12 @@ namespace
 
 const float PI = std::acos(-1.0f);
 
+string getGlString(GLenum name)
+{
+    const GLubyte* str = glGetString(name);
+    return str ? string(reinterpret_cast<const char*>(str)) : EMPTY_STRING;
+}
+
 } // anonymous namespace
 
 // OpenGL Constants
@@ -30,12 +36,86 @@ unsigned int GlslProgram::UNDEFINED_OPENGL_RESOURCE_ID = 0;
 int GlslProgram::UNDEFINED_OPENGL_PROGRAM_LOCATION = -1;
 int GlslProgram::Input::INVALID_OPENGL_TYPE = -1;
 
+ProgramBinaryCachePtr GlslProgram::_binaryCache;
+
+//
+// GlslProgramBinaryBackend methods
+//
+
+// Backend connecting a GlslProgram to a ProgramBinaryCache.
+class GlslProgramBinaryBackend : public ProgramBinaryBackend
+{
+  public:
+    GlslProgramBinaryBackend(GlslProgram& program) :
+        _program(program)
+    {
+    }
+
+    string getDriverIdentity() override
+    {
+        return getGlString(GL_VENDOR) + "|" + getGlString(GL_RENDERER) + "|" + getGlString(GL_VERSION);
+    }
+
+    void buildFromSource() override
+    {
+        _program.buildFromSource();
+    }
+
+    bool loadBinary(const ProgramBinary& binary) override
+    {
+        if (!glProgramBinary)
+        {
+            return false;
+        }
+
+        _program.clearBuiltData();
+        _program._programId = glCreateProgram();
+        glProgramBinary(_program._programId, binary.format, binary.data.data(), (GLsizei) binary.data.size());
+
+        GLint glStatus = GL_FALSE;
+        glGetProgramiv(_program._programId, GL_LINK_STATUS, &glStatus);
+        if (glStatus == GL_FALSE)
+        {
+            _program.clearBuiltData();
+            return false;
+        }
+        return true;
+    }
+
+    bool getBinary(ProgramBinary& binary) override
+    {
+        if (!glGetProgramBinary || !_program.hasBuiltData())
+        {
+            return false;
+        }
+
+        GLint binaryLength = 0;
+        glGetProgramiv(_program._programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+        if (binaryLength <= 0)
+        {
+            return false;
+        }
+
+        GLenum binaryFormat = 0;
+        GLsizei writtenLength = 0;
+        binary.data.resize((size_t) binaryLength);
+        glGetProgramBinary(_program._programId, binaryLength, &writtenLength, &binaryFormat, binary.data.data());
+        binary.data.resize((size_t) writtenLength);
+        binary.format = binaryFormat;
+        return writtenLength > 0;
+    }
+
+  private:
+    GlslProgram& _program;
+};
+
 //
 // GlslProgram methods
 //
 
 GlslProgram::GlslProgram() :
     _programId(UNDEFINED_OPENGL_RESOURCE_ID),
+    _uniformOwner(0),
     _shader(nullptr),
     _vertexArray(UNDEFINED_OPENGL_RESOURCE_ID)
 {
@@ -82,6 +162,19 @@ const string& GlslProgram::getStageSourceCode(const string& stage) const
 }
 
 void GlslProgram::build()
+{
+    if (_binaryCache)
+    {
+        GlslProgramBinaryBackend backend(*this);
+        _binaryCache->build(_stages, backend);
+    }
+    else
+    {
+        buildFromSource();
+    }
+}
+
+void GlslProgram::buildFromSource()
 {
     clearBuiltData();
 
@@ -167,6 +260,10 @@ void GlslProgram::build()
         _programId = glCreateProgram();
         glAttachShader(_programId, vertexShaderId);
         glAttachShader(_programId, fragmentShaderId);
+        if (_binaryCache && glProgramParameteri)
+        {
+            glProgramParameteri(_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
         glLinkProgram(_programId);
 
         // Check the program
@@ -226,6 +323,7 @@ void GlslProgram::clearBuiltData()
         _programId = UNDEFINED_OPENGL_RESOURCE_ID;
     }
 
+    _uniformOwner = 0;
     _uniformList.clear();
     _attributeList.clear();
 }
@@ -723,6 +821,66 @@ void GlslProgram::bindUniform(const string& name, ConstValuePtr value, bool erro
     }
 }
 
+int GlslProgram::getUniformLocation(const string& name)
+{
+    const GlslProgram::InputMap& uniformList = getUniformsList();
+    auto input = uniformList.find(name);
+    if (input == uniformList.end() || input->second->location < 0)
+    {
+        return UNDEFINED_OPENGL_PROGRAM_LOCATION;
+    }
+    return input->second->location;
+}
+
+void GlslProgram::bindUniformData(int location, TypeDesc type, const float* data)
+{
+    if (_programId == UNDEFINED_OPENGL_RESOURCE_ID)
+    {
+        throw ExceptionRenderError("Cannot bind without a valid program");
+    }
+    if (location < 0)
+    {
+        return;
+    }
+
+    if (type == Type::FLOAT)
+    {
+        glUniform1f(location, data[0]);
+    }
+    else if (type == Type::INTEGER)
+    {
+        glUniform1i(location, (int) data[0]);
+    }
+    else if (type == Type::BOOLEAN)
+    {
+        glUniform1i(location, data[0] != 0.0f ? 1 : 0);
+    }
+    else if (type.isFloat2())
+    {
+        glUniform2fv(location, 1, data);
+    }
+    else if (type.isFloat3())
+    {
+        glUniform3fv(location, 1, data);
+    }
+    else if (type.isFloat4())
+    {
+        glUniform4fv(location, 1, data);
+    }
+    else if (type == Type::MATRIX33)
+    {
+        glUniformMatrix3fv(location, 1, GL_FALSE, data);
+    }
+    else if (type == Type::MATRIX44)
+    {
+        glUniformMatrix4fv(location, 1, GL_FALSE, data);
+    }
+    else
+    {
+        throw ExceptionRenderError("Unsupported data type when setting uniform data");
+    }
+}
+
 void GlslProgram::bindUniformLocation(int location, ConstValuePtr value)
 {
     if (_programId == UNDEFINED_OPENGL_RESOURCE_ID)
@@ -15,6 +15,7 @@
 #include <MaterialXRender/GeometryHandler.h>
 #include <MaterialXRender/ImageHandler.h>
 #include <MaterialXRender/LightHandler.h>
+#include <MaterialXRender/ProgramBinaryCache.h>
 
 #include <MaterialXGenShader/Shader.h>
 
@@ -80,6 +81,20 @@ class MX_RENDERGLSL_API GlslProgram
     // Clear built shader program data, if any.
     void clearBuiltData();
 
+    /// Set the program binary cache used when building programs.  When a cache
+    /// is set, programs are loaded from previously stored binaries where possible,
+    /// falling back to compilation from source.  Defaults to no cache.
+    static void setBinaryCache(ProgramBinaryCachePtr cache)
+    {
+        _binaryCache = cache;
+    }
+
+    /// Return the program binary cache used when building programs, if any.
+    static ProgramBinaryCachePtr getBinaryCache()
+    {
+        return _binaryCache;
+    }
+
     /// @}
     /// @name Program introspection
     /// @{
@@ -165,6 +180,28 @@ class MX_RENDERGLSL_API GlslProgram
     /// Bind a value to the uniform with the given name.
     void bindUniform(const string& name, ConstValuePtr value, bool errorIfMissing = true);
 
+    /// Return the location of the uniform with the given name, or
+    /// UNDEFINED_OPENGL_PROGRAM_LOCATION if no such uniform is present.
+    int getUniformLocation(const string& name);
+
+    /// Bind packed float data of the given type to the uniform at the given
+    /// location.  Integer and boolean values are converted from floats.
+    void bindUniformData(int location, TypeDesc type, const float* data);
+
+    /// Set the identifier of the material whose uniform values are bound to
+    /// this program, allowing a program to be shared between materials.
+    void setUniformOwner(uint64_t owner)
+    {
+        _uniformOwner = owner;
+    }
+
+    /// Return the identifier of the material whose uniform values are bound
+    /// to this program, or zero if no material has bound its values.
+    uint64_t getUniformOwner() const
+    {
+        return _uniformOwner;
+    }
+
     /// Bind attribute buffers to attribute inputs.
     /// A hardware buffer of the given attribute type is created and bound to the program locations
     /// for the input attribute.
@@ -215,6 +252,9 @@ class MX_RENDERGLSL_API GlslProgram
   protected:
     GlslProgram();
 
+    // Compile and link the program from the source code of each stage.
+    void buildFromSource();
+
     // Update a list of program input uniforms
     const InputMap& updateUniformsList();
 
@@ -236,6 +276,11 @@ class MX_RENDERGLSL_API GlslProgram
     void bindUniformLocation(int location, ConstValuePtr value);
 
   private:
+    friend class GlslProgramBinaryBackend;
+
+    // Optional cache of program binaries shared by all programs
+    static ProgramBinaryCachePtr _binaryCache;
+
     // Stages used to create program
     // Map of stage name and its source code
     StringMap _stages;
@@ -243,6 +288,9 @@ class MX_RENDERGLSL_API GlslProgram
     // Generated program. A non-zero number indicates a valid shader program.
     unsigned int _programId;
 
+    // Material whose uniform values are bound to the program
+    uint64_t _uniformOwner;
+
     // List of program input uniforms
     InputMap _uniformList;
     // List of program input attributes
@@ -47,6 +47,10 @@ class MX_RENDERMSL_API MslMaterial : public ShaderMaterial
 
     /// Generate a shader from the given hardware shader.
     bool generateShader(ShaderPtr hwShader) override;
+
+    /// Generate a hardware shader for the element of this material, with
+    /// transparency enabled only for transparent surfaces.
+    ShaderPtr generateHwShader(GenContext& context) override;
     
     /// Copy shader from one material to this one
     void copyShader(MaterialPtr material) override
@@ -115,6 +119,7 @@ class MX_RENDERMSL_API MslMaterial : public ShaderMaterial
                               LightHandlerPtr lightHandler);
   protected:
     void clearShader() override;
+    void bindUniformData(int handle, ShaderPort* uniform, const float* data) override;
     
   protected:
     MslProgramPtr _glProgram;
@@ -62,25 +62,28 @@ bool MslMaterial::generateShader(GenContext& context)
         return false;
     }
 
-    _hasTransparency = isTransparentSurface(_elem, context.getShaderGenerator().getTarget());
-
-    GenContext materialContext = context;
-    materialContext.getOptions().hwTransparency = _hasTransparency;
-
     // Initialize in case creation fails and throws an exception
     clearShader();
 
-    _hwShader = createShader("Shader", materialContext, _elem);
-    if (!_hwShader)
+    ShaderPtr hwShader = generateHwShader(context);
+    if (!hwShader)
     {
         return false;
     }
+    return generateShader(hwShader);
+}
 
-    _glProgram = MslProgram::create();
-    _glProgram->setStages(_hwShader);
-    _glProgram->build(MTL(device), MTL(currentFramebuffer()));
+ShaderPtr MslMaterial::generateHwShader(GenContext& context)
+{
+    if (!_elem)
+    {
+        return nullptr;
+    }
+    _hasTransparency = isTransparentSurface(_elem, context.getShaderGenerator().getTarget());
 
-    return true;
+    GenContext materialContext = context;
+    materialContext.getOptions().hwTransparency = _hasTransparency;
+    return createShader("Shader", materialContext, _elem);
 }
 
 bool MslMaterial::generateShader(ShaderPtr hwShader)
@@ -287,12 +290,8 @@ ShaderPort* MslMaterial::findUniform(const std::string& path) const
     VariableBlock* publicUniforms = getPublicUniforms();
     if (publicUniforms)
     {
-        // Scan block based on path match predicate
-        port = publicUniforms->find(
-            [path](ShaderPort* port)
-            {
-                return (port && stringEndsWith(port->getPath(), path));
-            });
+        // Look up the first port whose path ends with the given path
+        port = publicUniforms->findByPathSuffix(path);
 
         // Check if the uniform exists in the shader program
         if (port && !_glProgram->getUniformsList().count(
@@ -314,25 +313,13 @@ void MslMaterial::modifyUniform(const std::string& path, ConstValuePtr value, st
     }
 
     _glProgram->bindUniform(uniform->getVariable(), value);
+    updateUniformValue(uniform, value, valueString);
+}
 
-    if (valueString.empty())
-    {
-        valueString = value->getValueString();
-    }
-    uniform->setValue(Value::createValueFromStrings(valueString, uniform->getType().getName()));
-    if (_doc)
-    {
-        ElementPtr element = _doc->getDescendant(uniform->getPath());
-        if (element)
-        {
-            ValueElementPtr valueElement = element->asA<ValueElement>();
-            if (valueElement)
-            {
-                valueElement->setValueString(valueString);
-            }
-        }
-    }
+void MslMaterial::bindUniformData(int, ShaderPort* uniform, const float*)
+{
+    // Metal programs are bound from uniform values, which have already been updated.
+    _glProgram->bindUniform(uniform->getVariable(), uniform->getValue());
 }
 
 MATERIALX_NAMESPACE_END
-
@@ -36,6 +36,11 @@ TEST_CASE("String utilities", "[coreutil]")
     REQUIRE(!mx::stringStartsWith("testName", "Name"));
     REQUIRE(mx::stringEndsWith("testName", "Name"));
     REQUIRE(!mx::stringEndsWith("testName", "test"));
+
+    REQUIRE(mx::hashString("") == 0xcbf29ce484222325ull);
+    REQUIRE(mx::hashString("a") == 0xaf63dc4c8601ec8cull);
+    REQUIRE(mx::hashString("testName") == mx::hashString("Name", mx::hashString("test")));
+    REQUIRE(mx::hashString("testName") != mx::hashString("testname"));
 }
 
 TEST_CASE("Print utilities", "[coreutil]")
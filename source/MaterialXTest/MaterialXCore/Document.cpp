@@ -10,6 +10,10 @@
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <map>
+#include <set>
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Document", "[document]")
@@ -116,3 +120,298 @@ TEST_CASE("Document", "[document]")
     // Validate the combined document.
     REQUIRE(doc->validate());
 }
+
+namespace
+{
+
+// Verify that the incrementally maintained cache of the given document
+// matches a cache rebuilt from the document tree.
+void checkDocumentCache(mx::DocumentPtr doc)
+{
+    std::set<std::string> portKeys, nodeDefKeys, implKeys;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        for (const std::string& attr : { mx::PortElement::NODE_NAME_ATTRIBUTE, mx::PortElement::NODE_GRAPH_ATTRIBUTE })
+        {
+            if (elem->hasAttribute(attr))
+            {
+                portKeys.insert(elem->getQualifiedName(elem->getAttribute(attr)));
+            }
+        }
+        if (elem->hasAttribute(mx::NodeDef::NODE_ATTRIBUTE))
+        {
+            nodeDefKeys.insert(elem->getQualifiedName(elem->getAttribute(mx::NodeDef::NODE_ATTRIBUTE)));
+        }
+        if (elem->hasAttribute(mx::InterfaceElement::NODE_DEF_ATTRIBUTE))
+        {
+            implKeys.insert(elem->getQualifiedName(elem->getAttribute(mx::InterfaceElement::NODE_DEF_ATTRIBUTE)));
+        }
+    }
+
+    std::map<std::string, std::vector<mx::PortElementPtr>> ports;
+    std::map<std::string, std::vector<mx::NodeDefPtr>> nodeDefs;
+    std::map<std::string, std::vector<mx::InterfaceElementPtr>> impls;
+    for (const std::string& key : portKeys)
+    {
+        ports[key] = doc->getMatchingPorts(key);
+    }
+    for (const std::string& key : nodeDefKeys)
+    {
+        nodeDefs[key] = doc->getMatchingNodeDefs(key);
+    }
+    for (const std::string& key : implKeys)
+    {
+        impls[key] = doc->getMatchingImplementations(key);
+    }
+
+    doc->invalidateCache();
+    for (const std::string& key : portKeys)
+    {
+        REQUIRE(doc->getMatchingPorts(key) == ports[key]);
+    }
+    for (const std::string& key : nodeDefKeys)
+    {
+        REQUIRE(doc->getMatchingNodeDefs(key) == nodeDefs[key]);
+    }
+    for (const std::string& key : implKeys)
+    {
+        REQUIRE(doc->getMatchingImplementations(key) == impls[key]);
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("Document: Incremental Cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+    REQUIRE(!doc->getMatchingNodeDefs("add").empty());
+
+    // Build a chain of nodes, with nodedef and port lookups between edits.
+    const size_t NODE_COUNT = 500;
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    mx::NodePtr previous;
+    for (size_t i = 0; i < NODE_COUNT; i++)
+    {
+        mx::NodePtr node = graph->addNode("add", "node" + std::to_string(i), "float");
+        REQUIRE(node->getNodeDef());
+        if (previous)
+        {
+            node->setConnectedNode("in1", previous);
+            REQUIRE(doc->getMatchingPorts(previous->getName()).size() == 1);
+        }
+        previous = node;
+    }
+    checkDocumentCache(doc);
+
+    // Rename, disconnect, and remove nodes.
+    graph->getNode("node10")->setName("renamed");
+    graph->getNode("node20")->getInput("in1")->setConnectedNode(nullptr);
+    graph->getNode("node30")->getInput("in1")->setNodeGraphString("graph");
+    mx::NodePtr removed = graph->getNode("node40");
+    graph->removeNode("node40");
+    REQUIRE(doc->getMatchingPorts("node39").empty());
+    REQUIRE(doc->getMatchingPorts("node40").size() == 1);
+    checkDocumentCache(doc);
+
+    // Edits to removed elements don't affect the document.
+    removed->getInput("in1")->setNodeName("node50");
+    REQUIRE(doc->getMatchingPorts("node50").size() == 1);
+    checkDocumentCache(doc);
+
+    // Add nodedefs in the middle and at the end of the document.
+    size_t addCount = doc->getMatchingNodeDefs("add").size();
+    doc->getNodeDef("ND_multiply_float")->setNodeString("add");
+    mx::NodeDefPtr customNodeDef = doc->addNodeDef("ND_custom_add", "float", "add");
+    REQUIRE(doc->getMatchingNodeDefs("add").size() == addCount + 2);
+    REQUIRE(doc->getMatchingNodeDefs("add").back() == customNodeDef);
+    checkDocumentCache(doc);
+
+    // Reference a nodegraph implementation before and after it exists.
+    mx::ImplementationPtr customImpl = doc->addImplementation("IM_custom_add");
+    customImpl->setNodeDef(customNodeDef);
+    customImpl->setNodeGraph("NG_custom_add");
+    REQUIRE(doc->getMatchingImplementations("ND_custom_add").empty());
+    mx::NodeGraphPtr customGraph = doc->addNodeGraph("NG_custom_add");
+    REQUIRE(doc->getMatchingImplementations("ND_custom_add").size() == 1);
+    REQUIRE(doc->getMatchingImplementations("ND_custom_add")[0] == customGraph);
+    customGraph->setName("NG_custom_add_renamed");
+    REQUIRE(doc->getMatchingImplementations("ND_custom_add").empty());
+    checkDocumentCache(doc);
+
+    // Namespaces qualify the names of all descendants.
+    graph->setNamespace("custom");
+    REQUIRE(doc->getMatchingPorts("node100").empty());
+    REQUIRE(doc->getMatchingPorts("custom:node100").size() == 1);
+    checkDocumentCache(doc);
+
+    // Copied and imported content is cached.
+    mx::NodeGraphPtr graphCopy = doc->addNodeGraph("graph_copy");
+    graphCopy->copyContentFrom(graph);
+    REQUIRE(doc->getMatchingPorts("custom:node100").size() == 2);
+    mx::DocumentPtr library = mx::createDocument();
+    library->setNamespace("lib");
+    library->addNodeDef("ND_lib_add", "float", "add");
+    doc->importLibrary(library);
+    REQUIRE(doc->getMatchingNodeDefs("lib:add").size() == 1);
+    checkDocumentCache(doc);
+
+    // Lookups on an unmodified document share the same cached snapshot.
+    REQUIRE(&doc->getMatchingNodeDefs("add").getVector() == &doc->getMatchingNodeDefs("add").getVector());
+    REQUIRE(&doc->getMatchingNodeDefs("unknown").getVector() == &doc->getMatchingNodeDefs("unknown").getVector());
+
+    // Snapshots held by callers are unaffected by later edits.
+    mx::ElementSpan<mx::NodeDef> addNodeDefs = doc->getMatchingNodeDefs("add");
+    const std::vector<mx::NodeDefPtr> addNodeDefsCopy = addNodeDefs;
+    for (const mx::NodeDefPtr& nodeDef : addNodeDefs)
+    {
+        doc->addNodeDef(mx::EMPTY_STRING, nodeDef->getType(), "add");
+    }
+    REQUIRE(addNodeDefs == addNodeDefsCopy);
+    REQUIRE(doc->getMatchingNodeDefs("add").size() == 2 * addNodeDefsCopy.size());
+    doc->removeNodeDef(customNodeDef->getName());
+    REQUIRE(addNodeDefs == addNodeDefsCopy);
+    checkDocumentCache(doc);
+}
+
+TEST_CASE("Document: Data Library", "[document]")
+{
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), library);
+    size_t libraryChildCount = library->getChildren().size();
+
+    // Reference the library from a working document.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setDataLibrary(library);
+    REQUIRE(doc->hasDataLibrary());
+    REQUIRE(doc->getDataLibrary() == library);
+    REQUIRE_THROWS_AS(library->setDataLibrary(library), mx::Exception);
+
+    // Resolve definitions through the data library.
+    mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+    mx::NodePtr image = graph->addNode("image", "image1", "color3");
+    mx::NodePtr multiply = graph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", image);
+    multiply->setNodeDefString("ND_multiply_color3");
+    mx::OutputPtr output = graph->addOutput("out", "color3");
+    output->setConnectedNode(multiply);
+    REQUIRE(image->getNodeDef() == library->getNodeDef("ND_image_color3"));
+    REQUIRE(multiply->getNodeDef() == library->getNodeDef("ND_multiply_color3"));
+    REQUIRE(image->getNodeDef()->getImplementation("genglsl"));
+    REQUIRE(output->getTypeDef() == library->getTypeDef("color3"));
+    REQUIRE(doc->getNodeDef("ND_image_color3") == library->getNodeDef("ND_image_color3"));
+    REQUIRE(doc->getNodeDefs().size() == library->getNodeDefs().size());
+    REQUIRE(doc->getMatchingNodeDefs("image") == library->getMatchingNodeDefs("image"));
+    REQUIRE(doc->validate());
+
+    // Library content is not copied into the working document.
+    REQUIRE(doc->getChildren().size() == 1);
+    REQUIRE(library->getChildren().size() == libraryChildCount);
+
+    // Local definitions take precedence over those of the data library.
+    mx::NodeDefPtr customNodeDef = doc->addNodeDef("ND_image_color3", "color3", "image");
+    REQUIRE(doc->getNodeDef("ND_image_color3") == customNodeDef);
+    REQUIRE(doc->getNodeDefs().size() == library->getNodeDefs().size());
+    REQUIRE(doc->getMatchingNodeDefs("image").size() == library->getMatchingNodeDefs("image").size() + 1);
+    REQUIRE(doc->getMatchingNodeDefs("image")[0] == customNodeDef);
+    doc->removeNodeDef("ND_image_color3");
+    REQUIRE(doc->getMatchingNodeDefs("image") == library->getMatchingNodeDefs("image"));
+
+    // A single data library may be shared by many documents.
+    mx::DocumentPtr copy = doc->copy();
+    REQUIRE(copy->getDataLibrary() == library);
+    REQUIRE(copy->getNodeGraph("graph")->getNode("image1")->getNodeDef() == image->getNodeDef());
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Document: Cache Performance", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+
+    BENCHMARK("Build a 5000-node graph with interleaved lookups")
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph("graph");
+        mx::NodePtr previous;
+        size_t resolved = 0;
+        for (size_t i = 0; i < 5000; i++)
+        {
+            mx::NodePtr node = graph->addNode("add", "node" + std::to_string(i), "float");
+            if (node->getNodeDef())
+            {
+                resolved++;
+            }
+            if (previous)
+            {
+                node->setConnectedNode("in1", previous);
+            }
+            previous = node;
+        }
+        doc->removeNodeGraph(graph->getName());
+        return resolved;
+    };
+}
+
+TEST_CASE("Document: Concurrent Lookups", "[document]")
+{
+    mx::DocumentPtr library = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), library);
+
+    std::vector<std::string> nodeNames;
+    for (mx::NodeDefPtr nodeDef : library->getNodeDefs())
+    {
+        nodeNames.push_back(nodeDef->getNodeString());
+    }
+
+    // A working document referencing the library, with local definitions
+    // that are layered over those of the library.
+    mx::DocumentPtr layeredDoc = mx::createDocument();
+    layeredDoc->setDataLibrary(library);
+    for (size_t i = 0; i < nodeNames.size(); i += 10)
+    {
+        layeredDoc->addNodeDef(mx::EMPTY_STRING, "float", nodeNames[i]);
+    }
+
+    // Resolve every nodedef and implementation of the library from many
+    // threads at once, returning the count resolved by the first thread.
+    const size_t THREAD_COUNT = std::max(std::thread::hardware_concurrency(), 2u);
+    auto resolveConcurrently = [&nodeNames, THREAD_COUNT](mx::ConstDocumentPtr doc)
+    {
+        std::vector<std::thread> threads;
+        std::vector<size_t> resolved(THREAD_COUNT, 0);
+        for (size_t i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back([&doc, &nodeNames, &resolved, i]()
+            {
+                for (const std::string& nodeName : nodeNames)
+                {
+                    for (const mx::NodeDefPtr& nodeDef : doc->getMatchingNodeDefs(nodeName))
+                    {
+                        if (!doc->getMatchingImplementations(nodeDef->getName()).empty())
+                        {
+                            resolved[i]++;
+                        }
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        return resolved[0];
+    };
+
+    library->invalidateCache();
+    BENCHMARK("Resolve nodedefs and implementations from " + std::to_string(THREAD_COUNT) + " threads")
+    {
+        return resolveConcurrently(library);
+    };
+
+    layeredDoc->invalidateCache();
+    BENCHMARK("Resolve layered nodedefs and implementations from " + std::to_string(THREAD_COUNT) + " threads")
+    {
+        return resolveConcurrently(layeredDoc);
+    };
+}
+#endif
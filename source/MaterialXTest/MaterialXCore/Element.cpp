@@ -6,6 +6,7 @@
 #include <MaterialXTest/External/Catch/catch.hpp>
 
 #include <MaterialXCore/Document.h>
+#include <MaterialXFormat/Util.h>
 
 namespace mx = MaterialX;
 
@@ -40,6 +41,50 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem1->getTypedAttribute<bool>("customColor") == false);
     REQUIRE(elem1->getTypedAttribute<mx::Color3>("customFlag") == mx::Color3(0.0f));
 
+    // Categories and attribute names are interned.
+    REQUIRE(&mx::internString("customFlag") == &mx::internString(std::string("custom") + "Flag"));
+    REQUIRE(&mx::internString(mx::Element::NAME_ATTRIBUTE) == &mx::Element::NAME_ATTRIBUTE);
+    REQUIRE(&mx::internString("nodename") == &mx::PortElement::NODE_NAME_ATTRIBUTE);
+    REQUIRE(&mx::internString("nodegraph") == &mx::PortElement::NODE_GRAPH_ATTRIBUTE);
+    REQUIRE(&mx::internString("nodedef") == &mx::InterfaceElement::NODE_DEF_ATTRIBUTE);
+    REQUIRE(&mx::internString("node") == &mx::NodeDef::NODE_ATTRIBUTE);
+    REQUIRE(&mx::internString("version") == &mx::InterfaceElement::VERSION_ATTRIBUTE);
+    REQUIRE(&elem1->getCategory() == &elem2->getCategory());
+    REQUIRE(elem1->getAttributeNames() == mx::StringVec({ "customFlag", "customColor" }));
+    elem1->removeAttribute("customFlag");
+    REQUIRE(!elem1->hasAttribute("customFlag"));
+    REQUIRE(elem1->getAttributeNames() == mx::StringVec({ "customColor" }));
+    elem1->setTypedAttribute<bool>("customFlag", true);
+
+    // Elements with many attributes preserve their attribute order.
+    mx::StringVec attrNames;
+    for (int i = 0; i < 40; i++)
+    {
+        std::string attrName = "attr" + std::to_string(i);
+        elem2->setAttribute(attrName, std::to_string(i));
+        attrNames.push_back(attrName);
+    }
+    REQUIRE(elem2->getAttributeNames() == attrNames);
+    REQUIRE(elem2->getAttribute("attr25") == "25");
+    elem2->removeAttribute("attr10");
+    attrNames.erase(attrNames.begin() + 10);
+    REQUIRE(!elem2->hasAttribute("attr10"));
+    REQUIRE(elem2->getAttribute("attr25") == "25");
+    REQUIRE(elem2->getAttributeNames() == attrNames);
+    REQUIRE(elem2->getAttributeCount() == attrNames.size());
+    mx::StringVec visitedNames;
+    elem2->forEachAttribute([&](const std::string& attrName, const std::string& attrValue)
+    {
+        REQUIRE(attrValue == elem2->getAttribute(attrName));
+        visitedNames.push_back(attrName);
+    });
+    REQUIRE(visitedNames == attrNames);
+    for (const std::string& attrName : attrNames)
+    {
+        elem2->removeAttribute(attrName);
+    }
+    REQUIRE(elem2->getAttributeNames().empty());
+
     // Modify element names.
     elem1->setName("elem1");
     elem2->setName("elem2");
@@ -68,4 +113,164 @@ TEST_CASE("Element", "[element]")
         REQUIRE(orphan);
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement);
+
+    // Typed values are cached until the value or type is modified.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::InputPtr input = nodeGraph->addInput("input1", "float");
+    REQUIRE(!input->getValue());
+    input->setValue(0.5f);
+    mx::ConstValuePtr value = input->getValue();
+    REQUIRE(value->asA<float>() == 0.5f);
+    REQUIRE(input->getValue() == value);
+    input->setValueString("0.25");
+    REQUIRE(input->getValue() != value);
+    REQUIRE(input->getValue()->asA<float>() == 0.25f);
+    input->setType("boolean");
+    REQUIRE(!input->getValue());
+    input->setType("integer");
+    input->setValueString("3");
+    REQUIRE(input->getValue()->asA<int>() == 3);
+    input->setValueString("invalid");
+    REQUIRE(!input->getValue());
+    REQUIRE(!input->getValue());
+    input->setValueString("4");
+    REQUIRE(input->getValue()->asA<int>() == 4);
+    input->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!input->getValue());
+    mx::DocumentPtr doc4 = doc->copy();
+    REQUIRE(!doc4->getDescendant(input->getNamePath())->asA<mx::Input>()->getValue());
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+namespace
+{
+
+size_t countedBytes = 0;
+
+// An allocator counting the bytes it currently holds in countedBytes.
+template <class T> struct CountingAllocator
+{
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <class U> CountingAllocator(const CountingAllocator<U>&) { }
+
+    T* allocate(size_t n)
+    {
+        countedBytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n)
+    {
+        countedBytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <class U> bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+using CountedString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+
+struct CountedStringHash
+{
+    size_t operator()(const CountedString& str) const
+    {
+        return std::hash<std::string_view>()(std::string_view(str.data(), str.size()));
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("Element: Attribute Storage", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, mx::getDefaultDataSearchPath(), doc);
+
+    std::vector<mx::ElementPtr> elements;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        elements.push_back(elem);
+    }
+
+    // Measure the attribute storage per element, including heap allocations,
+    // for the previous layout of an unordered map of values with a vector of
+    // names, and for the current vector of attributes with its optional index.
+    // Both layouts are rebuilt attribute by attribute, as when reading a file.
+    const size_t ATTRIBUTE_INDEX_THRESHOLD = 16;
+    size_t mapBytes = 0;
+    size_t vectorBytes = 0;
+    for (const mx::ElementPtr& elem : elements)
+    {
+        const mx::StringVec names = elem->getAttributeNames();
+        {
+            using ValueMap = std::unordered_map<CountedString, CountedString, CountedStringHash, std::equal_to<CountedString>,
+                                                CountingAllocator<std::pair<const CountedString, CountedString>>>;
+            ValueMap values;
+            std::vector<CountedString, CountingAllocator<CountedString>> order;
+            for (const std::string& name : names)
+            {
+                values[CountedString(name.data(), name.size())] = CountedString(elem->getAttribute(name).c_str());
+                order.emplace_back(name.data(), name.size());
+            }
+            mapBytes += countedBytes + sizeof(values) + sizeof(order);
+        }
+        {
+            using Attribute = std::pair<const std::string*, CountedString>;
+            using AttributeIndex = std::unordered_map<const std::string*, size_t, std::hash<const std::string*>, std::equal_to<const std::string*>,
+                                                      CountingAllocator<std::pair<const std::string* const, size_t>>>;
+            std::vector<Attribute, CountingAllocator<Attribute>> attributes;
+            std::unique_ptr<AttributeIndex> index;
+            for (const std::string& name : names)
+            {
+                attributes.emplace_back(&mx::internString(name), CountedString(elem->getAttribute(name).c_str()));
+                if (index)
+                {
+                    index->emplace(attributes.back().first, attributes.size() - 1);
+                }
+                else if (attributes.size() > ATTRIBUTE_INDEX_THRESHOLD)
+                {
+                    index = std::make_unique<AttributeIndex>();
+                    for (size_t i = 0; i < attributes.size(); i++)
+                    {
+                        index->emplace(attributes[i].first, i);
+                    }
+                }
+            }
+            vectorBytes += countedBytes + sizeof(attributes) + sizeof(index) + (index ? sizeof(AttributeIndex) : 0);
+        }
+    }
+    WARN("Attribute storage per element: " << mapBytes / elements.size() << " bytes with a map of values, " <<
+         vectorBytes / elements.size() << " bytes with a vector of attributes");
+    REQUIRE(vectorBytes < mapBytes);
+
+    BENCHMARK("Copy the data libraries")
+    {
+        return doc->copy();
+    };
+
+    BENCHMARK("Get typed attributes of " + std::to_string(elements.size()) + " elements")
+    {
+        size_t found = 0;
+        for (const mx::ElementPtr& elem : elements)
+        {
+            found += elem->hasAttribute(mx::TypedElement::TYPE_ATTRIBUTE);
+            found += elem->getAttribute(mx::ValueElement::VALUE_ATTRIBUTE).size();
+        }
+        return found;
+    };
+
+    const std::string NODE_ATTRIBUTE = "node";
+    const std::string NODEDEF_ATTRIBUTE = "nodedef";
+    BENCHMARK("Get named attributes of " + std::to_string(elements.size()) + " elements")
+    {
+        size_t found = 0;
+        for (const mx::ElementPtr& elem : elements)
+        {
+            found += elem->getAttribute(NODE_ATTRIBUTE).size();
+            found += elem->getAttribute(NODEDEF_ATTRIBUTE).size();
+        }
+        return found;
+    };
 }
+#endif
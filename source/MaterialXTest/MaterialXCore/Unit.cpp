@@ -157,7 +157,7 @@ TEST_CASE("UnitDocument", "[unit]")
                     for (mx::InputPtr input : pNode->getInputs())
                     {
                         const std::string type = input->getType();
-                        const mx::ValuePtr value = input->getValue();
+                        mx::ConstValuePtr value = input->getValue();
                         if (input->hasUnit() && value)
                         {
                             if (type == "float")
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
+#include <MaterialXCore/ValueStream.inl>
+
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -65,6 +68,22 @@ TEST_CASE("Value strings", "[value]")
         REQUIRE(mx::toValueString(0.1234f) == "0.12");
     }
 
+    // Float formatting scopes are nested, and apply only to the calling thread.
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatFixed, 3);
+        {
+            mx::ScopedFloatFormatting innerFmt(mx::Value::FloatFormatScientific);
+            REQUIRE(mx::toValueString(0.1234f) == "1.234e-01");
+        }
+        std::string threadString;
+        std::thread thread([&threadString]() { threadString = mx::toValueString(0.1234f); });
+        thread.join();
+        REQUIRE(threadString == "0.1234");
+        REQUIRE(mx::toValueString(0.1234f) == "0.123");
+    }
+    REQUIRE(mx::Value::getFloatFormat() == mx::Value::FloatFormatDefault);
+    REQUIRE(mx::Value::getFloatPrecision() == 6);
+
     // Convert from value strings to data values.
     REQUIRE(mx::fromValueString<int>("1") == 1);
     REQUIRE(mx::fromValueString<float>("1") == 1.0f);
@@ -78,6 +97,92 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE_THROWS_AS(mx::fromValueString<float>("text"), mx::ExceptionTypeError);
     REQUIRE_THROWS_AS(mx::fromValueString<bool>("1"), mx::ExceptionTypeError);
     REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1, 1, 1, 1"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Matrix33>("1, 1, 1"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::IntVec>("1, text"), mx::ExceptionTypeError);
+
+    // Verify that parsing matches stream extraction in the classic locale.
+    REQUIRE(mx::fromValueString<int>(" +12") == 12);
+    REQUIRE(mx::fromValueString<int>("-3") == -3);
+    REQUIRE(mx::fromValueString<float>("1e-3") == 0.001f);
+    REQUIRE(mx::fromValueString<float>(".5") == 0.5f);
+    REQUIRE(mx::fromValueString<mx::Vector2>("0.25,0.5") == mx::Vector2(0.25f, 0.5f));
+    REQUIRE(mx::fromValueString<mx::FloatVec>(" 1.5 ,2, 3 ") == mx::FloatVec{ 1.5f, 2.0f, 3.0f });
+    REQUIRE(mx::fromValueString<mx::StringVec>("a b, ,c") == mx::StringVec{ "a b", "", "c" });
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("+-1"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e100"), mx::ExceptionTypeError);
+
+    // Verify that formatting matches stream insertion in the classic locale.
+    REQUIRE(mx::toValueString(0.1f) == "0.1");
+    REQUIRE(mx::toValueString(1e-7f) == "1e-07");
+    REQUIRE(mx::toValueString(1234567.0f) == "1.23457e+06");
+    REQUIRE(mx::toValueString(-2.5) == "-2.5");
+    REQUIRE(mx::toValueString(mx::Matrix33::IDENTITY) == "1, 0, 0, 0, 1, 0, 0, 0, 1");
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatFixed, 40);
+        REQUIRE(mx::toValueString(1e30f).size() == 72);
+    }
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatFixed, 200);
+        REQUIRE(mx::toValueString(1e300).size() == 502);
+    }
+}
+
+TEST_CASE("Value stream fallback", "[value]")
+{
+    // Verify that the stream path, used where <charconv> lacks floating-point
+    // support, parses numeric tokens in the same way as the default path.
+    auto parseFloat = [](const std::string& token, float& data)
+    {
+        return mx::streamToData(token.data(), token.data() + token.size(), data);
+    };
+    auto parseInt = [](const std::string& token, int& data)
+    {
+        return mx::streamToData(token.data(), token.data() + token.size(), data);
+    };
+    for (const std::string& token : mx::StringVec{ "1", " +12", "-3", "1e-3", ".5", "0.1234567", "2.5text" })
+    {
+        float data = 0.0f;
+        REQUIRE(parseFloat(token, data));
+        REQUIRE(data == mx::fromValueString<float>(token));
+    }
+    for (const std::string& token : mx::StringVec{ "1", " +12", "-3" })
+    {
+        int data = 0;
+        REQUIRE(parseInt(token, data));
+        REQUIRE(data == mx::fromValueString<int>(token));
+    }
+    float floatData = 0.0f;
+    int intData = 0;
+    REQUIRE(!parseFloat("text", floatData));
+    REQUIRE(!parseFloat("+-1", floatData));
+    REQUIRE(!parseFloat("1e100", floatData));
+    REQUIRE(!parseInt("text", intData));
+
+    // Verify that the stream path formats numbers in the same way as the
+    // default path, for each float format.
+    auto formatFloat = [](float data)
+    {
+        std::string str;
+        mx::dataToStream(data, str);
+        return str;
+    };
+    const std::vector<float> values = { 0.0f, 0.1f, -2.5f, 1e-7f, 0.1234567f, 1234567.0f };
+    for (mx::Value::FloatFormat format : { mx::Value::FloatFormatDefault, mx::Value::FloatFormatFixed, mx::Value::FloatFormatScientific })
+    {
+        mx::ScopedFloatFormatting fmt(format, 4);
+        for (float value : values)
+        {
+            REQUIRE(formatFloat(value) == mx::toValueString(value));
+        }
+    }
+    for (float value : values)
+    {
+        REQUIRE(formatFloat(value) == mx::toValueString(value));
+    }
+    std::string intString;
+    mx::dataToStream(-42, intString);
+    REQUIRE(intString == mx::toValueString(-42));
 }
 
 TEST_CASE("Typed values", "[value]")
@@ -122,3 +227,45 @@ TEST_CASE("Typed values", "[value]")
     REQUIRE(value->isA<std::string>());
     REQUIRE(value->asA<std::string>() == "text");
 }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+template<class T> void benchmarkTypedValue(const T& data)
+{
+    const std::string valueString = mx::toValueString(data);
+    const std::string& typeString = mx::getTypeString<T>();
+    BENCHMARK("Parse " + typeString + " values")
+    {
+        return mx::fromValueString<T>(valueString);
+    };
+    BENCHMARK("Format " + typeString + " values")
+    {
+        return mx::toValueString(data);
+    };
+}
+
+TEST_CASE("Value: Parse And Format", "[value]")
+{
+    // Base types
+    benchmarkTypedValue<int>(12345);
+    benchmarkTypedValue<bool>(true);
+    benchmarkTypedValue<float>(0.123456f);
+    benchmarkTypedValue(mx::Color3(0.1f, 0.2f, 0.3f));
+    benchmarkTypedValue(mx::Color4(0.1f, 0.2f, 0.3f, 0.4f));
+    benchmarkTypedValue(mx::Vector2(1.5f, 2.5f));
+    benchmarkTypedValue(mx::Vector3(1.5f, 2.5f, 3.5f));
+    benchmarkTypedValue(mx::Vector4(1.5f, 2.5f, 3.5f, 4.5f));
+    benchmarkTypedValue(mx::Matrix33::IDENTITY);
+    benchmarkTypedValue(mx::Matrix44::IDENTITY);
+    benchmarkTypedValue(std::string("value"));
+
+    // Array types
+    benchmarkTypedValue(mx::IntVec{ 1, 2, 3, 4, 5, 6, 7, 8 });
+    benchmarkTypedValue(mx::BoolVec{ true, false, true, false });
+    benchmarkTypedValue(mx::FloatVec{ 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f });
+    benchmarkTypedValue(mx::StringVec{ "Item A", "Item B", "Item C" });
+
+    // Alias types
+    benchmarkTypedValue<long>(12345l);
+    benchmarkTypedValue<double>(0.123456789);
+}
+#endif
@@ -0,0 +1,122 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXTest/External/Catch/catch.hpp>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <cstdio>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// Verify that the given documents match, including the source URI
+// of each element.
+void checkDocumentsMatch(mx::DocumentPtr doc, mx::DocumentPtr other)
+{
+    REQUIRE(*doc == *other);
+    mx::TreeIterator it = doc->traverseTree();
+    mx::TreeIterator otherIt = other->traverseTree();
+    for (; it != mx::TreeIterator::end(); ++it, ++otherIt)
+    {
+        REQUIRE(otherIt != mx::TreeIterator::end());
+        REQUIRE(it.getElement()->getSourceUri() == otherIt.getElement()->getSourceUri());
+    }
+    REQUIRE(otherIt == mx::TreeIterator::end());
+}
+
+} // anonymous namespace
+
+TEST_CASE("Binary snapshots", "[binaryio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+
+    // Round-trip the data libraries.
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    std::string snapshot = mx::writeToBinaryString(libraries);
+    mx::DocumentPtr snapshotLibraries = mx::createDocument();
+    mx::readFromBinaryString(snapshotLibraries, snapshot);
+    checkDocumentsMatch(libraries, snapshotLibraries);
+    REQUIRE(mx::writeToXmlString(libraries) == mx::writeToXmlString(snapshotLibraries));
+    REQUIRE(snapshotLibraries->validate());
+
+    // Round-trip example documents through files, including comments and newlines.
+    mx::XmlReadOptions readOptions;
+    readOptions.readComments = true;
+    readOptions.readNewlines = true;
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples/StandardSurface");
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath, &readOptions);
+
+        mx::FilePath snapshotFilename = filename.asString() + "." + mx::MTLX_BINARY_EXTENSION;
+        mx::writeToBinaryFile(doc, snapshotFilename);
+        mx::DocumentPtr snapshotDoc = mx::createDocument();
+        mx::readFromBinaryFile(snapshotDoc, snapshotFilename);
+        checkDocumentsMatch(doc, snapshotDoc);
+        REQUIRE(mx::writeToXmlString(doc) == mx::writeToXmlString(snapshotDoc));
+        std::remove(snapshotFilename.asString().c_str());
+    }
+
+    // Existing elements are preserved when reading into a non-empty document.
+    mx::DocumentPtr merged = mx::createDocument();
+    mx::NodeDefPtr customNodeDef = merged->addNodeDef("ND_image_color3", "color3", "custom");
+    mx::readFromBinaryString(merged, snapshot);
+    REQUIRE(merged->getNodeDef("ND_image_color3") == customNodeDef);
+    REQUIRE(merged->getNodeDefs().size() == libraries->getNodeDefs().size());
+
+    // Invalid snapshots are rejected.
+    mx::DocumentPtr invalid = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalid, mx::writeToXmlString(libraries)), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalid, snapshot.substr(0, snapshot.size() / 2)), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalid, snapshot + '\0'), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(invalid, "missing." + mx::MTLX_BINARY_EXTENSION), mx::ExceptionFileMissing);
+
+    // Element trees beyond the maximum depth are rejected.
+    mx::DocumentPtr deepDoc = mx::createDocument();
+    mx::ElementPtr deepElem = deepDoc;
+    for (int i = 0; i < 300; i++)
+    {
+        deepElem = deepElem->addChildOfCategory("nodegraph");
+    }
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalid, mx::writeToBinaryString(deepDoc)), mx::ExceptionParseError);
+
+    // Snapshots of earlier document versions are upgraded on read.
+    mx::DocumentPtr olderDoc = mx::createDocument();
+    olderDoc->setVersionString("1.38");
+    mx::DocumentPtr upgradedDoc = mx::createDocument();
+    mx::readFromBinaryString(upgradedDoc, mx::writeToBinaryString(olderDoc));
+    REQUIRE(upgradedDoc->getVersionIntegers() == mx::createDocument()->getVersionIntegers());
+
+    // Failed writes are reported and leave no file behind.
+    const mx::FilePath unwritable = mx::FilePath("missing_folder") / ("unwritable." + mx::MTLX_BINARY_EXTENSION);
+    REQUIRE_THROWS_AS(mx::writeToBinaryFile(libraries, unwritable), mx::Exception);
+    REQUIRE(!unwritable.exists());
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Load libraries from XML")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, doc);
+        return doc;
+    };
+
+    mx::FilePath librariesFilename = "libraries." + mx::MTLX_BINARY_EXTENSION;
+    mx::writeToBinaryFile(libraries, librariesFilename);
+    BENCHMARK("Load libraries from a binary snapshot")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromBinaryFile(doc, librariesFilename);
+        return doc;
+    };
+    std::remove(librariesFilename.asString().c_str());
+#endif
+}
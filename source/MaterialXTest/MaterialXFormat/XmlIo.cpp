@@ -9,6 +9,18 @@
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 namespace mx = MaterialX;
 
 TEST_CASE("Load content", "[xmlio]")
@@ -270,6 +282,9 @@ TEST_CASE("Fuzz testing", "[xmlio]")
     std::mt19937 rng(0);
     std::uniform_int_distribution<size_t> randChar(0, 255);
 
+    mx::XmlReadOptions streamOptions;
+    streamOptions.readStreaming = true;
+
     for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
     {
         // Read the example file into an XML string buffer.
@@ -290,11 +305,25 @@ TEST_CASE("Fuzz testing", "[xmlio]")
                 size_t newChar = randChar(rng);
                 editString[charIndex] = (char) newChar;
 
+                // Verify that the streaming reader agrees with the document object reader.
+                mx::DocumentPtr streamDoc = mx::createDocument();
+                bool streamRead = true;
+                try
+                {
+                    mx::readFromXmlString(streamDoc, editString, searchPath, &streamOptions);
+                }
+                catch (const mx::Exception&)
+                {
+                    streamRead = false;
+                }
+
                 // Attempt to interpret the edited string as a document, allowing only MaterialX exceptions.
                 mx::DocumentPtr doc = mx::createDocument();
                 try
                 {
                     mx::readFromXmlString(doc, editString, searchPath);
+                    REQUIRE(streamRead);
+                    REQUIRE(*doc == *streamDoc);
                     doc->validate();
                 }
                 catch (const mx::Exception&)
@@ -349,3 +378,302 @@ TEST_CASE("Locale region testing", "[xmlio]")
     // Restore the original locale.
     std::locale::global(origLocale);
 }
+
+TEST_CASE("Load libraries", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+
+    // Load the libraries concurrently.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::StringSet loadedLibraries = mx::loadLibraries({ "libraries" }, searchPath, doc);
+    REQUIRE(!loadedLibraries.empty());
+
+    // Load the same libraries serially, in folder order.
+    mx::DocumentPtr serialDoc = mx::createDocument();
+    size_t fileCount = 0;
+    for (const mx::FilePath& path : searchPath.find("libraries").getSubDirectories())
+    {
+        for (const mx::FilePath& filename : path.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::loadLibrary(path / filename, serialDoc, searchPath);
+            fileCount++;
+        }
+    }
+    REQUIRE(fileCount == loadedLibraries.size());
+
+    // Custom XInclude readers are only called from the calling thread.
+    const std::thread::id callingThread = std::this_thread::get_id();
+    bool calledOnOtherThread = false;
+    mx::XmlReadOptions customReadOptions;
+    customReadOptions.readXIncludeFunction = [&](mx::DocumentPtr includeDoc, const mx::FilePath& filename,
+                                                 const mx::FileSearchPath& includeSearchPath, const mx::XmlReadOptions* options)
+    {
+        calledOnOtherThread = calledOnOtherThread || std::this_thread::get_id() != callingThread;
+        mx::readFromXmlFile(includeDoc, filename, includeSearchPath, options);
+    };
+    mx::DocumentPtr customDoc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, customDoc, mx::StringSet(), &customReadOptions);
+    REQUIRE(!calledOnOtherThread);
+    REQUIRE(*customDoc == *doc);
+
+    // Verify that both documents are identical.
+    REQUIRE(*doc == *serialDoc);
+    REQUIRE(doc->getReferencedSourceUris() == serialDoc->getReferencedSourceUris());
+    std::vector<mx::ElementPtr> children = doc->getChildren();
+    std::vector<mx::ElementPtr> serialChildren = serialDoc->getChildren();
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        REQUIRE(children[i]->getSourceUri() == serialChildren[i]->getSourceUri());
+    }
+}
+
+TEST_CASE("Streaming reader", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePathVec rootPaths = { searchPath.find("libraries"), searchPath.find("resources/Materials") };
+
+    mx::XmlReadOptions streamOptions;
+    streamOptions.readStreaming = true;
+    mx::XmlReadOptions commentOptions;
+    commentOptions.readComments = true;
+    commentOptions.readNewlines = true;
+    commentOptions.upgradeVersion = false;
+    mx::XmlReadOptions streamCommentOptions = commentOptions;
+    streamCommentOptions.readStreaming = true;
+
+    // Verify that the streaming and document object readers agree on every data file.
+    size_t fileCount = 0;
+    for (const mx::FilePath& rootPath : rootPaths)
+    {
+        for (const mx::FilePath& dirPath : rootPath.getSubDirectories())
+        {
+            mx::FileSearchPath fileSearchPath = searchPath;
+            fileSearchPath.append(dirPath);
+            for (const mx::FilePath& filename : dirPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+            {
+                mx::DocumentPtr doc = mx::createDocument();
+                try
+                {
+                    mx::readFromXmlFile(doc, dirPath / filename, fileSearchPath);
+                }
+                catch (const mx::Exception&)
+                {
+                    mx::DocumentPtr streamDoc = mx::createDocument();
+                    REQUIRE_THROWS_AS(mx::readFromXmlFile(streamDoc, dirPath / filename, fileSearchPath, &streamOptions), mx::Exception);
+                    continue;
+                }
+
+                mx::DocumentPtr streamDoc = mx::createDocument();
+                mx::readFromXmlFile(streamDoc, dirPath / filename, fileSearchPath, &streamOptions);
+                REQUIRE(*doc == *streamDoc);
+                REQUIRE(doc->getSourceUri() == streamDoc->getSourceUri());
+                std::vector<mx::ElementPtr> children = doc->getChildren();
+                std::vector<mx::ElementPtr> streamChildren = streamDoc->getChildren();
+                for (size_t i = 0; i < children.size(); i++)
+                {
+                    REQUIRE(children[i]->getSourceUri() == streamChildren[i]->getSourceUri());
+                }
+
+                // Compare the readers with comments and newlines preserved.
+                const std::string xmlString = mx::readFile(dirPath / filename);
+                mx::DocumentPtr commentDoc = mx::createDocument();
+                mx::readFromXmlString(commentDoc, xmlString, fileSearchPath, &commentOptions);
+                mx::DocumentPtr streamCommentDoc = mx::createDocument();
+                mx::readFromXmlString(streamCommentDoc, xmlString, fileSearchPath, &streamCommentOptions);
+                REQUIRE(*commentDoc == *streamCommentDoc);
+                REQUIRE(mx::writeToXmlString(commentDoc) == mx::writeToXmlString(streamCommentDoc));
+                fileCount++;
+            }
+        }
+    }
+    REQUIRE(fileCount > 0);
+
+    // Verify the handling of entities, line endings, and non-element content.
+    const std::string entityXml =
+        "<?xml version=\"1.0\"?>\r\n"
+        "<!DOCTYPE materialx>\r\n"
+        "<materialx version=\"1.39\">\r\n"
+        "  <!-- first\r\n comment -->\r\n\r\n"
+        "  <input name=\"in1\" type=\"string\" value=\"&lt;a&amp;b&gt; &quot;c&apos; &#65;&#x42;&#xe9;\" />\r\n"
+        "  <input name=\"in2\" type=\"string\" value=\"line1\r\nline2\tend\" />\r\n"
+        "  <input name=\"in1\" type=\"string\" value=\"duplicate\" />\r\n"
+        "  <input name=\"in3\" type=\"string\" value=\"&bogus; &#;\" />\r\n"
+        "  <nodegraph name=\"graph1\"><![CDATA[data]]>text</nodegraph>\r\n"
+        "</materialx>\r\n";
+    mx::DocumentPtr entityDoc = mx::createDocument();
+    mx::readFromXmlString(entityDoc, entityXml, mx::FileSearchPath(), &commentOptions);
+    mx::DocumentPtr streamEntityDoc = mx::createDocument();
+    mx::readFromXmlString(streamEntityDoc, entityXml, mx::FileSearchPath(), &streamCommentOptions);
+    REQUIRE(*entityDoc == *streamEntityDoc);
+    REQUIRE(mx::writeToXmlString(entityDoc) == mx::writeToXmlString(streamEntityDoc));
+    REQUIRE(streamEntityDoc->getInput("in1")->getValueString() == "<a&b> \"c' AB\xc3\xa9");
+    REQUIRE(streamEntityDoc->getInput("in2")->getValueString() == "line1 line2 end");
+    REQUIRE(streamEntityDoc->getInput("in3")->getValueString() == entityDoc->getInput("in3")->getValueString());
+
+    // Verify that only the first materialx element is read.
+    const std::string multipleRootXml =
+        "<extra><input name=\"in1\" /></extra>"
+        "<materialx><input name=\"in2\" /></materialx>"
+        "<materialx><input name=\"in3\" /></materialx>";
+    mx::DocumentPtr rootDoc = mx::createDocument();
+    mx::readFromXmlString(rootDoc, multipleRootXml);
+    mx::DocumentPtr streamRootDoc = mx::createDocument();
+    mx::readFromXmlString(streamRootDoc, multipleRootXml, mx::FileSearchPath(), &streamOptions);
+    REQUIRE(*rootDoc == *streamRootDoc);
+    REQUIRE(streamRootDoc->getChildren().size() == 1);
+
+    // Verify that malformed documents are rejected by both readers, leaving
+    // the document unchanged.
+    const mx::StringVec malformedXml =
+    {
+        "",
+        "<materialx>",
+        "<materialx><nodegraph></materialx>",
+        "<materialx><input name=\"in1\" value=\"1></materialx>",
+        "<materialx><!-- unterminated </materialx>",
+        "<materialx version=\"1.38\"><input name=\"in1\" /><nodegraph></materialx>",
+        "<materialx><xi:include href=\"missing.mtlx\" /><input name=\"in1\"></materialx>",
+    };
+    for (const std::string& xml : malformedXml)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        REQUIRE_THROWS_AS(mx::readFromXmlString(doc, xml), mx::ExceptionParseError);
+        mx::DocumentPtr streamDoc = mx::createDocument();
+        REQUIRE_THROWS_AS(mx::readFromXmlString(streamDoc, xml, mx::FileSearchPath(), &streamOptions), mx::ExceptionParseError);
+        REQUIRE(*streamDoc == *mx::createDocument());
+    }
+
+    // Verify that a malformed file leaves the source URI unchanged.
+    const mx::FilePath malformedPath = mx::FilePath(std::filesystem::temp_directory_path().string()) / "malformed_streaming.mtlx";
+    std::ofstream(malformedPath.asString()) << malformedXml[2];
+    mx::DocumentPtr malformedDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromXmlFile(malformedDoc, malformedPath, mx::FileSearchPath(), &streamOptions), mx::ExceptionParseError);
+    REQUIRE(!malformedDoc->hasSourceUri());
+    std::filesystem::remove(malformedPath.asString());
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+
+#if defined(__linux__)
+namespace
+{
+
+// Return the value of the given memory field of the process status in bytes.
+size_t getProcessMemory(const std::string& field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (mx::stringStartsWith(line, field + ":"))
+        {
+            return std::stoull(line.substr(field.size() + 1)) * 1024;
+        }
+    }
+    return 0;
+}
+
+// Return the peak growth in resident memory while running the given function
+// in a forked child process, so that free heap memory retained by earlier
+// work in this process cannot mask the allocations of the function.
+template <class F> size_t measurePeakMemory(F func)
+{
+    int channel[2];
+    if (pipe(channel) != 0)
+    {
+        return 0;
+    }
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+        std::ofstream("/proc/self/clear_refs") << "5";
+        size_t baseline = getProcessMemory("VmRSS");
+        func();
+        size_t peak = getProcessMemory("VmHWM");
+        size_t growth = peak > baseline ? peak - baseline : 0;
+        _exit(write(channel[1], &growth, sizeof(growth)) == sizeof(growth) ? 0 : 1);
+    }
+    size_t growth = 0;
+    if (pid > 0)
+    {
+        if (read(channel[0], &growth, sizeof(growth)) != sizeof(growth))
+        {
+            growth = 0;
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    close(channel[0]);
+    close(channel[1]);
+    return growth;
+}
+
+} // anonymous namespace
+#endif
+
+TEST_CASE("XmlIo: Streaming Reader", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePathVec filenames;
+    for (const mx::FilePath& path : searchPath.find("libraries").getSubDirectories())
+    {
+        for (const mx::FilePath& filename : path.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            filenames.push_back(path / filename);
+        }
+    }
+
+    mx::XmlReadOptions streamOptions;
+    streamOptions.readStreaming = true;
+
+    BENCHMARK("Read " + std::to_string(filenames.size()) + " library files")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        for (const mx::FilePath& filename : filenames)
+        {
+            mx::readFromXmlFile(doc, filename, searchPath);
+        }
+        return doc;
+    };
+
+    BENCHMARK("Stream " + std::to_string(filenames.size()) + " library files")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        for (const mx::FilePath& filename : filenames)
+        {
+            mx::readFromXmlFile(doc, filename, searchPath, &streamOptions);
+        }
+        return doc;
+    };
+
+#if defined(__linux__)
+    // Measure the peak memory of each reader on a single large document,
+    // combining all of the data libraries.
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    const mx::FilePath largePath = mx::FilePath(std::filesystem::temp_directory_path().string()) / "streaming_reader_large.mtlx";
+    mx::XmlWriteOptions writeOptions;
+    writeOptions.writeXIncludeEnable = false;
+    std::ofstream(largePath.asString()) << mx::writeToXmlString(libraries, &writeOptions);
+    libraries = nullptr;
+
+    const size_t fileBytes = (size_t) std::filesystem::file_size(largePath.asString());
+    size_t readPeak = measurePeakMemory([&]()
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, largePath, searchPath);
+    });
+    size_t streamPeak = measurePeakMemory([&]()
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, largePath, searchPath, &streamOptions);
+    });
+    std::filesystem::remove(largePath.asString());
+    WARN("Peak memory reading a " << fileBytes / 1024 << " KB document: " <<
+         readPeak / 1024 << " KB with the document object reader, " <<
+         streamPeak / 1024 << " KB with the streaming reader");
+#endif
+}
+#endif
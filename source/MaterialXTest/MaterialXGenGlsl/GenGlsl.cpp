@@ -124,6 +124,45 @@ TEST_CASE("GenShader: GLSL Performance Test", "[genglsl]")
         return GenShaderUtil::shaderGenPerformanceTest(context);
     };
 }
+
+TEST_CASE("GenShader: GLSL Throughput Test", "[genglsl]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    // Collect the renderable elements of all example documents.
+    std::vector<mx::DocumentPtr> docs;
+    std::vector<mx::TypedElementPtr> elements;
+    for (const mx::FilePath& dirPath : searchPath.find("resources/Materials/Examples").getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dirPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlFile(doc, dirPath / filename, searchPath);
+            doc->setDataLibrary(libraries);
+            docs.push_back(doc);
+            for (mx::TypedElementPtr element : mx::findRenderableElements(doc))
+            {
+                elements.push_back(element);
+            }
+        }
+    }
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    BENCHMARK("Generate " + std::to_string(elements.size()) + " shaders")
+    {
+        return GenShaderUtil::shaderGenThroughputTest(elements, context);
+    };
+
+    context.setShaderCache(mx::ShaderCache::create());
+    GenShaderUtil::shaderGenThroughputTest(elements, context);
+    BENCHMARK("Generate " + std::to_string(elements.size()) + " shaders with a warm shader cache")
+    {
+        return GenShaderUtil::shaderGenThroughputTest(elements, context);
+    };
+}
 #endif
 
 enum class GlslType
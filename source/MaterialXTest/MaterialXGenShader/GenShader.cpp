@@ -28,8 +28,13 @@
 #include <MaterialXGenMsl/MslShaderGenerator.h>
 #endif
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <thread>
 #include <vector>
 #include <set>
 
@@ -56,6 +61,62 @@ TEST_CASE("GenShader: Utilities", "[genshader]")
     REQUIRE(test2 == result2);
 }
 
+#ifdef MATERIALX_BUILD_GEN_GLSL
+// Generator exposing stage creation and token replacement for testing.
+class TokenTestGenerator : public mx::GlslShaderGenerator
+{
+  public:
+    using mx::ShaderGenerator::createStage;
+    using mx::ShaderGenerator::replaceTokens;
+};
+#endif
+
+TEST_CASE("GenShader: Token Replacement", "[genshader]")
+{
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    TokenTestGenerator generator;
+    const mx::StringMap substitutions = { { "$a", "x" }, { "$b", "yy" }, { "$dollar", "$b" } };
+    mx::Shader shader("token_test", nullptr);
+    auto replace = [&](const mx::StringVec& code)
+    {
+        mx::ShaderStage stage(mx::Stage::PIXEL, nullptr);
+        for (const std::string& str : code)
+        {
+            stage.addString(str);
+        }
+        generator.replaceTokens(substitutions, stage);
+        std::string result = stage.getSourceCode();
+        generator.replaceTokens(substitutions, stage);
+        return std::make_pair(result, stage.getSourceCode());
+    };
+
+    // A prefix at the end of the code is not a token, but becomes one when
+    // more code is appended.
+    REQUIRE(replace({ "a = $" }).first == "a = $");
+    REQUIRE(replace({ "a = $", "a;" }).first == "a = x;");
+
+    // Adjacent tokens are replaced independently.
+    REQUIRE(replace({ "$a$b$a" }).first == "xyyx");
+
+    // Substitutions are applied in a single pass, and prefixes within a
+    // substitution are found by later passes.
+    REQUIRE(replace({ "$dollar + $a" }) == std::make_pair(std::string("$b + x"), std::string("yy + x")));
+
+    // Unknown tokens are left as is.
+    REQUIRE(replace({ "$unknown + $a + $" }) == std::make_pair(std::string("$unknown + x + $"), std::string("$unknown + x + $")));
+
+    // Token positions are preserved when a shader is copied.
+    mx::ShaderStagePtr stage = generator.createStage(mx::Stage::PIXEL, shader);
+    stage->addString("$b + $unknown + $dollar");
+    mx::ShaderPtr shaderCopy = shader.copy();
+    generator.replaceTokens(substitutions, shaderCopy->getStage(mx::Stage::PIXEL));
+    REQUIRE(shaderCopy->getSourceCode() == "yy + $unknown + $b");
+    REQUIRE(shader.getSourceCode() == "$b + $unknown + $dollar");
+    generator.replaceTokens(substitutions, *stage);
+    REQUIRE(shader.getSourceCode() == shaderCopy->getSourceCode());
+#endif
+}
+
 TEST_CASE("GenShader: Valid Libraries", "[genshader]")
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
@@ -264,6 +325,386 @@ TEST_CASE("GenShader: Deterministic Generation", "[genshader]")
 #endif
 }
 
+void testConcurrentGeneration(mx::DocumentPtr libraries, mx::ShaderGeneratorPtr generator)
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples");
+
+    // Collect the renderable elements of all example documents.
+    std::vector<mx::DocumentPtr> testDocs;
+    std::vector<mx::TypedElementPtr> elements;
+    for (const mx::FilePath& dirPath : examplesPath.getSubDirectories())
+    {
+        for (const mx::FilePath& filename : dirPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr testDoc = mx::createDocument();
+            mx::readFromXmlFile(testDoc, dirPath / filename, searchPath);
+            testDoc->setDataLibrary(libraries);
+            testDocs.push_back(testDoc);
+            for (mx::TypedElementPtr element : mx::findRenderableElements(testDoc))
+            {
+                elements.push_back(element);
+            }
+        }
+    }
+    REQUIRE(!elements.empty());
+
+    // Generate shaders for every n-th element, starting at the given index,
+    // using a context of our own and the shared generator.
+    auto generateShaders = [&](size_t start, size_t step, mx::StringVec& sourceCode)
+    {
+        mx::GenContext context(generator);
+        context.registerSourceCodeSearchPath(searchPath);
+        for (size_t i = start; i < elements.size(); i += step)
+        {
+            try
+            {
+                mx::ShaderPtr shader = generator->generate(elements[i]->getName(), elements[i], context);
+                for (size_t j = 0; j < shader->numStages(); j++)
+                {
+                    sourceCode[i] += shader->getStage(j).getSourceCode();
+                }
+            }
+            catch (mx::Exception& e)
+            {
+                sourceCode[i] = e.what();
+            }
+        }
+    };
+
+    mx::StringVec serialCode(elements.size());
+    generateShaders(0, 1, serialCode);
+
+    const size_t threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    mx::StringVec concurrentCode(elements.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back(generateShaders, i, threadCount, std::ref(concurrentCode));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        INFO("Element: " + elements[i]->getNamePath() + " in " + elements[i]->getDocument()->getSourceUri());
+        CHECK(concurrentCode[i] == serialCode[i]);
+    }
+}
+
+TEST_CASE("GenShader: Concurrent Generation", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    testConcurrentGeneration(libraries, mx::GlslShaderGenerator::create());
+#endif
+#ifdef MATERIALX_BUILD_GEN_OSL
+    testConcurrentGeneration(libraries, mx::OslShaderGenerator::create());
+#endif
+#ifdef MATERIALX_BUILD_GEN_MDL
+    testConcurrentGeneration(libraries, mx::MdlShaderGenerator::create());
+#endif
+#ifdef MATERIALX_BUILD_GEN_MSL
+    testConcurrentGeneration(libraries, mx::MslShaderGenerator::create());
+#endif
+}
+
+TEST_CASE("GenShader: Source File Cache", "[genshader]")
+{
+    mx::SourceFileCachePtr cache = mx::SourceFileCache::create();
+
+    // Files on disk are read again when they change.
+    const mx::FilePath testFile = "source_file_cache_test.glsl";
+    auto writeTestFile = [&testFile](const std::string& contents)
+    {
+        std::ofstream stream(testFile.asString(), std::ios::binary);
+        stream << contents;
+    };
+    writeTestFile("float a;");
+    REQUIRE(cache->readFile(testFile) == "float a;");
+    writeTestFile("float ab;");
+    REQUIRE(cache->readFile(testFile) == "float ab;");
+    std::remove(testFile.asString().c_str());
+    REQUIRE(cache->readFile(testFile).empty());
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    // Added files are resolved and read without being present on disk.
+    mx::ShaderGeneratorPtr generator = mx::GlslShaderGenerator::create();
+    mx::GenContext context(generator);
+    context.setSourceFileCache(cache);
+    context.registerSourceCodeSearchPath(mx::FilePath("embedded"));
+    const mx::FilePath addedFile = mx::FilePath("embedded/lib/mx_test.glsl").getNormalized();
+    REQUIRE(!cache->hasAddedFiles());
+    cache->addFile(addedFile, "float c;");
+    REQUIRE(cache->hasAddedFile(addedFile));
+    REQUIRE(context.resolveSourceFile("lib/mx_test.glsl", mx::FilePath()) == addedFile);
+    REQUIRE(context.readSourceFile(addedFile) == "float c;");
+    cache->removeFile(addedFile);
+    REQUIRE(!cache->hasAddedFiles());
+    REQUIRE(context.readSourceFile(addedFile).empty());
+
+    // Generation through a cache matches generation from disk.
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+    mx::readFromXmlFile(doc, searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+    mx::TypedElementPtr element = mx::findRenderableElements(doc)[0];
+
+    mx::GenContext diskContext(generator);
+    diskContext.registerSourceCodeSearchPath(searchPath);
+    diskContext.setSourceFileCache(nullptr);
+    mx::GenContext cacheContext(generator);
+    cacheContext.registerSourceCodeSearchPath(searchPath);
+    cacheContext.setSourceFileCache(cache);
+    for (size_t i = 0; i < 2; i++)
+    {
+        mx::ShaderPtr diskShader = generator->generate(element->getName(), element, diskContext);
+        mx::ShaderPtr cacheShader = generator->generate(element->getName(), element, cacheContext);
+        REQUIRE(diskShader->getSourceCode(mx::Stage::PIXEL) == cacheShader->getSourceCode(mx::Stage::PIXEL));
+    }
+#endif
+}
+
+TEST_CASE("GenShader: Shader Cache", "[genshader]")
+{
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+    mx::readFromXmlFile(doc, searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+    mx::TypedElementPtr element = mx::findRenderableElements(doc)[0];
+    const std::string shaderName = element->getName();
+
+    mx::ShaderGeneratorPtr generator = mx::GlslShaderGenerator::create();
+    mx::GenContext context(generator);
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // Repeated requests return copies of the cached shader.
+    mx::ShaderCachePtr cache = mx::ShaderCache::create();
+    mx::ShaderPtr shader = cache->generate(shaderName, element, context);
+    REQUIRE(shader);
+    mx::ShaderPtr cachedShader = cache->generate(shaderName, element, context);
+    REQUIRE(cachedShader != shader);
+    REQUIRE(cachedShader->getSourceCode(mx::Stage::PIXEL) == shader->getSourceCode(mx::Stage::PIXEL));
+    REQUIRE(cache->getHitCount() == 1);
+    REQUIRE(cache->getMissCount() == 1);
+    mx::ShaderPtr uncachedShader = generator->generate(shaderName, element, context);
+    REQUIRE(uncachedShader->getSourceCode(mx::Stage::PIXEL) == shader->getSourceCode(mx::Stage::PIXEL));
+
+    // Changes to the variables of a returned shader are not seen by later requests.
+    const mx::VariableBlock& uniforms = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+    REQUIRE(!uniforms.empty());
+    const std::string uniformName = uniforms[0]->getName();
+    const std::string uniformValue = uniforms[0]->getValueString();
+    for (mx::ShaderPtr returnedShader : { shader, cachedShader })
+    {
+        mx::ShaderPort* uniform = returnedShader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS).find(uniformName);
+        REQUIRE(uniform);
+        uniform->setValue(mx::Value::createValue(std::string("modified")));
+        returnedShader->setSourceCode("modified", mx::Stage::PIXEL);
+    }
+    mx::ShaderPtr unmodifiedShader = cache->generate(shaderName, element, context);
+    REQUIRE(unmodifiedShader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS)[uniformName]->getValueString() == uniformValue);
+    REQUIRE(unmodifiedShader->getSourceCode(mx::Stage::PIXEL) == uncachedShader->getSourceCode(mx::Stage::PIXEL));
+    shader = unmodifiedShader;
+
+    // Changes to options and upstream values change the cache key.
+    auto getKey = [&]()
+    {
+        return mx::ShaderCache::getShaderKey(mx::ShaderCache::getShaderDescription(shaderName, element, context));
+    };
+    const std::string key = getKey();
+    context.getOptions().hwTransparency = true;
+    REQUIRE(getKey() != key);
+    context.getOptions().hwTransparency = false;
+    REQUIRE(getKey() == key);
+    mx::NodeGraphPtr nodeGraph = doc->getNodeGraphs()[0];
+    mx::InputPtr upstreamInput;
+    for (mx::NodePtr node : nodeGraph->getNodes())
+    {
+        for (mx::InputPtr input : node->getInputs())
+        {
+            if (!upstreamInput && input->hasValue())
+            {
+                upstreamInput = input;
+            }
+        }
+    }
+    REQUIRE(upstreamInput);
+    const std::string valueString = upstreamInput->getValueString();
+    upstreamInput->setValueString(valueString + " ");
+    REQUIRE(getKey() != key);
+    cache->generate(shaderName, element, context);
+    REQUIRE(cache->getMissCount() == 2);
+    upstreamInput->setValueString(valueString);
+    REQUIRE(getKey() == key);
+    cache->generate(shaderName, element, context);
+    REQUIRE(cache->getMissCount() == 2);
+
+    // Changes to the content of data library definitions change the cache key.
+    mx::DocumentPtr dataLibrary = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, dataLibrary);
+    mx::DocumentPtr layeredDoc = mx::createDocument();
+    layeredDoc->setDataLibrary(dataLibrary);
+    mx::readFromXmlFile(layeredDoc, searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+    mx::TypedElementPtr layeredElement = mx::findRenderableElements(layeredDoc)[0];
+    auto getLayeredKey = [&]()
+    {
+        return mx::ShaderCache::getShaderKey(mx::ShaderCache::getShaderDescription(shaderName, layeredElement, context));
+    };
+    const std::string layeredKey = getLayeredKey();
+    mx::InputPtr libraryInput = dataLibrary->getNodeDef("ND_standard_surface_surfaceshader")->getInput("base");
+    REQUIRE(libraryInput);
+    const std::string libraryValueString = libraryInput->getValueString();
+    libraryInput->setValueString("0.5");
+    REQUIRE(getLayeredKey() != layeredKey);
+    libraryInput->setValueString(libraryValueString);
+    REQUIRE(getLayeredKey() == layeredKey);
+
+    // Source code is reused across caches sharing a directory, as long as
+    // the source code files it depends on are unchanged.
+    const mx::FilePath cacheDirectory = (std::filesystem::temp_directory_path() / "MaterialXShaderCacheTest").string();
+    std::filesystem::remove_all(cacheDirectory.asString());
+    mx::ShaderCachePtr diskCache = mx::ShaderCache::create(cacheDirectory);
+    mx::StringMap sourceCode = diskCache->generateSourceCode(shaderName, element, context);
+    REQUIRE(sourceCode[mx::Stage::PIXEL] == shader->getSourceCode(mx::Stage::PIXEL));
+    REQUIRE(diskCache->getMissCount() == 1);
+
+    mx::ShaderCachePtr reloadedCache = mx::ShaderCache::create(cacheDirectory);
+    REQUIRE(reloadedCache->generateSourceCode(shaderName, element, context) == sourceCode);
+    REQUIRE(reloadedCache->getHitCount() == 1);
+    REQUIRE(reloadedCache->getMissCount() == 0);
+
+    REQUIRE(!shader->getStage(mx::Stage::PIXEL).getIncludes().empty());
+    const std::string include = *shader->getStage(mx::Stage::PIXEL).getIncludes().begin();
+    mx::SourceFileCachePtr sourceFileCache = mx::SourceFileCache::create();
+    sourceFileCache->addFile(include, context.readSourceFile(include) + "\n");
+    context.setSourceFileCache(sourceFileCache);
+    mx::ShaderCachePtr modifiedCache = mx::ShaderCache::create(cacheDirectory);
+    modifiedCache->generateSourceCode(shaderName, element, context);
+    REQUIRE(modifiedCache->getHitCount() == 0);
+    REQUIRE(modifiedCache->getMissCount() == 1);
+
+    std::filesystem::remove_all(cacheDirectory.asString());
+    REQUIRE(!cacheDirectory.exists());
+#endif
+}
+
+TEST_CASE("GenShader: Graph Optimization", "[genshader]")
+{
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Build a graph with duplicate image lookups, identity operations and
+    // a constant subexpression.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("optimize_graph");
+    mx::NodePtr image1 = nodeGraph->addNode("image", "image1", "color3");
+    image1->setInputValue("file", std::string("resources/Images/grid.png"), "filename");
+    mx::NodePtr image2 = nodeGraph->addNode("image", "image2", "color3");
+    image2->setInputValue("file", std::string("resources/Images/grid.png"), "filename");
+    mx::NodePtr identity = nodeGraph->addNode("multiply", "identity", "color3");
+    identity->setConnectedNode("in1", image1);
+    identity->setInputValue("in2", mx::Color3(1.0f));
+    mx::NodePtr sum = nodeGraph->addNode("add", "sum", "color3");
+    sum->setConnectedNode("in1", identity);
+    sum->setConnectedNode("in2", image2);
+    mx::NodePtr scale = nodeGraph->addNode("add", "scale", "float");
+    scale->setInputValue("in1", 0.25f);
+    scale->setInputValue("in2", 0.5f);
+    mx::NodePtr scaled = nodeGraph->addNode("multiply", "scaled", "color3");
+    scaled->setConnectedNode("in1", sum);
+    scaled->setConnectedNode("in2", scale);
+    mx::NodePtr mix = nodeGraph->addNode("mix", "mix", "color3");
+    mix->setConnectedNode("fg", image1);
+    mix->setConnectedNode("bg", scaled);
+    mix->setInputValue("mix", 0.0f);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(mix);
+    REQUIRE(doc->validate());
+
+    mx::ShaderGeneratorPtr generator = mx::GlslShaderGenerator::create();
+    mx::GenContext context(generator);
+    context.registerSourceCodeSearchPath(searchPath);
+
+    auto getNodeNames = [&](mx::ShaderPtr shader)
+    {
+        mx::StringSet names;
+        for (mx::ShaderNode* node : shader->getGraph().getNodes())
+        {
+            names.insert(node->getName());
+        }
+        return names;
+    };
+
+    // Without the option set, the graph is left as authored.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderPtr shader = generator->generate("optimize_graph", output, context);
+    mx::StringSet names = getNodeNames(shader);
+    REQUIRE(names.count("image2"));
+    REQUIRE(names.count("identity"));
+    REQUIRE(names.count("scale"));
+    REQUIRE(names.count("mix"));
+
+    // With the option set, duplicate nodes are merged, identity operations
+    // are bypassed and constant subexpressions are folded.
+    context.getOptions().optimizeShaderGraph = true;
+    mx::ShaderPtr optimizedShader = generator->generate("optimize_graph", output, context);
+    names = getNodeNames(optimizedShader);
+    REQUIRE(names.count("image1"));
+    REQUIRE(!names.count("image2"));
+    REQUIRE(!names.count("identity"));
+    REQUIRE(!names.count("scale"));
+    REQUIRE(!names.count("mix"));
+    REQUIRE(optimizedShader->getSourceCode(mx::Stage::PIXEL).find("0.750000") != std::string::npos);
+
+    // Inputs published as uniforms in a complete interface are never folded.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    mx::ShaderPtr completeShader = generator->generate("optimize_graph", output, context);
+    names = getNodeNames(completeShader);
+    REQUIRE(names.count("scale"));
+    REQUIRE(names.count("mix"));
+    REQUIRE(names.count("identity"));
+
+    // Nodes whose constant inputs differ only in the seventh significant
+    // digit are not merged, while exact duplicates are.
+    mx::NodeGraphPtr precisionGraph = doc->addNodeGraph("precision_graph");
+    mx::NodePtr precisionImage = precisionGraph->addNode("image", "image", "color3");
+    precisionImage->setInputValue("file", std::string("resources/Images/grid.png"), "filename");
+    mx::NodePtr near1 = precisionGraph->addNode("multiply", "near1", "color3");
+    near1->setConnectedNode("in1", precisionImage);
+    near1->addInput("in2", "float")->setValueString("0.1234561");
+    mx::NodePtr near2 = precisionGraph->addNode("multiply", "near2", "color3");
+    near2->setConnectedNode("in1", precisionImage);
+    near2->addInput("in2", "float")->setValueString("0.1234564");
+    mx::NodePtr near3 = precisionGraph->addNode("multiply", "near3", "color3");
+    near3->setConnectedNode("in1", precisionImage);
+    near3->addInput("in2", "float")->setValueString("0.1234561");
+    mx::NodePtr nearSum = precisionGraph->addNode("add", "near_sum", "color3");
+    nearSum->setConnectedNode("in1", near1);
+    nearSum->setConnectedNode("in2", near2);
+    mx::NodePtr nearTotal = precisionGraph->addNode("add", "near_total", "color3");
+    nearTotal->setConnectedNode("in1", nearSum);
+    nearTotal->setConnectedNode("in2", near3);
+    mx::OutputPtr precisionOutput = precisionGraph->addOutput("out", "color3");
+    precisionOutput->setConnectedNode(nearTotal);
+    REQUIRE(doc->validate());
+
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderPtr precisionShader = generator->generate("precision_graph", precisionOutput, context);
+    names = getNodeNames(precisionShader);
+    REQUIRE(names.count("near1"));
+    REQUIRE(names.count("near2"));
+    REQUIRE(!names.count("near3"));
+#endif
+}
+
 void checkPixelDependencies(mx::DocumentPtr libraries, mx::GenContext& context)
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
@@ -415,3 +856,86 @@ TEST_CASE("GenShader: Track Application Variables", "[genshader]")
     }
 #endif
 }
+
+TEST_CASE("GenShader: Variable Block Path Index", "[genshader]")
+{
+    mx::VariableBlock block("PublicUniforms", "u_pub");
+    const std::vector<std::string> paths =
+    {
+        "NG_test/image1/file", "NG_test/image2/file", "M_test/SR_test/base",
+        "M_test/SR_test/base_color", "NG_test/image1/uvtiling", "", "NG_test/image1/file"
+    };
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        mx::ShaderPort* port = block.add(mx::Type::FLOAT, "u_var" + std::to_string(i));
+        port->setPath(paths[i]);
+    }
+
+    // Compare against a linear scan of the block.
+    auto scanPath = [&block](const std::string& path)
+    {
+        return block.find([&path](mx::ShaderPort* port) { return port->getPath() == path; });
+    };
+    auto scanSuffix = [&block](const std::string& suffix)
+    {
+        return block.find([&suffix](mx::ShaderPort* port) { return mx::stringEndsWith(port->getPath(), suffix); });
+    };
+    auto checkQueries = [&]()
+    {
+        const std::vector<std::string> queries =
+        {
+            "", "file", "/file", "image1/file", "NG_test/image1/file", "ile", "base", "color",
+            "_color", "SR_test/base_color", "uvtiling", "missing", "xNG_test/image1/file"
+        };
+        for (const std::string& query : queries)
+        {
+            REQUIRE(block.findByPath(query) == scanPath(query));
+            REQUIRE(block.findByPathSuffix(query) == scanSuffix(query));
+        }
+    };
+
+    checkQueries();
+    REQUIRE(block.findByPath("NG_test/image1/file") == block[0]);
+    REQUIRE(block.findByPathSuffix("") == block[0]);
+    REQUIRE(block.findByPathSuffix("file") == block[0]);
+    REQUIRE(block.findByPathSuffix("e") == block[0]);
+    REQUIRE(block.findByPathSuffix("base") == block[2]);
+    REQUIRE(block.findByPathSuffix("missing") == nullptr);
+
+    // The index tracks changes to port paths.
+    block[0]->setPath("NG_test/image0/file");
+    checkQueries();
+    REQUIRE(block.findByPathSuffix("image1/file") == block[6]);
+
+    // The index tracks added ports.
+    mx::ShaderPort* port = block.add(mx::Type::FLOAT, "u_added");
+    port->setPath("NG_test/added/base");
+    checkQueries();
+    REQUIRE(block.findByPathSuffix("added/base") == port);
+
+    // Adding an existing variable leaves the block unchanged.
+    REQUIRE(block.add(mx::Type::FLOAT, "u_added") == port);
+    checkQueries();
+
+    // Lookups through a const block never rebuild the index, and scan the
+    // variables while it is out of date.
+    const mx::VariableBlock& constBlock = block;
+    block[6]->setPath("NG_test/image6/file");
+    REQUIRE(constBlock.findByPath("NG_test/image6/file") == block[6]);
+    REQUIRE(constBlock.findByPathSuffix("image6/file") == block[6]);
+    REQUIRE(constBlock.findByPathSuffix("image1/file") == nullptr);
+    checkQueries();
+    REQUIRE(constBlock.findByPathSuffix("image6/file") == block[6]);
+
+    // Ports shared with a copy of the block invalidate both indices, and
+    // stop referencing blocks that are destroyed.
+    {
+        mx::VariableBlock copy(block);
+        REQUIRE(copy.findByPathSuffix("added/base") == port);
+        port->setPath("NG_test/renamed/base");
+        REQUIRE(copy.findByPathSuffix("renamed/base") == port);
+        REQUIRE(block.findByPathSuffix("renamed/base") == port);
+    }
+    port->setPath("NG_test/added/base");
+    checkQueries();
+}
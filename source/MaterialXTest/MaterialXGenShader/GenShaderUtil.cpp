@@ -392,6 +392,22 @@ void shaderGenPerformanceTest(mx::GenContext& context)
     }
 }
 
+size_t shaderGenThroughputTest(const std::vector<mx::TypedElementPtr>& elements, mx::GenContext& context)
+{
+    mx::ShaderCachePtr cache = context.getShaderCache();
+    size_t codeLength = 0;
+    for (const mx::TypedElementPtr& element : elements)
+    {
+        mx::ShaderPtr shader = cache ? cache->generate(element->getName(), element, context) :
+                                       context.getShaderGenerator().generate(element->getName(), element, context);
+        for (size_t i = 0; i < shader->numStages(); i++)
+        {
+            codeLength += shader->getStage(i).getSourceCode().length();
+        }
+    }
+    return codeLength;
+}
+
 void ShaderGeneratorTester::checkImplementationUsage(const mx::StringSet& usedImpls,
                                                      const mx::GenContext& context,
                                                      std::ostream& stream)
@@ -983,7 +999,7 @@ bool TestSuiteOptions::readOptions(const std::string& optionFile)
             for (auto p : optionDefs->getInputs())
             {
                 const std::string& name = p->getName();
-                mx::ValuePtr val = p->getValue();
+                mx::ConstValuePtr val = p->getValue();
                 if (val)
                 {
                     if (name == OVERRIDE_FILES_STRING)
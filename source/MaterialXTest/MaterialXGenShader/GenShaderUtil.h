@@ -55,6 +55,10 @@ void testUniqueNames(mx::GenContext& context, const std::string& stage);
 // Utility to perfrom simple performance test to load, validate and generate shaders
 void shaderGenPerformanceTest(mx::GenContext& context);
 
+// Utility to measure code generation throughput, generating a shader for each of the
+// given elements and returning the total length of the generated source code.
+size_t shaderGenThroughputTest(const std::vector<mx::TypedElementPtr>& elements, mx::GenContext& context);
+
 //
 // Render validation options. Reflects the _options.mtlx
 // file in the test suite area.
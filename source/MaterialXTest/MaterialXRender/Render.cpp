@@ -6,6 +6,10 @@
 #include <MaterialXTest/External/Catch/catch.hpp>
 #include <MaterialXTest/MaterialXRender/RenderUtil.h>
 
+#include <MaterialXRender/BatchRender.h>
+#include <MaterialXRender/FrameReadback.h>
+#include <MaterialXRender/ProgramBinaryCache.h>
+#include <MaterialXRender/ShaderMaterial.h>
 #include <MaterialXRender/ShaderRenderer.h>
 #include <MaterialXRender/StbImageLoader.h>
 #include <MaterialXRender/TinyObjLoader.h>
@@ -13,13 +17,17 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <MaterialXGenShader/HwShaderGenerator.h>
+
 #ifdef MATERIALX_BUILD_OIIO
 #include <MaterialXRender/OiioImageLoader.h>
 #endif
 
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <unordered_set>
 
 namespace mx = MaterialX;
@@ -243,3 +251,649 @@ TEST_CASE("Render: Image Handler Load", "[rendercore]")
     CHECK(imagesLoaded);
     imageHandlerLog.close();
 }
+
+namespace
+{
+
+// A program backend which "compiles" sources into a binary holding their
+// concatenation, and only accepts binaries in its own format.
+class FakeProgramBackend : public mx::ProgramBinaryBackend
+{
+  public:
+    FakeProgramBackend(const mx::StringMap& stages, const std::string& driver, unsigned int format) :
+        stages(stages),
+        driver(driver),
+        format(format)
+    {
+    }
+
+    std::string getDriverIdentity() override
+    {
+        return driver;
+    }
+
+    void buildFromSource() override
+    {
+        compiled = "";
+        for (const std::string& stage : { mx::Stage::VERTEX, mx::Stage::PIXEL })
+        {
+            compiled += stages.at(stage);
+        }
+        sourceBuilds++;
+    }
+
+    bool loadBinary(const mx::ProgramBinary& binary) override
+    {
+        if (binary.format != format)
+        {
+            return false;
+        }
+        compiled.assign(binary.data.begin(), binary.data.end());
+        binaryLoads++;
+        return true;
+    }
+
+    bool getBinary(mx::ProgramBinary& binary) override
+    {
+        binary.format = format;
+        binary.data.assign(compiled.begin(), compiled.end());
+        return true;
+    }
+
+    mx::StringMap stages;
+    std::string driver;
+    unsigned int format;
+    std::string compiled;
+    int sourceBuilds = 0;
+    int binaryLoads = 0;
+};
+
+mx::StringMap createStages(const std::string& name)
+{
+    return { { mx::Stage::VERTEX, "vertex_" + name + ";" }, { mx::Stage::PIXEL, "pixel_" + name + ";" } };
+}
+
+} // anonymous namespace
+
+TEST_CASE("Render: Program Binary Cache", "[rendercore]")
+{
+    std::filesystem::path tempDir = std::filesystem::temp_directory_path() / "programBinaryCacheTest";
+    std::filesystem::remove_all(tempDir);
+    mx::FilePath cacheDir = mx::FilePath(tempDir.string());
+    mx::ProgramBinaryCachePtr cache = mx::ProgramBinaryCache::create(cacheDir);
+    cache->clear();
+
+    // Build from source on a miss, then from the stored binary.
+    mx::StringMap stagesA = createStages("a");
+    FakeProgramBackend backendA(stagesA, "driver1", 1);
+    REQUIRE(!cache->build(stagesA, backendA));
+    REQUIRE(cache->build(stagesA, backendA));
+    REQUIRE(backendA.sourceBuilds == 1);
+    REQUIRE(backendA.binaryLoads == 1);
+    REQUIRE(backendA.compiled == "vertex_a;pixel_a;");
+
+    // Binaries persist across cache instances.
+    cache = mx::ProgramBinaryCache::create(cacheDir);
+    REQUIRE(cache->hasBinary(mx::ProgramBinaryCache::computeKey(stagesA, "driver1")));
+    REQUIRE(cache->build(stagesA, backendA));
+
+    // Keys depend on both the sources and the driver identity.
+    REQUIRE(mx::ProgramBinaryCache::computeKey(stagesA, "driver1") != mx::ProgramBinaryCache::computeKey(stagesA, "driver2"));
+    REQUIRE(mx::ProgramBinaryCache::computeKey(stagesA, "driver1") != mx::ProgramBinaryCache::computeKey(createStages("b"), "driver1"));
+    FakeProgramBackend otherDriver(stagesA, "driver2", 1);
+    REQUIRE(!cache->build(stagesA, otherDriver));
+
+    // A rejected binary falls back to compilation, and is replaced.
+    FakeProgramBackend newFormat(stagesA, "driver1", 2);
+    REQUIRE(!cache->build(stagesA, newFormat));
+    REQUIRE(newFormat.sourceBuilds == 1);
+    REQUIRE(cache->getStats().rejections == 1);
+    REQUIRE(cache->build(stagesA, newFormat));
+
+    // A corrupt entry is detected, removed, and rebuilt from source.
+    std::string keyA = mx::ProgramBinaryCache::computeKey(stagesA, "driver1");
+    {
+        std::fstream entry((cacheDir / (keyA + ".mxpb")).asString(), std::ios::binary | std::ios::in | std::ios::out);
+        entry.seekp(-1, std::ios::end);
+        entry.put('#');
+    }
+    std::string sourceA = mx::ProgramBinaryCache::getSourceDescription(stagesA, "driver1");
+    mx::ProgramBinary binary;
+    REQUIRE(!cache->readBinary(keyA, sourceA, binary));
+    REQUIRE(!cache->hasBinary(keyA));
+    REQUIRE(cache->getStats().corruptions == 1);
+    FakeProgramBackend rebuilt(stagesA, "driver1", 2);
+    REQUIRE(!cache->build(stagesA, rebuilt));
+    REQUIRE(rebuilt.compiled == "vertex_a;pixel_a;");
+
+    // An entry built from other sources under a colliding key is never used.
+    mx::StringMap stagesB = createStages("b");
+    mx::ProgramBinary binaryB;
+    binaryB.format = 2;
+    binaryB.data = { 'b' };
+    cache->writeBinary(keyA, mx::ProgramBinaryCache::getSourceDescription(stagesB, "driver1"), binaryB);
+    REQUIRE(!cache->readBinary(keyA, sourceA, binary));
+    REQUIRE(cache->getStats().collisions == 1);
+    FakeProgramBackend collided(stagesA, "driver1", 2);
+    REQUIRE(!cache->build(stagesA, collided));
+    REQUIRE(collided.compiled == "vertex_a;pixel_a;");
+    REQUIRE(cache->build(stagesA, collided));
+
+    // Least recently used entries are evicted once the size limit is reached.
+    cache->clear();
+    REQUIRE(cache->getTotalSize() == 0);
+    std::vector<mx::StringMap> stageSets = { createStages("x"), createStages("y"), createStages("z") };
+    for (const mx::StringMap& stages : stageSets)
+    {
+        FakeProgramBackend backend(stages, "driver1", 1);
+        cache->build(stages, backend);
+    }
+    size_t entrySize = cache->getTotalSize() / 3;
+    cache->setMaxSize(entrySize * 3);
+    FakeProgramBackend backendX(stageSets[0], "driver1", 1);
+    REQUIRE(cache->build(stageSets[0], backendX));
+    mx::StringMap stagesW = createStages("w");
+    FakeProgramBackend backendW(stagesW, "driver1", 1);
+    cache->build(stagesW, backendW);
+    REQUIRE(cache->getStats().evictions == 1);
+    REQUIRE(cache->hasBinary(mx::ProgramBinaryCache::computeKey(stageSets[0], "driver1")));
+    REQUIRE(!cache->hasBinary(mx::ProgramBinaryCache::computeKey(stageSets[1], "driver1")));
+    REQUIRE(cache->hasBinary(mx::ProgramBinaryCache::computeKey(stagesW, "driver1")));
+
+    cache->clear();
+    std::filesystem::remove_all(tempDir);
+}
+
+namespace
+{
+
+// A readback target whose slots complete only when the test allows it.
+class MockReadbackTarget : public mx::ReadbackTarget
+{
+  public:
+    void allocate(unsigned int width, unsigned int height, size_t slotCount) override
+    {
+        REQUIRE(inFlight.empty());
+        this->width = width;
+        this->height = height;
+        slots.assign(slotCount, 0);
+        allocations++;
+    }
+
+    void beginReadback(size_t slot) override
+    {
+        REQUIRE(slot < slots.size());
+        REQUIRE(!inFlight.count(slot));
+        slots[slot] = ++renderedFrames;
+        inFlight.insert(slot);
+    }
+
+    bool isReadbackComplete(size_t slot) override
+    {
+        return completed.count(slot) != 0;
+    }
+
+    mx::ImagePtr endReadback(size_t slot) override
+    {
+        REQUIRE(inFlight.count(slot));
+        if (!completed.count(slot))
+        {
+            blockingWaits++;
+        }
+        inFlight.erase(slot);
+        completed.erase(slot);
+
+        // Encode the rendered frame number in the first pixel.
+        mx::ImagePtr image = mx::Image::create(width, height, 3);
+        image->createResourceBuffer();
+        static_cast<unsigned char*>(image->getResourceBuffer())[0] = (unsigned char) slots[slot];
+        return image;
+    }
+
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<int> slots;
+    std::unordered_set<size_t> inFlight;
+    std::unordered_set<size_t> completed;
+    int renderedFrames = 0;
+    int allocations = 0;
+    int blockingWaits = 0;
+};
+
+} // anonymous namespace
+
+TEST_CASE("Render: Frame Readback Queue", "[rendercore]")
+{
+    auto target = std::make_shared<MockReadbackTarget>();
+    mx::FrameReadbackQueuePtr queue = mx::FrameReadbackQueue::create(target, 3);
+
+    std::vector<std::pair<uint64_t, int>> received;
+    auto callback = [&received](uint64_t frame, mx::ImagePtr image)
+    {
+        received.emplace_back(frame, static_cast<unsigned char*>(image->getResourceBuffer())[0]);
+    };
+
+    // A resolution is required before frames can be submitted.
+    REQUIRE_THROWS_AS(queue->submit(callback), mx::ExceptionRenderError);
+    REQUIRE(queue->setResolution(64, 32));
+    REQUIRE(!queue->setResolution(64, 32));
+    REQUIRE(target->allocations == 1);
+
+    // Frames stay in flight until their readback completes.
+    REQUIRE(queue->submit(callback) == 1);
+    REQUIRE(queue->submit(callback) == 2);
+    REQUIRE(queue->getInFlightCount() == 2);
+    REQUIRE(queue->poll() == 0);
+    REQUIRE(received.empty());
+
+    // Frames complete in submission order, even if a later slot finishes first.
+    target->completed.insert(1);
+    REQUIRE(queue->poll() == 0);
+    target->completed.insert(0);
+    REQUIRE(queue->poll() == 2);
+    REQUIRE(received == std::vector<std::pair<uint64_t, int>>{ { 1, 1 }, { 2, 2 } });
+    REQUIRE(target->blockingWaits == 0);
+
+    // Submitting with every slot in flight waits on the oldest frame only.
+    received.clear();
+    for (int i = 0; i < 4; i++)
+    {
+        queue->submit(callback);
+    }
+    REQUIRE(queue->getStats().stalls == 1);
+    REQUIRE(target->blockingWaits == 1);
+    REQUIRE(received == std::vector<std::pair<uint64_t, int>>{ { 3, 3 } });
+    REQUIRE(queue->getInFlightCount() == 3);
+
+    // Changing the resolution drains frames in flight before reallocating.
+    REQUIRE(queue->setResolution(16, 16));
+    REQUIRE(target->allocations == 2);
+    REQUIRE(queue->getInFlightCount() == 0);
+    REQUIRE(received.size() == 4);
+    REQUIRE(received.back() == std::make_pair<uint64_t, int>(6, 6));
+
+    // Flushing completes everything, and images carry the new resolution.
+    mx::ImagePtr lastImage;
+    queue->submit([&lastImage](uint64_t, mx::ImagePtr image) { lastImage = image; });
+    REQUIRE(queue->flush() == 1);
+    REQUIRE(lastImage->getWidth() == 16);
+    REQUIRE(queue->getStats().submitted == queue->getStats().completed);
+    REQUIRE_THROWS_AS(queue->setResolution(0, 16), mx::ExceptionRenderError);
+}
+
+namespace
+{
+
+// A shader whose stages are built by hand.
+class MockShader : public mx::Shader
+{
+  public:
+    MockShader() :
+        mx::Shader("mock", nullptr)
+    {
+    }
+
+    using mx::Shader::createStage;
+};
+
+// A material over a hand-built block of public uniforms and a matching
+// document, which records bound uniform data.  Uniforms are found and
+// modified by path through the same lookup and shared ShaderMaterial update
+// as GlslMaterial, with the GL program binding replaced by a counter.
+class MockUniformMaterial : public mx::ShaderMaterial
+{
+  public:
+    void createUniforms(size_t count)
+    {
+        auto shader = std::make_shared<MockShader>();
+        mx::ShaderStagePtr stage = shader->createStage(mx::Stage::PIXEL, nullptr);
+        _hwShader = shader;
+        _doc = mx::createDocument();
+        mx::NodeGraphPtr graph = _doc->addNodeGraph("graph");
+        mx::VariableBlockPtr block = stage->createUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+        for (size_t i = 0; i < count; i++)
+        {
+            std::string name = "node" + std::to_string(i) + "_in";
+            mx::ShaderPort* port = (i % 2) ?
+                block->add(mx::Type::COLOR3, name, mx::Value::createValue(mx::Color3(0.0f))) :
+                block->add(mx::Type::FLOAT, name, mx::Value::createValue(0.0f));
+            port->setPath("graph/node" + std::to_string(i) + "/in");
+            mx::NodePtr node = graph->addNode("constant", "node" + std::to_string(i), port->getType().getName());
+            node->setInputValue("in", port->getValue()->getValueString(), port->getType().getName());
+        }
+        block->add(mx::Type::STRING, "label", mx::Value::createValue(std::string("label")))->setPath("graph/label");
+    }
+
+    mx::VariableBlock* getPublicUniforms() const override
+    {
+        return _hwShader ? &_hwShader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS) : nullptr;
+    }
+
+    mx::ShaderPort* findUniform(const std::string& path) const override
+    {
+        mx::VariableBlock* block = getPublicUniforms();
+        return block ? block->findByPathSuffix(path) : nullptr;
+    }
+
+    void modifyUniform(const std::string& path, mx::ConstValuePtr value, std::string valueString) override
+    {
+        mx::ShaderPort* uniform = findUniform(path);
+        if (uniform)
+        {
+            boundValues++;
+            updateUniformValue(uniform, value, valueString);
+        }
+    }
+
+    bool bindShader() const override { return true; }
+    bool loadSource(const mx::FilePath&, const mx::FilePath&, bool) override { return false; }
+    bool generateShader(mx::GenContext&) override { return false; }
+    bool generateShader(mx::ShaderPtr) override { return false; }
+    void copyShader(mx::MaterialPtr) override { }
+    void bindViewInformation(mx::CameraPtr) override { }
+    void bindImages(mx::ImageHandlerPtr, const mx::FileSearchPath&, bool) override { }
+    void unbindImages(mx::ImageHandlerPtr) override { }
+    mx::ImagePtr bindImage(const mx::FilePath&, const std::string&, mx::ImageHandlerPtr, const mx::ImageSamplingProperties&) override { return nullptr; }
+    void bindLighting(mx::LightHandlerPtr, mx::ImageHandlerPtr, const mx::ShadowState&) override { }
+    void bindMesh(mx::MeshPtr) override { }
+    bool bindPartition(mx::MeshPartitionPtr) const override { return false; }
+    void drawPartition(mx::MeshPartitionPtr) const override { }
+    void unbindGeometry() override { }
+    void clearShader() override { _hwShader = nullptr; }
+
+    size_t boundValues = 0;
+
+  protected:
+    void bindUniformData(int, mx::ShaderPort*, const float*) override
+    {
+        boundValues++;
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("Render: Uniform Handles", "[rendercore]")
+{
+    const size_t UNIFORM_COUNT = 400;
+    MockUniformMaterial material;
+    material.createUniforms(UNIFORM_COUNT);
+
+    // Handles are stable, and only assigned to uniforms with a packed representation.
+    int handle0 = material.resolveUniformHandle("node0/in");
+    int handle1 = material.resolveUniformHandle("node1/in");
+    REQUIRE(handle0 == 0);
+    REQUIRE(handle1 == 1);
+    REQUIRE(material.resolveUniformHandle("node0/in") == handle0);
+    REQUIRE(material.resolveUniformHandle("missing/in") == mx::UniformHandleTable::INVALID_HANDLE);
+    REQUIRE(material.resolveUniformHandle("graph/label") == mx::UniformHandleTable::INVALID_HANDLE);
+    REQUIRE(material.getUniformFromHandle(handle1)->getPath() == "graph/node1/in");
+
+    // Mismatched data sizes and invalid handles leave all values untouched.
+    std::vector<float> data = { 0.5f, 0.1f, 0.2f, 0.3f };
+    REQUIRE(!material.modifyUniforms({ handle0, handle1 }, data.data(), 3));
+    REQUIRE(!material.modifyUniforms({ handle0, 7 }, data.data(), 2));
+    REQUIRE(material.boundValues == 0);
+    REQUIRE(material.modifyUniforms({ handle0, handle1 }, data.data(), data.size()));
+    REQUIRE(material.boundValues == 2);
+    REQUIRE(material.getUniformFromHandle(handle0)->getValue()->asA<float>() == 0.5f);
+    REQUIRE(material.getUniformFromHandle(handle1)->getValue()->asA<mx::Color3>() == mx::Color3(0.1f, 0.2f, 0.3f));
+
+    // Packed values round-trip for every supported type.
+    std::vector<float> packed(16);
+    for (size_t i = 0; i < packed.size(); i++)
+    {
+        packed[i] = (float) i;
+    }
+    REQUIRE(mx::UniformHandleTable::createPackedValue(mx::Type::INTEGER, packed.data() + 3)->asA<int>() == 3);
+    REQUIRE(mx::UniformHandleTable::createPackedValue(mx::Type::BOOLEAN, packed.data())->asA<bool>() == false);
+    REQUIRE(mx::UniformHandleTable::createPackedValue(mx::Type::VECTOR4, packed.data())->asA<mx::Vector4>() == mx::Vector4(0, 1, 2, 3));
+    REQUIRE(mx::UniformHandleTable::createPackedValue(mx::Type::MATRIX44, packed.data())->asA<mx::Matrix44>()[3][1] == 13.0f);
+    REQUIRE(mx::UniformHandleTable::getPackedSize(mx::Type::MATRIX33) == 9);
+    REQUIRE(mx::UniformHandleTable::getPackedSize(mx::Type::STRING) == 0);
+
+    // Updating every uniform by path and by handle gives the same values.
+    std::vector<std::string> paths;
+    std::vector<int> handles;
+    std::vector<float> frameData;
+    for (size_t i = 0; i < UNIFORM_COUNT; i++)
+    {
+        paths.push_back("node" + std::to_string(i) + "/in");
+        handles.push_back(material.resolveUniformHandle(paths.back()));
+        for (size_t j = 0; j < ((i % 2) ? 3 : 1); j++)
+        {
+            frameData.push_back(0.25f);
+        }
+    }
+    REQUIRE(std::find(handles.begin(), handles.end(), mx::UniformHandleTable::INVALID_HANDLE) == handles.end());
+
+    auto updateByPath = [&]()
+    {
+        for (size_t i = 0; i < UNIFORM_COUNT; i++)
+        {
+            mx::ValuePtr value = (i % 2) ?
+                mx::Value::createValue(mx::Color3(0.25f)) :
+                mx::Value::createValue(0.25f);
+            material.modifyUniform(paths[i], value, mx::EMPTY_STRING);
+        }
+    };
+    auto updateByHandle = [&]()
+    {
+        return material.modifyUniforms(handles, frameData.data(), frameData.size());
+    };
+    updateByPath();
+    REQUIRE(material.getUniformFromHandle(handles[1])->getValue()->asA<mx::Color3>() == mx::Color3(0.25f));
+    mx::InputPtr documentInput = material.getDocument()->getDescendant("graph/node1/in")->asA<mx::Input>();
+    REQUIRE(documentInput->getValue()->asA<mx::Color3>() == mx::Color3(0.25f));
+    material.modifyUniform(paths[1], mx::Value::createValue(mx::Color3(0.0f)), mx::EMPTY_STRING);
+    REQUIRE(documentInput->getValue()->asA<mx::Color3>() == mx::Color3(0.0f));
+    REQUIRE(updateByHandle());
+    REQUIRE(material.getUniformFromHandle(handles[1])->getValue()->asA<mx::Color3>() == mx::Color3(0.25f));
+    REQUIRE(documentInput->getValue()->asA<mx::Color3>() == mx::Color3(0.0f));
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+    BENCHMARK("Update uniforms by path")
+    {
+        updateByPath();
+    };
+    BENCHMARK("Update uniforms by handle")
+    {
+        return updateByHandle();
+    };
+#endif
+
+    // Handles are invalidated when the shader changes.
+    material.createUniforms(UNIFORM_COUNT);
+    REQUIRE(material.getUniformFromHandle(handle0) == nullptr);
+    REQUIRE(!material.modifyUniforms({ handle0 }, data.data(), 1));
+    REQUIRE(material.resolveUniformHandle("node1/in") == 0);
+}
+
+namespace
+{
+
+// A batch renderer which logs each call, and completes each frame during
+// the following render call to mimic pipelined readback.
+class MockBatchRenderer : public mx::BatchRenderer
+{
+  public:
+    void loadMaterial(const mx::FilePath& filename) override
+    {
+        if (filename.asString() == "missing.mtlx")
+        {
+            throw mx::ExceptionRenderError("Material not found");
+        }
+        log.push_back("material " + filename.asString());
+    }
+
+    void setShader(const mx::FilePath& vertexShaderFilename, const mx::FilePath& pixelShaderFilename) override
+    {
+        log.push_back("shader " + vertexShaderFilename.asString() + " " + pixelShaderFilename.asString());
+    }
+
+    void setUniform(const std::string& path, const std::string& value) override
+    {
+        log.push_back("uniform " + path + " " + value);
+    }
+
+    void resetUniform(const std::string& path) override
+    {
+        log.push_back("reset " + path);
+    }
+
+    void setCamera(const mx::Vector3& position, const mx::Vector3&, float) override
+    {
+        cameraPosition = position;
+    }
+
+    void render(unsigned int width, unsigned int height, mx::FrameReadbackQueue::FrameCallback callback) override
+    {
+        flush();
+        mx::ImagePtr image = mx::Image::create(width, height, 3);
+        image->createResourceBuffer();
+        static_cast<unsigned char*>(image->getResourceBuffer())[0] = (unsigned char) ++renderedFrames;
+        pending = [callback, image]() { callback(0, image); };
+    }
+
+    void flush() override
+    {
+        if (pending)
+        {
+            auto complete = pending;
+            pending = nullptr;
+            complete();
+        }
+    }
+
+    std::vector<std::string> log;
+    mx::Vector3 cameraPosition;
+    int renderedFrames = 0;
+    std::function<void()> pending;
+};
+
+} // anonymous namespace
+
+TEST_CASE("Render: Batch Jobs", "[rendercore]")
+{
+    const std::string jobFile =
+        "# Two variants of one material, then a shader override\n"
+        "material a.mtlx\n"
+        "resolution 4 2\n"
+        "uniform M/SR/base 0.5\n"
+        "uniform M/SR/base_color 1, 0, 0\n"
+        "render frame0.png\n"
+        "\n"
+        "camera 1,2,3 0,0,0 30\n"
+        "uniform M/SR/base 0.25\n"
+        "render\n"
+        "shader custom.vert custom.frag\n"
+        "render\n"
+        "material missing.mtlx\n"
+        "render\n"
+        "material b.mtlx\n"
+        "shader generated\n"
+        "render\n"
+        "material a.mtlx\n"
+        "render\n";
+
+    // Settings persist across jobs, except for uniform overrides.
+    {
+        std::istringstream stream(jobFile);
+        mx::BatchJobReader reader(stream);
+        std::vector<mx::BatchJob> jobs;
+        mx::BatchJob job;
+        while (reader.readJob(job))
+        {
+            jobs.push_back(job);
+        }
+        REQUIRE(jobs.size() == 6);
+        REQUIRE(jobs[0].index == 0);
+        REQUIRE(jobs[0].line == 6);
+        REQUIRE(jobs[0].width == 4);
+        REQUIRE(jobs[0].height == 2);
+        REQUIRE(jobs[0].uniformPaths == mx::StringVec{ "M/SR/base", "M/SR/base_color" });
+        REQUIRE(jobs[0].uniformValues == mx::StringVec{ "0.5", "1, 0, 0" });
+        REQUIRE(jobs[0].outputFilename.asString() == "frame0.png");
+        REQUIRE(jobs[1].cameraPosition == mx::Vector3(1.0f, 2.0f, 3.0f));
+        REQUIRE(jobs[1].cameraViewAngle == 30.0f);
+        REQUIRE(jobs[1].uniformPaths == mx::StringVec{ "M/SR/base" });
+        REQUIRE(jobs[1].outputFilename.isEmpty());
+        REQUIRE(jobs[2].uniformPaths.empty());
+        REQUIRE(jobs[2].pixelShaderFilename.asString() == "custom.frag");
+        REQUIRE(jobs[4].materialFilename.asString() == "b.mtlx");
+        REQUIRE(jobs[4].vertexShaderFilename.isEmpty());
+        REQUIRE(jobs[5].width == 4);
+    }
+
+    // Malformed lines are reported with their line number.
+    for (const char* badLine : { "render\n", "material a.mtlx\nresolution 0 4\n",
+                                        "camera 1,2 0,0,0\n", "shader only.vert\n", "zoom 2\n" })
+    {
+        std::istringstream stream(badLine);
+        mx::BatchJobReader reader(stream);
+        mx::BatchJob job;
+        REQUIRE_THROWS_AS(reader.readJob(job), mx::ExceptionRenderError);
+    }
+
+    // Jobs are rendered with minimal state changes, and frames are streamed in job order.
+    auto renderer = std::make_shared<MockBatchRenderer>();
+    std::stringstream output;
+    mx::BatchRunnerPtr runner = mx::BatchRunner::create(renderer, mx::BatchStreamWriter::create(output));
+    {
+        std::istringstream stream(jobFile);
+        mx::BatchJobReader reader(stream);
+        REQUIRE(runner->run(reader) == 5);
+    }
+    const std::vector<std::string> expectedLog =
+    {
+        "material a.mtlx", "uniform M/SR/base 0.5", "uniform M/SR/base_color 1, 0, 0",
+        "reset M/SR/base_color", "uniform M/SR/base 0.25",
+        "shader custom.vert custom.frag", "reset M/SR/base",
+        "material b.mtlx",
+        "material a.mtlx"
+    };
+    REQUIRE(renderer->log == expectedLog);
+    REQUIRE(renderer->cameraPosition == mx::Vector3(1.0f, 2.0f, 3.0f));
+    REQUIRE(runner->getStats().jobs == 6);
+    REQUIRE(runner->getStats().materialLoads == 3);
+    REQUIRE(runner->getStats().shaderChanges == 1);
+    REQUIRE(runner->getFailures().size() == 1);
+    REQUIRE(runner->getFailures()[0].jobIndex == 3);
+    REQUIRE(runner->getFailures()[0].line == 14);
+
+    std::vector<size_t> jobIndices;
+    mx::BatchStreamWriter::FrameHeader header;
+    std::vector<char> pixels;
+    while (mx::BatchStreamWriter::readFrame(output, header, pixels))
+    {
+        REQUIRE(header.width == 4);
+        REQUIRE(header.height == 2);
+        REQUIRE(header.channels == 3);
+        REQUIRE(pixels.size() == 4 * 2 * 3);
+        REQUIRE((size_t) pixels[0] == jobIndices.size() + 1);
+        jobIndices.push_back((size_t) header.jobIndex);
+    }
+    REQUIRE(jobIndices == std::vector<size_t>{ 0, 1, 2, 4, 5 });
+
+    // Grouping jobs by material avoids reloading the first material.
+    renderer->log.clear();
+    output.clear();
+    output.str(std::string());
+    runner->setGroupJobs(true);
+    {
+        std::istringstream stream(jobFile);
+        mx::BatchJobReader reader(stream);
+        REQUIRE(runner->run(reader) == 5);
+    }
+    REQUIRE(runner->getStats().materialLoads == 2);
+    REQUIRE(renderer->log.front() == "material a.mtlx");
+    REQUIRE(renderer->log.back() == "material b.mtlx");
+
+    // Writing images requires an output filename for every job.
+    runner = mx::BatchRunner::create(renderer, mx::BatchImageWriter::create(mx::ImageHandler::create(mx::StbImageLoader::create())));
+    {
+        std::istringstream stream("material a.mtlx\nrender\n");
+        mx::BatchJobReader reader(stream);
+        REQUIRE(runner->run(reader) == 0);
+    }
+    REQUIRE(runner->getFailures().size() == 1);
+}
@@ -6,7 +6,9 @@
 #include <MaterialXTest/External/Catch/catch.hpp>
 #include <MaterialXTest/MaterialXRender/RenderUtil.h>
 
+#include <MaterialXGenGlsl/GlslResourceBindingContext.h>
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
+#include <MaterialXRenderGlsl/GlslMaterial.h>
 #include <MaterialXRenderGlsl/GlslRenderer.h>
 #include <MaterialXRenderGlsl/GLTextureHandler.h>
 
@@ -18,6 +20,8 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <MaterialXGenShader/Util.h>
+
 namespace mx = MaterialX;
 
 //
@@ -420,3 +424,94 @@ TEST_CASE("Render: GLSL TestSuite", "[renderglsl]")
     GlslShaderRenderTester renderTester(mx::GlslShaderGenerator::create());
     renderTester.validate(optionsFilePath);
 }
+
+TEST_CASE("Render: GLSL Parallel Shader Generation", "[renderglsl]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    // Gather the renderable elements of several example materials.
+    mx::StringVec filenames = {
+        "standard_surface_brass_tiled.mtlx",
+        "standard_surface_brick_procedural.mtlx",
+        "standard_surface_carpaint.mtlx",
+        "standard_surface_glass.mtlx",
+        "standard_surface_jade.mtlx",
+        "standard_surface_marble_solid.mtlx",
+        "standard_surface_wood_tiled.mtlx"
+    };
+    std::vector<mx::DocumentPtr> documents;
+    std::vector<mx::TypedElementPtr> elements;
+    for (const std::string& filename : filenames)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        documents.push_back(doc);
+        mx::readFromXmlFile(doc, searchPath.find("resources/Materials/Examples/StandardSurface/" + filename));
+        doc->importLibrary(libraries);
+        for (mx::TypedElementPtr elem : mx::findRenderableElements(doc))
+        {
+            elements.push_back(elem);
+        }
+    }
+    REQUIRE(elements.size() >= filenames.size());
+
+    auto createMaterials = [&elements]()
+    {
+        std::vector<mx::MaterialPtr> materials;
+        for (mx::TypedElementPtr elem : elements)
+        {
+            mx::GlslMaterialPtr material = mx::GlslMaterial::create();
+            material->setDocument(elem->getDocument());
+            material->setElement(elem);
+            materials.push_back(material);
+        }
+        return materials;
+    };
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // Shaders generated in parallel must match those generated serially.
+    std::vector<mx::MaterialPtr> serialMaterials = createMaterials();
+    std::vector<mx::MaterialPtr> parallelMaterials = createMaterials();
+    mx::generateShaders(serialMaterials, context, 1);
+    mx::generateShaders(parallelMaterials, context, 4);
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        mx::ShaderPtr serialShader = serialMaterials[i]->getShader();
+        mx::ShaderPtr parallelShader = parallelMaterials[i]->getShader();
+        REQUIRE(serialShader);
+        REQUIRE(parallelShader);
+        REQUIRE(serialShader->getSourceCode(mx::Stage::VERTEX) == parallelShader->getSourceCode(mx::Stage::VERTEX));
+        REQUIRE(serialShader->getSourceCode(mx::Stage::PIXEL) == parallelShader->getSourceCode(mx::Stage::PIXEL));
+        REQUIRE(serialMaterials[i]->hasTransparency() == parallelMaterials[i]->hasTransparency());
+        REQUIRE(std::dynamic_pointer_cast<mx::GlslMaterial>(parallelMaterials[i])->getProgram());
+    }
+
+    // Each thread generates with its own copy of the resource binding context,
+    // whose binding locations are assigned during generation.
+    mx::GenContext bindingContext = context;
+    bindingContext.pushUserData(mx::HW::USER_DATA_BINDING_CONTEXT, mx::GlslResourceBindingContext::create());
+    std::vector<mx::MaterialPtr> serialBindingMaterials = createMaterials();
+    std::vector<mx::MaterialPtr> parallelBindingMaterials = createMaterials();
+    mx::generateShaders(serialBindingMaterials, bindingContext, 1);
+    mx::generateShaders(parallelBindingMaterials, bindingContext, 4);
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        const std::string& serialCode = serialBindingMaterials[i]->getShader()->getSourceCode(mx::Stage::PIXEL);
+        REQUIRE(serialCode.find("binding") != std::string::npos);
+        REQUIRE(serialCode == parallelBindingMaterials[i]->getShader()->getSourceCode(mx::Stage::PIXEL));
+    }
+
+    // Generation errors are reported to the caller.
+    std::vector<mx::MaterialPtr> failingMaterials = createMaterials();
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    invalidDoc->importLibrary(libraries);
+    mx::NodePtr invalidNode = invalidDoc->addNode("unknown_node", "invalid", mx::SURFACE_SHADER_TYPE_STRING);
+    mx::GlslMaterialPtr invalidMaterial = mx::GlslMaterial::create();
+    invalidMaterial->setDocument(invalidDoc);
+    invalidMaterial->setElement(invalidNode);
+    failingMaterials.push_back(invalidMaterial);
+    REQUIRE_THROWS(mx::generateShaders(failingMaterials, context, 4));
+}
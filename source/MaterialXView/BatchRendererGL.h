@@ -0,0 +1,156 @@
+#pragma once
+
+#include <MaterialXView/ProgramCache.h>
+#include <MaterialXView/Viewer.h>
+
+#include <MaterialXRender/BatchRender.h>
+#include <MaterialXRender/ShaderRenderer.h>
+#include <MaterialXRenderGlsl/GlslMaterial.h>
+#include <MaterialXFormat/Util.h>
+
+#include <map>
+
+namespace mx = MaterialX;
+
+/**
+ * Batch rendering backend over a Viewer whose window is never shown.
+ *
+ * Frames are rendered offscreen through Viewer::requestRender, so the readback of each frame
+ * overlaps the rendering of the next.  Shader overrides are built through a ProgramCache, so
+ * jobs sharing the same source files only compile them once.
+ */
+class GLBatchRenderer : public mx::BatchRenderer
+{
+  public:
+    explicit GLBatchRenderer(Viewer* viewer, size_t programCacheSize = ProgramCache::DEFAULT_CAPACITY) :
+        _viewer(viewer),
+        _programCache(programCacheSize)
+    {
+    }
+
+    void loadMaterial(const mx::FilePath& filename) override
+    {
+        _material = nullptr;
+        _defaultProgram = nullptr;
+        _defaultValues.clear();
+
+        if (!_viewer->loadMaterialDocument(filename))
+        {
+            throw mx::ExceptionRenderError("Failed to load material: " + filename.asString());
+        }
+        _material = std::dynamic_pointer_cast<mx::GlslMaterial>(_viewer->getSelectedMaterial());
+        if (!_material || !_material->getProgram())
+        {
+            throw mx::ExceptionRenderError("No renderable material in " + filename.asString());
+        }
+        _defaultProgram = _material->getProgram();
+    }
+
+    void setShader(const mx::FilePath& vertexShaderFilename, const mx::FilePath& pixelShaderFilename) override
+    {
+        requireMaterial();
+        if (vertexShaderFilename.isEmpty() && pixelShaderFilename.isEmpty())
+        {
+            _viewer->setMaterialProgram(_material, _defaultProgram);
+            return;
+        }
+
+        std::string vertex = mx::readFile(vertexShaderFilename);
+        std::string fragment = mx::readFile(pixelShaderFilename);
+        if (vertex.empty() || fragment.empty())
+        {
+            throw mx::ExceptionRenderError("Failed to read shader sources: " +
+                                           vertexShaderFilename.asString() + ", " + pixelShaderFilename.asString());
+        }
+
+        const mx::GenOptions& options = _viewer->getGenContext().getOptions();
+        mx::GlslProgramPtr program = _programCache.find(vertex, fragment, options);
+        if (!program)
+        {
+            program = mx::GlslProgram::create();
+            program->addStage(mx::Stage::VERTEX, vertex);
+            program->addStage(mx::Stage::PIXEL, fragment);
+            program->build();
+            _programCache.insert(program, options);
+        }
+        _viewer->setMaterialProgram(_material, program);
+    }
+
+    void setUniform(const std::string& path, const std::string& value) override
+    {
+        requireMaterial();
+        mx::ShaderPort* uniform = _material->findUniform(path);
+        if (!uniform)
+        {
+            throw mx::ExceptionRenderError("Unknown uniform: " + path);
+        }
+        mx::ValuePtr newValue = mx::Value::createValueFromStrings(value, uniform->getType().getName());
+        if (!newValue)
+        {
+            throw mx::ExceptionRenderError("Invalid value for uniform " + path + ": " + value);
+        }
+
+        // Keep the material value, so that later jobs can restore it.
+        if (!_defaultValues.count(path))
+        {
+            _defaultValues[path] = uniform->getValue();
+        }
+        _material->modifyUniform(path, newValue, value);
+        _transparencyChanged = true;
+    }
+
+    void resetUniform(const std::string& path) override
+    {
+        requireMaterial();
+        auto it = _defaultValues.find(path);
+        if (it != _defaultValues.end() && it->second)
+        {
+            _material->modifyUniform(path, it->second);
+            _transparencyChanged = true;
+        }
+    }
+
+    void setCamera(const mx::Vector3& position, const mx::Vector3& target, float viewAngle) override
+    {
+        _viewer->setCameraPosition(position);
+        _viewer->setCameraTarget(target);
+        _viewer->setCameraViewAngle(viewAngle);
+    }
+
+    void render(unsigned int width, unsigned int height, mx::FrameReadbackQueue::FrameCallback callback) override
+    {
+        requireMaterial();
+        if (_transparencyChanged)
+        {
+            _material->updateTransparency(_viewer->getGenContext());
+            _transparencyChanged = false;
+        }
+        _viewer->requestRender((int) width, (int) height, callback);
+    }
+
+    void flush() override
+    {
+        _viewer->flushRenders();
+    }
+
+    const ProgramCache& getProgramCache() const
+    {
+        return _programCache;
+    }
+
+  private:
+    void requireMaterial() const
+    {
+        if (!_material)
+        {
+            throw mx::ExceptionRenderError("No material is loaded");
+        }
+    }
+
+    Viewer* _viewer;
+    ProgramCache _programCache;
+    mx::GlslMaterialPtr _material;
+    mx::GlslProgramPtr _defaultProgram;
+    std::map<std::string, mx::ValuePtr> _defaultValues;
+    bool _transparencyChanged = false;
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * A persistent, server-owned POSIX shared-memory ring of frame slots.
+ *
+ * Layout: a FrameRingHeader at offset zero, followed by slotCount slots of slotSize bytes each.
+ * Every slot begins with a FrameSlotHeader and is followed by the RGB8 pixels of one frame.
+ *
+ * Protocol: the server assigns each rendered frame the next sequence number and writes it to
+ * slot (sequence % slotCount).  Once the pixels are in place it stores the sequence number and
+ * then sets the slot state to READY with release ordering.  A client waiting for a frame polls
+ * its slot until the state is READY and the sequence matches, reads the pixels, and then sets
+ * the state back to FREE to hand the slot back to the server.  The server never overwrites a
+ * READY slot, and never waits on the client: if the slot of a new frame has not been released,
+ * the frame is dropped.
+ *
+ * The header is written once at creation for the benefit of clients.  Since clients map the
+ * ring writable, the server keeps its own copy of the ring geometry and never reads it back.
+ */
+class FrameRing
+{
+  public:
+    static constexpr uint32_t MAGIC = 0x5246584d; // "MXFR"
+    static constexpr uint32_t VERSION = 1;
+
+    enum SlotState : uint32_t {
+        SLOT_FREE = 0,
+        SLOT_WRITING = 1,
+        SLOT_READY = 2
+    };
+
+    struct FrameRingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t headerSize;
+        uint64_t slotSize;
+        uint64_t frameCapacity;
+    };
+
+    struct alignas(64) FrameSlotHeader {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint32_t> state;
+        uint32_t width;
+        uint32_t height;
+        uint32_t byteSize;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "Frame ring slots require lock-free atomics to be shared between processes");
+
+    static constexpr size_t HEADER_SIZE = 64;
+
+    /// Create a ring under the given shared-memory name, replacing any existing object of that name.
+    /// Returns nullptr on failure.
+    static std::unique_ptr<FrameRing> create(const std::string& name, uint32_t slotCount, size_t frameCapacity)
+    {
+        if (slotCount == 0 || frameCapacity == 0)
+        {
+            return nullptr;
+        }
+
+        size_t slotSize = alignUp(sizeof(FrameSlotHeader) + frameCapacity, 64);
+        size_t totalSize = HEADER_SIZE + slotSize * slotCount;
+
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd == -1)
+        {
+            return nullptr;
+        }
+        if (ftruncate(fd, (off_t) totalSize) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+        void* ptr = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED)
+        {
+            shm_unlink(name.c_str());
+            return nullptr;
+        }
+
+        std::unique_ptr<FrameRing> ring(new FrameRing(name, (char*) ptr, totalSize, slotCount, slotSize, frameCapacity));
+        FrameRingHeader* header = reinterpret_cast<FrameRingHeader*>(ptr);
+        header->magic = MAGIC;
+        header->version = VERSION;
+        header->slotCount = slotCount;
+        header->headerSize = (uint32_t) HEADER_SIZE;
+        header->slotSize = slotSize;
+        header->frameCapacity = frameCapacity;
+        for (uint32_t i = 0; i < slotCount; i++)
+        {
+            FrameSlotHeader* slot = new (ring->slotAddress(i)) FrameSlotHeader();
+            slot->sequence.store(0, std::memory_order_relaxed);
+            slot->state.store(SLOT_FREE, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return ring;
+    }
+
+    ~FrameRing()
+    {
+        munmap(_base, _size);
+        shm_unlink(_name.c_str());
+    }
+
+    /// Write a frame into the next slot, if the client has released it.
+    /// Returns the frame's sequence number, or zero if the frame was too large or the slot was not released.
+    uint64_t write(const void* pixels, uint32_t width, uint32_t height, size_t byteSize)
+    {
+        if (byteSize > _frameCapacity)
+        {
+            return 0;
+        }
+
+        uint64_t sequence = _nextSequence;
+        FrameSlotHeader* slot = slotAddress(getSlotIndex(sequence));
+
+        uint32_t expected = SLOT_FREE;
+        if (!slot->state.compare_exchange_strong(expected, SLOT_WRITING, std::memory_order_acquire))
+        {
+            _dropped++;
+            return 0;
+        }
+
+        slot->width = width;
+        slot->height = height;
+        slot->byteSize = (uint32_t) byteSize;
+        std::memcpy(reinterpret_cast<char*>(slot) + sizeof(FrameSlotHeader), pixels, byteSize);
+        slot->sequence.store(sequence, std::memory_order_relaxed);
+        slot->state.store(SLOT_READY, std::memory_order_release);
+
+        _nextSequence++;
+        return sequence;
+    }
+
+    /// Return the slot index holding the frame with the given sequence number.
+    uint32_t getSlotIndex(uint64_t sequence) const
+    {
+        return (uint32_t) (sequence % _slotCount);
+    }
+
+    const std::string& getName() const
+    {
+        return _name;
+    }
+
+    uint32_t getSlotCount() const
+    {
+        return _slotCount;
+    }
+
+    size_t getSlotSize() const
+    {
+        return _slotSize;
+    }
+
+    size_t getFrameCapacity() const
+    {
+        return _frameCapacity;
+    }
+
+    size_t getSize() const
+    {
+        return _size;
+    }
+
+    uint64_t getNextSequence() const
+    {
+        return _nextSequence;
+    }
+
+    size_t getDropped() const
+    {
+        return _dropped;
+    }
+
+  private:
+    FrameRing(const std::string& name, char* base, size_t size, uint32_t slotCount, size_t slotSize, size_t frameCapacity) :
+        _name(name),
+        _base(base),
+        _size(size),
+        _slotCount(slotCount),
+        _slotSize(slotSize),
+        _frameCapacity(frameCapacity)
+    {
+    }
+
+    static size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    FrameSlotHeader* slotAddress(uint32_t index) const
+    {
+        return reinterpret_cast<FrameSlotHeader*>(_base + HEADER_SIZE + (size_t) index * _slotSize);
+    }
+
+    std::string _name;
+    char* _base;
+    size_t _size;
+    const uint32_t _slotCount;
+    const size_t _slotSize;
+    const size_t _frameCapacity;
+
+    // Sequence numbers start at one, so that zero can mark a slot that was never written.
+    uint64_t _nextSequence = 1;
+    size_t _dropped = 0;
+};
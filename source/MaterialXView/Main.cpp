@@ -8,8 +8,10 @@
 #include <MaterialXRender/Util.h>
 #include <MaterialXFormat/Util.h>
 #include <MaterialXCore/Util.h>
+#include "BatchRendererGL.h"
 #include "Server.h"
 
+#include <fstream>
 #include <iostream>
 
 NANOGUI_FORCE_DISCRETE_GPU();
@@ -18,6 +20,14 @@ const std::string options =
     " Options: \n"
     "    --material [FILENAME]          Specify the filename of the MTLX document to be displayed in the viewer\n"
     "    --port [INTEGER]               Specify the port for the HTTP server receiving commands\n"
+    "    --batch [FILENAME]             Specify a job file to render without showing a window or starting the HTTP server\n"
+    "    --batchStream [FILENAME]       Specify a file to which batch frames are written as a packed raw stream, rather than to the image files named by each job\n"
+    "    --batchGroup [BOOLEAN]         Specify whether batch jobs are grouped by material and shader before rendering (defaults to false)\n"
+    "    --binaryCache [FILEPATH]       Specify a directory in which linked shader program binaries are cached across sessions\n"
+    "    --programCacheSize [INTEGER]   Specify the number of built shader programs the HTTP server keeps cached (defaults to 64)\n"
+    "    --serverThreads [INTEGER]      Specify the number of HTTP server threads parsing requests (defaults to 2)\n"
+    "    --encodeThreads [INTEGER]      Specify the number of HTTP server threads encoding responses (defaults to 2)\n"
+    "    --queueDepth [INTEGER]         Specify the maximum number of requests waiting for the render thread (defaults to 64)\n"
     "    --mesh [FILENAME]              Specify the filename of the OBJ mesh to be displayed in the viewer\n"
     "    --meshRotation [VECTOR3]       Specify the rotation of the displayed mesh as three comma-separated floats, representing rotations in degrees about the X, Y, and Z axes (defaults to 0,0,0)\n"
     "    --meshScale [FLOAT]            Specify the uniform scale of the displayed mesh\n"
@@ -71,6 +81,75 @@ template <class T> void parseToken(std::string token, std::string type, T& res)
     res = value->asA<T>();
 }
 
+// Render the jobs of the given job file with the viewer's window hidden, returning the process exit code.
+int runBatch(Viewer* viewer,
+             const std::string& jobFilename,
+             const std::string& streamFilename,
+             bool groupJobs,
+             const mx::Vector3& cameraPosition,
+             const mx::Vector3& cameraTarget,
+             float cameraViewAngle,
+             int width,
+             int height,
+             size_t programCacheSize)
+{
+    std::ifstream jobStream(jobFilename);
+    if (!jobStream)
+    {
+        std::cerr << "Unable to open batch job file: " << jobFilename << std::endl;
+        return 1;
+    }
+
+    mx::BatchFrameWriterPtr writer;
+    std::ofstream outputStream;
+    if (!streamFilename.empty())
+    {
+        outputStream.open(streamFilename, std::ios::binary);
+        if (!outputStream)
+        {
+            std::cerr << "Unable to open batch stream file: " << streamFilename << std::endl;
+            return 1;
+        }
+        writer = mx::BatchStreamWriter::create(outputStream);
+    }
+    else
+    {
+        writer = mx::BatchImageWriter::create(viewer->getImageHandler());
+    }
+
+    // Settings not given by the job file default to those of the command line.
+    mx::BatchJob defaults;
+    defaults.cameraPosition = cameraPosition;
+    defaults.cameraTarget = cameraTarget;
+    defaults.cameraViewAngle = cameraViewAngle;
+    defaults.width = (unsigned int) std::max(width, 1);
+    defaults.height = (unsigned int) std::max(height, 1);
+
+    auto renderer = std::make_shared<GLBatchRenderer>(viewer, programCacheSize);
+    mx::BatchRunnerPtr runner = mx::BatchRunner::create(renderer, writer);
+    runner->setGroupJobs(groupJobs);
+
+    mx::BatchJobReader reader(jobStream, defaults);
+    try
+    {
+        runner->run(reader);
+    }
+    catch (mx::Exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    for (const mx::BatchRunner::Failure& failure : runner->getFailures())
+    {
+        std::cerr << "Batch job " << failure.jobIndex << " (line " << failure.line << ") failed: " << failure.message << std::endl;
+    }
+    const mx::BatchRunner::Stats& stats = runner->getStats();
+    std::cout << "Rendered " << stats.framesWritten << " of " << stats.jobs << " batch jobs with "
+              << stats.materialLoads << " material loads and " << stats.shaderChanges << " shader changes" << std::endl;
+    return runner->getFailures().empty() ? 0 : 1;
+}
+
 int main(int argc, char* const argv[])
 {
     std::vector<std::string> tokens;
@@ -110,10 +189,19 @@ int main(int argc, char* const argv[])
     float refresh = 50.0f;
     bool frameTiming = false;
     int serverPort = 51515;
+    ServerOptions serverOptions;
+    int programCacheSize = (int) ProgramCache::DEFAULT_CAPACITY;
+    int serverThreads = (int) serverOptions.ioThreads;
+    int encodeThreads = (int) serverOptions.workerThreads;
+    int queueDepth = (int) serverOptions.maxQueueDepth;
+    mx::FilePath programBinaryCacheDir;
     bool enableTransparencyByDefault = false;
     bool enableDoubleSidedByDefault = true;
     bool disableMaterialUniforms = false;
     bool enableLookAt = false;
+    std::string batchFilename;
+    std::string batchStreamFilename;
+    bool batchGroup = false;
 
     for (size_t i = 0; i < tokens.size(); i++)
     {
@@ -127,6 +215,42 @@ int main(int argc, char* const argv[])
         {
             parseToken(nextToken, "integer", serverPort);
         }
+        else if (token == "--batch")
+        {
+            batchFilename = nextToken;
+        }
+        else if (token == "--batchStream")
+        {
+            batchStreamFilename = nextToken;
+        }
+        else if (token == "--batchGroup")
+        {
+            parseToken(nextToken, "boolean", batchGroup);
+        }
+        else if (token == "--serverThreads")
+        {
+            parseToken(nextToken, "integer", serverThreads);
+            serverThreads = std::max(serverThreads, 1);
+        }
+        else if (token == "--encodeThreads")
+        {
+            parseToken(nextToken, "integer", encodeThreads);
+            encodeThreads = std::max(encodeThreads, 1);
+        }
+        else if (token == "--queueDepth")
+        {
+            parseToken(nextToken, "integer", queueDepth);
+            queueDepth = std::max(queueDepth, 1);
+        }
+        else if (token == "--binaryCache")
+        {
+            programBinaryCacheDir = nextToken;
+        }
+        else if (token == "--programCacheSize")
+        {
+            parseToken(nextToken, "integer", programCacheSize);
+            programCacheSize = std::max(programCacheSize, 1);
+        }
         else if (token == "--mesh")
         {
             meshFilename = nextToken;
@@ -305,6 +429,11 @@ int main(int argc, char* const argv[])
     // Append the standard library folder, giving it a lower precedence than user-supplied libraries.
     libraryFolders.push_back("libraries");
 
+    if (!programBinaryCacheDir.isEmpty())
+    {
+        mx::GlslProgram::setBinaryCache(mx::ProgramBinaryCache::create(programBinaryCacheDir));
+    }
+
     ng::init();
 
     {
@@ -339,6 +468,16 @@ int main(int argc, char* const argv[])
         viewer->setDoubleSidedEnabled(enableDoubleSidedByDefault);
         viewer->initialize();
 
+        if (!batchFilename.empty())
+        {
+            int result = runBatch(viewer, batchFilename, batchStreamFilename, batchGroup,
+                                  cameraPosition, cameraTarget, cameraViewAngle,
+                                  screenWidth, screenHeight, (size_t) programCacheSize);
+            viewer = nullptr;
+            ng::shutdown();
+            return result;
+        }
+
         if (!captureFilename.empty())
         {
             viewer->requestFrameCapture(captureFilename);
@@ -356,8 +495,15 @@ int main(int argc, char* const argv[])
         }
 
         {
+            serverOptions.disableMaterialUniforms = disableMaterialUniforms;
+            serverOptions.enableLookAt = enableLookAt;
+            serverOptions.programCacheSize = (size_t) programCacheSize;
+            serverOptions.ioThreads = (size_t) serverThreads;
+            serverOptions.workerThreads = (size_t) encodeThreads;
+            serverOptions.maxQueueDepth = (size_t) queueDepth;
+
             Server webServer;
-            webServer.start_server(viewer, serverPort, disableMaterialUniforms, enableLookAt);
+            webServer.start_server(viewer, serverPort, serverOptions);
             ng::mainloop(refresh);
         }
     }
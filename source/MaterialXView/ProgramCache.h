@@ -0,0 +1,149 @@
+#pragma once
+
+#include <MaterialXCore/Util.h>
+#include <MaterialXGenShader/GenOptions.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXRenderGlsl/GlslProgram.h>
+
+#include <list>
+#include <unordered_map>
+
+namespace mx = MaterialX;
+
+/**
+ * A bounded LRU cache of built GLSL programs, shared across all materials of the render server.
+ *
+ * Programs are addressed by a hash of their vertex and fragment sources together with the
+ * generation options that affect the bound program, so an identical program is never rebuilt
+ * while it remains in the cache.  Hash collisions are resolved by comparing the stage sources
+ * stored on the cached program.
+ *
+ * A cached program may be shared by several materials.  Uniform values are state of the
+ * program object, so each material binds its own values in GlslMaterial::bindShader whenever
+ * another material's values are bound to the program.
+ */
+class ProgramCache
+{
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+    explicit ProgramCache(size_t capacity = DEFAULT_CAPACITY) :
+        _capacity(std::max<size_t>(capacity, 1))
+    {
+    }
+
+    /// Compute the cache key for the given stage sources and generation options.
+    static uint64_t computeKey(const std::string& vertex, const std::string& fragment, const mx::GenOptions& options)
+    {
+        uint64_t key = mx::hashString(vertex);
+        key = mx::hashString(fragment, key);
+
+        // Only the options which change how a program is bound and drawn take part in the key.
+        std::string optionString = std::to_string(options.hwTransparency) + ":" +
+                                   std::to_string(options.hwSpecularEnvironmentMethod) + ":" +
+                                   std::to_string(options.hwDirectionalAlbedoMethod) + ":" +
+                                   std::to_string(options.hwTransmissionRenderMethod) + ":" +
+                                   std::to_string(options.hwShadowMap) + ":" +
+                                   std::to_string(options.hwAmbientOcclusion) + ":" +
+                                   std::to_string(options.hwMaxActiveLightSources);
+        return mx::hashString(optionString, key);
+    }
+
+    /// Return the cached program for the given sources and options, or nullptr on a miss.
+    /// A hit marks the program as most recently used.
+    mx::GlslProgramPtr find(const std::string& vertex, const std::string& fragment, const mx::GenOptions& options)
+    {
+        auto it = _index.find(computeKey(vertex, fragment, options));
+        if (it != _index.end())
+        {
+            const mx::GlslProgramPtr& program = it->second->second;
+            if (program->getStageSourceCode(mx::Stage::VERTEX) == vertex &&
+                program->getStageSourceCode(mx::Stage::PIXEL) == fragment)
+            {
+                _entries.splice(_entries.begin(), _entries, it->second);
+                _stats.hits++;
+                return program;
+            }
+        }
+
+        _stats.misses++;
+        return nullptr;
+    }
+
+    /// Insert a built program, keyed by its own stage sources and the given options.
+    /// The least recently used program is evicted if the cache is full.
+    void insert(mx::GlslProgramPtr program, const mx::GenOptions& options)
+    {
+        if (!program)
+        {
+            return;
+        }
+
+        uint64_t key = computeKey(program->getStageSourceCode(mx::Stage::VERTEX),
+                                  program->getStageSourceCode(mx::Stage::PIXEL), options);
+        auto it = _index.find(key);
+        if (it != _index.end())
+        {
+            it->second->second = program;
+            _entries.splice(_entries.begin(), _entries, it->second);
+            return;
+        }
+
+        _entries.emplace_front(key, program);
+        _index[key] = _entries.begin();
+        evict();
+    }
+
+    /// Set the maximum number of programs held by the cache, evicting as needed.
+    void setCapacity(size_t capacity)
+    {
+        _capacity = std::max<size_t>(capacity, 1);
+        evict();
+    }
+
+    size_t getCapacity() const
+    {
+        return _capacity;
+    }
+
+    size_t size() const
+    {
+        return _entries.size();
+    }
+
+    const Stats& getStats() const
+    {
+        return _stats;
+    }
+
+    /// Remove all programs from the cache.  Counters are preserved.
+    void clear()
+    {
+        _entries.clear();
+        _index.clear();
+    }
+
+  private:
+    void evict()
+    {
+        while (_entries.size() > _capacity)
+        {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+            _stats.evictions++;
+        }
+    }
+
+    using Entry = std::pair<uint64_t, mx::GlslProgramPtr>;
+
+    size_t _capacity;
+    std::list<Entry> _entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> _index;
+    Stats _stats;
+};
@@ -10,6 +10,7 @@
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
 #include <MaterialXRenderGlsl/TextureBaker.h>
 #include <MaterialXRenderGlsl/GLFramebuffer.h>
+#include <MaterialXRenderGlsl/GLReadbackTarget.h>
 #include <MaterialXRenderGlsl/GlslMaterial.h>
 
 #include <nanogui/messagedialog.h>
@@ -198,8 +199,7 @@ void GLRenderPipeline::updatePrefilteredMap()
     }
 
     // Clean up.
-    glViewport(0, 0, _viewer->m_fbsize[0], _viewer->m_fbsize[1]);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    restoreSceneTarget();
 
     lightHandler->setEnvPrefilteredMap(outTex);
 }
@@ -292,9 +292,7 @@ mx::ImagePtr GLRenderPipeline::getShadowMap(int shadowMapSize)
             }
 
             // Restore state for scene rendering.
-            glViewport(0, 0, _viewer->m_fbsize[0], _viewer->m_fbsize[1]);
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-            glDrawBuffer(GL_BACK);
+            restoreSceneTarget();
         }
 
         // Reset frame timing after shadow generation.
@@ -569,6 +567,20 @@ void GLRenderPipeline::bakeTextures()
     glDrawBuffer(GL_BACK);
 }
 
+void GLRenderPipeline::restoreSceneTarget()
+{
+    if (_viewer->_offscreenSize.has_value())
+    {
+        mx::GLReadbackTargetPtr target = std::static_pointer_cast<mx::GLReadbackTarget>(_viewer->_readbackQueue->getTarget());
+        target->getFramebuffer()->bind();
+        return;
+    }
+
+    glViewport(0, 0, _viewer->m_fbsize[0], _viewer->m_fbsize[1]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glDrawBuffer(GL_BACK);
+}
+
 mx::ImagePtr GLRenderPipeline::getFrameImage()
 {
     glFinish();
@@ -49,6 +49,10 @@ class GLRenderPipeline : public RenderPipeline
   protected:
     std::optional<uint> timerQuery;
     mx::ImagePtr getShadowMap(int shadowMapSize) override;
+
+    // Rebind the target of scene rendering, which is either the offscreen
+    // readback framebuffer or the back buffer.
+    void restoreSceneTarget();
 };
 
 #endif // RENDER_PIPELINE_GL_H
@@ -15,11 +15,16 @@
 #define debug(x) #x << " = " << x
 
 #include "Viewer.h"
+#include "ProgramCache.h"
+#include "ServerQueue.h"
+#include "ServerMetrics.h"
+#include "FrameRing.h"
 #include <MaterialXGenShader/Shader.h>
 #include <MaterialXRender/ShaderRenderer.h>
 #include <MaterialXRenderGlsl/GlslMaterial.h>
 
 #include <csignal>
+#include <set>
 
 inline void handle_signal(int signal)
 {
@@ -47,6 +52,21 @@ inline Json::Value boolUniformToJson(std::string name)
     return v;
 }
 
+/**
+ * Configuration of the HTTP server and its request pipeline.
+ */
+struct ServerOptions {
+    bool disableMaterialUniforms = false;
+    bool enableLookAt = false;
+    size_t programCacheSize = ProgramCache::DEFAULT_CAPACITY;
+    // Threads handling HTTP connections and request parsing
+    size_t ioThreads = 2;
+    // Threads encoding responses
+    size_t workerThreads = 2;
+    // Maximum number of requests waiting for the render thread
+    size_t maxQueueDepth = RenderQueue::DEFAULT_MAX_DEPTH;
+};
+
 class ServerController : public drogon::HttpController<ServerController, false>
 {
   public:
@@ -55,83 +75,125 @@ class ServerController : public drogon::HttpController<ServerController, false>
     ADD_METHOD_TO(ServerController::getshader, "/getshader");
     ADD_METHOD_TO(ServerController::getuniforms, "/getuniforms");
     ADD_METHOD_TO(ServerController::setuniforms, "/setuniforms");
+    ADD_METHOD_TO(ServerController::resolveuniforms, "/resolveuniforms");
+    ADD_METHOD_TO(ServerController::setuniformdata, "/setuniformdata");
     ADD_METHOD_TO(ServerController::metrics, "/metrics");
+    ADD_METHOD_TO(ServerController::benchmark, "/benchmark");
     ADD_METHOD_TO(ServerController::setshader, "/setshader");
     ADD_METHOD_TO(ServerController::screenshot, "/screenshot");
+    ADD_METHOD_TO(ServerController::cachestats, "/cachestats");
+    ADD_METHOD_TO(ServerController::queuestats, "/queuestats");
+    ADD_METHOD_TO(ServerController::registerring, "/registerring");
     METHOD_LIST_END
 
-    struct CachedShader {
-        std::string vertex;
-        std::string fragment;
-        mx::GlslProgramPtr cache;
-        CachedShader() { }
-    };
+    using Callback = std::function<void (const drogon::HttpResponsePtr &)>;
+    using Encoder = std::function<drogon::HttpResponsePtr ()>;
 
-    struct ProgramCache {
-        static constexpr size_t CACHE_DEFAULT = 0;
-        std::array<CachedShader, 3> cachedShaders;
-        size_t next_tmp_cache = 1;
+    // State below is only accessed from the render thread, except for the pipeline itself.
+    ProgramCache programCache;
+    std::map<mx::MaterialPtr, mx::GlslProgramPtr> defaultPrograms;
+    std::map<mx::MaterialPtr, std::map<std::string, mx::ValuePtr>> defaultValues;
+    std::unique_ptr<FrameRing> frameRing;
 
-        void storeProgramInCache(mx::GlslMaterialPtr material, bool isDefault,
-            std::string vertex = "", std::string fragment = "")
-        {
-            size_t idx = isDefault ? CACHE_DEFAULT : next_tmp_cache;
-            if (!isDefault) {
-                // toggle between indices 1 and 2
-                next_tmp_cache = 3 - next_tmp_cache;
-            }
+    StageLatency latency;
+    ServerMetrics serverMetrics;
+    WorkerPool workers;
+    RenderQueue renderQueue;
 
-            if (vertex == "") {
-                vertex = material->getProgram()->getShader()->getSourceCode(mx::Stage::VERTEX);
-            }
+    static drogon::HttpResponsePtr errorResponse(drogon::HttpStatusCode code, const std::string& message)
+    {
+        auto resp = drogon::HttpResponse::newHttpResponse(code, drogon::ContentType::CT_TEXT_HTML);
+        resp->setBody(message);
+        return resp;
+    }
 
-            if (fragment == "") {
-                fragment = material->getProgram()->getShader()->getSourceCode(mx::Stage::PIXEL);
+    /**
+     * Queue work which must run on the render thread.  The work returns an encoder, which builds
+     * the response on a worker thread so that encoding never stalls rendering.  When the render
+     * queue is full, the request is refused with 503 and the client is expected to retry.  Work
+     * that throws is answered with 500.
+     */
+    void submitRenderWork(const Callback& callback, std::function<Encoder ()> work)
+    {
+        bool queued = renderQueue.submit([this, callback, work] () {
+            Encoder encode;
+            try {
+                encode = work();
+            } catch (std::exception& e) {
+                std::string message = std::string("Render work failed: ") + e.what();
+                encode = [message] () { return errorResponse(drogon::k500InternalServerError, message); };
             }
+            publishMetrics();
+            workers.post([this, callback, encode] () {
+                auto start = StageLatency::clock::now();
+                auto resp = encode();
+                latency.record("encode", start);
+                callback(resp);
+            });
+        });
 
-            std::cout << "Storing " <<
-                (idx == CACHE_DEFAULT ? "default" : "tmp") << " " << vertex.length() << " " << fragment.length() << std::endl;
-
-            cachedShaders[idx].vertex = vertex;
-            cachedShaders[idx].fragment = fragment;
-            cachedShaders[idx].cache = material->getProgram();
-        }
-
-        mx::GlslProgramPtr findProgram(std::string vertex, std::string fragment)
+        if (!queued)
         {
-            for (auto& cache: cachedShaders)
-            {
-                if (cache.vertex == vertex && cache.fragment == fragment)
-                {
-                    return cache.cache;
-                }
-            }
+            callback(errorResponse(drogon::k503ServiceUnavailable, "Render queue is full"));
+        }
+    }
 
-            return nullptr;
+    /**
+     * Publish snapshots of the statistics owned by the render thread.  Must be called on the render thread.
+     */
+    void publishMetrics()
+    {
+        const ProgramCache::Stats& stats = programCache.getStats();
+        serverMetrics.setValue("program_cache_hits_total", (double) stats.hits);
+        serverMetrics.setValue("program_cache_misses_total", (double) stats.misses);
+        serverMetrics.setValue("program_cache_evictions_total", (double) stats.evictions);
+        serverMetrics.setValue("program_cache_size", (double) programCache.size());
+
+        if (mx::ProgramBinaryCachePtr binaryCache = mx::GlslProgram::getBinaryCache()) {
+            const mx::ProgramBinaryCache::Stats& binaryStats = binaryCache->getStats();
+            serverMetrics.setValue("binary_cache_hits_total", (double) binaryStats.hits);
+            serverMetrics.setValue("binary_cache_misses_total", (double) binaryStats.misses);
+            serverMetrics.setValue("binary_cache_rejections_total", (double) binaryStats.rejections);
+            serverMetrics.setValue("binary_cache_bytes", (double) binaryCache->getTotalSize());
         }
 
-        mx::GlslProgramPtr& getDefault() {
-            return cachedShaders[CACHE_DEFAULT].cache;
+        if (frameRing) {
+            serverMetrics.setValue("frame_ring_dropped_total", (double) frameRing->getDropped());
         }
-    };
+    }
 
-    std::map<mx::MaterialPtr, ProgramCache> programCache;
-    std::map<mx::MaterialPtr, std::map<std::string, mx::ValuePtr>> defaultValues;
+    /**
+     * Count a handled request.  Unknown paths share one label, so that arbitrary requests cannot
+     * grow the set of exported metrics.
+     */
+    void countRequest(const std::string& path, int status)
+    {
+        static const std::set<std::string> endpoints = {
+            "/reset", "/getshader", "/getuniforms", "/setuniforms", "/resolveuniforms", "/setuniformdata",
+            "/metrics", "/benchmark", "/setshader", "/screenshot", "/cachestats", "/queuestats", "/registerring"
+        };
+        serverMetrics.countRequest(endpoints.count(path) ? path : "other", status);
+    }
 
-    void setProgram(mx::GlslMaterialPtr material, mx::GlslProgramPtr program)
+    /**
+     * Parse the JSON body of a request on the calling HTTP thread, recording the parse latency.
+     */
+    std::shared_ptr<Json::Value> parseJson(const drogon::HttpRequestPtr& req)
     {
-        std::vector<mx::MeshPartitionPtr> assignedMeshes;
-        for (auto& [mesh, materialAssignment] : viewer->_materialAssignments) {
-            if (materialAssignment == material) {
-                assignedMeshes.push_back(mesh);
-            }
-        }
+        auto start = StageLatency::clock::now();
+        auto json = req->getJsonObject();
+        latency.record("parse", start);
+        return json;
+    }
 
-        for (auto& mesh: assignedMeshes) {
-            viewer->assignMaterial(mesh, material, false);
-        }
+    void setProgram(mx::GlslMaterialPtr material, mx::GlslProgramPtr program)
+    {
+        viewer->setMaterialProgram(material, program);
+    }
 
-        material->setProgram(program);
+    const mx::GenOptions& programCacheOptions()
+    {
+        return viewer->getGenContext().getOptions();
     }
 
     std::string setShaderFromSource(mx::MaterialPtr _material, std::string vertex, std::string fragment)
@@ -143,9 +205,10 @@ class ServerController : public drogon::HttpController<ServerController, false>
             return "invalid material state!";
         }
 
-        if (auto cached = this->programCache[material].findProgram(vertex, fragment))
+        if (auto cached = programCache.find(vertex, fragment, programCacheOptions()))
         {
             setProgram(material, cached);
+            return "";
         }
 
         mx::GlslProgramPtr program = mx::GlslProgram::create();
@@ -153,7 +216,9 @@ class ServerController : public drogon::HttpController<ServerController, false>
         program->addStage(mx::Stage::PIXEL, fragment);
 
         try {
+            auto start = StageLatency::clock::now();
             program->build();
+            latency.record("compile", start);
         } catch (mx::ExceptionRenderError& e) {
             std::cout << "Failed to compile shader: " << e.what() << std::endl;
             std::string full_error;
@@ -166,38 +231,53 @@ class ServerController : public drogon::HttpController<ServerController, false>
         }
 
         setProgram(material, program);
-        programCache[material].storeProgramInCache(material, false, vertex, fragment);
+        programCache.insert(program, programCacheOptions());
         return "";
     }
 
     void reset(const drogon::HttpRequestPtr& req,
         std::function<void (const drogon::HttpResponsePtr &)> &&callback)
     {
-        ng::async([=] () mutable {
-            auto value = req->getJsonObject();
+        auto value = parseJson(req);
 
-            bool resetUniforms = true;
-            bool resetShader = true;
-            if (value && value->isObject()) {
-                resetUniforms = value->get("resetUniforms", true).asBool();
-            }
-            if (value && value->isObject()) {
-                resetShader = value->get("resetShader", true).asBool();
-            }
+        bool resetUniforms = true;
+        bool resetShader = true;
+        if (value && value->isObject()) {
+            resetUniforms = value->get("resetUniforms", true).asBool();
+        }
+        if (value && value->isObject()) {
+            resetShader = value->get("resetShader", true).asBool();
+        }
 
-            for (auto& mat : viewer->_materials) {
-                auto material = std::dynamic_pointer_cast<mx::GlslMaterial>(mat);
-                if (resetShader) {
-                    if (auto cached = this->programCache[material].getDefault()) {
+        submitRenderWork(callback, [=] () -> Encoder {
+            if (resetShader) {
+                // Generate the shaders of materials without a default program in parallel,
+                // and then build their programs on the render thread.
+                std::vector<mx::MaterialPtr> generated;
+                for (auto& mat : viewer->_materials) {
+                    auto material = std::dynamic_pointer_cast<mx::GlslMaterial>(mat);
+                    if (auto cached = this->defaultPrograms[material]) {
                         setProgram(material, cached);
                     } else {
                         material->unbindGeometry();
-                        material->generateShader(viewer->getGenContext());
-                        material->bindShader();
-                        programCache[material].storeProgramInCache(material, true);
+                        generated.push_back(material);
                     }
                 }
 
+                auto start = StageLatency::clock::now();
+                mx::generateShaders(generated, viewer->getGenContext());
+                latency.record("generate", start);
+
+                for (auto& mat : generated) {
+                    auto material = std::dynamic_pointer_cast<mx::GlslMaterial>(mat);
+                    material->bindShader();
+                    defaultPrograms[material] = material->getProgram();
+                    programCache.insert(material->getProgram(), programCacheOptions());
+                }
+            }
+
+            for (auto& mat : viewer->_materials) {
+                auto material = std::dynamic_pointer_cast<mx::GlslMaterial>(mat);
                 if (resetUniforms) {
                     for (auto& uniform: this->defaultValues[mat]) {
                         if (material->findUniform(uniform.first)) {
@@ -212,14 +292,14 @@ class ServerController : public drogon::HttpController<ServerController, false>
                 viewer->setCameraTarget(mx::Vector3(0, 0, 0));
             }
 
-            callback(drogon::HttpResponse::newHttpResponse());
+            return [] () { return drogon::HttpResponse::newHttpResponse(); };
         });
     }
 
     void getshader(const drogon::HttpRequestPtr& req,
         std::function<void (const drogon::HttpResponsePtr &)> &&callback)
     {
-        ng::async([=] () mutable {
+        submitRenderWork(callback, [=] () -> Encoder {
             Json::Value r;
             if (auto material = viewer->getSelectedMaterial())
             {
@@ -239,7 +319,7 @@ class ServerController : public drogon::HttpController<ServerController, false>
                 }
             }
 
-            callback(drogon::HttpResponse::newHttpJsonResponse(r));
+            return [r] () { return drogon::HttpResponse::newHttpJsonResponse(r); };
         });
     }
 
@@ -366,7 +446,7 @@ class ServerController : public drogon::HttpController<ServerController, false>
     void getuniforms(const drogon::HttpRequestPtr& req,
         std::function<void (const drogon::HttpResponsePtr &)> &&callback)
     {
-        ng::async([this, callback] () mutable {
+        submitRenderWork(callback, [this] () -> Encoder {
             Json::Value r = Json::arrayValue;
 
             auto cam = vecUniformToJson("camera", 3, -5, 5, "camera");
@@ -406,10 +486,41 @@ class ServerController : public drogon::HttpController<ServerController, false>
                 }
             }
 
-            callback(drogon::HttpResponse::newHttpJsonResponse(r));
+            return [r] () { return drogon::HttpResponse::newHttpJsonResponse(r); };
         });
     }
 
+    /**
+     * Check the structure of a list of uniform updates without touching render state,
+     * so that malformed requests are refused before they are queued.
+     */
+    static std::optional<std::string> validate_uniforms_json(const Json::Value& req)
+    {
+        for (auto it = req.begin(); it != req.end(); it++) {
+            const auto& uniformValue = *it;
+            if (!uniformValue.isObject() ||
+                !uniformValue.isMember("name") || !uniformValue["name"].isString() ||
+                !uniformValue.isMember("value"))
+            {
+                return std::string("Invalid request: wrong syntax (expected array of name and value)");
+            }
+
+            auto name = uniformValue["name"].asString();
+            const auto& value = uniformValue["value"];
+            if (name == "camera" &&
+                (!value.isArray() || value.size() != 3 || !value[0].isDouble() || !value[1].isDouble() || !value[2].isDouble()))
+            {
+                return std::string("Invalid request: wrong syntax (expected array of name and value)");
+            }
+            if (name == "lookAt" && (!value.isArray() || value.size() != 1 || !value[0].isDouble()))
+            {
+                return std::string("Invalid request: wrong syntax (lookAt should be a [float]!)");
+            }
+        }
+
+        return {};
+    }
+
     drogon::HttpResponsePtr set_uniforms_from_json(const Json::Value& req)
     {
         auto material = std::dynamic_pointer_cast<mx::GlslMaterial>(viewer->getSelectedMaterial());
@@ -488,7 +599,7 @@ class ServerController : public drogon::HttpController<ServerController, false>
         std::function<void (const drogon::HttpResponsePtr &)> &&callback)
     {
         std::cout << "setuniforms" << glfwGetTime() << std::endl;
-        auto req = _req->getJsonObject();
+        auto req = parseJson(_req);
         if (!req || !req->isArray()) {
             std::cout << "Invalid request: /setuniforms: expected json array" << std::endl;
             callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
@@ -496,10 +607,120 @@ class ServerController : public drogon::HttpController<ServerController, false>
             return;
         }
 
-        ng::async([this, callback, req] () mutable {
+        if (auto err = validate_uniforms_json(*req)) {
+            callback(errorResponse(drogon::k400BadRequest, err.value()));
+            return;
+        }
+
+        submitRenderWork(callback, [this, req] () -> Encoder {
+            auto start = StageLatency::clock::now();
             auto resp = set_uniforms_from_json(*req);
-            callback(resp);
+            latency.record("uniforms", start);
             std::cout << "setuniforms done" << glfwGetTime() << std::endl;
+            return [resp] () { return resp; };
+        });
+    }
+
+    void resolveuniforms(const drogon::HttpRequestPtr& _req,
+        std::function<void (const drogon::HttpResponsePtr &)> &&callback)
+    {
+        auto req = parseJson(_req);
+        if (!req || !req->isArray()) {
+            callback(errorResponse(drogon::k400BadRequest, "Invalid request: expected array of uniform paths"));
+            return;
+        }
+
+        std::vector<std::string> paths;
+        for (const auto& path : *req) {
+            if (!path.isString()) {
+                callback(errorResponse(drogon::k400BadRequest, "Invalid request: expected array of uniform paths"));
+                return;
+            }
+            paths.push_back(path.asString());
+        }
+
+        submitRenderWork(callback, [this, paths] () -> Encoder {
+            auto material = viewer->getSelectedMaterial();
+            if (!material) {
+                return [] () { return errorResponse(drogon::k400BadRequest, "No material selected"); };
+            }
+
+            // Handles stay valid until the shader changes; /setuniformdata reports stale handles.
+            Json::Value r;
+            r["handles"] = Json::arrayValue;
+            r["sizes"] = Json::arrayValue;
+            for (const auto& path : paths) {
+                int handle = material->resolveUniformHandle(path);
+                size_t size = 0;
+                if (auto uniform = material->getUniformFromHandle(handle)) {
+                    size = mx::UniformHandleTable::getPackedSize(uniform->getType());
+                    if (!this->defaultValues[material].count(uniform->getPath())) {
+                        // store in cache for later resets
+                        this->defaultValues[material][uniform->getPath()] = uniform->getValue();
+                    }
+                }
+                r["handles"].append(handle);
+                r["sizes"].append(Json::UInt64(size));
+            }
+            return [r] () { return drogon::HttpResponse::newHttpJsonResponse(r); };
+        });
+    }
+
+    /**
+     * Parse a packed uniform update: a little-endian uint32 count, followed by count int32
+     * handles from /resolveuniforms, followed by the packed float values of those uniforms.
+     */
+    static std::optional<std::string> parse_uniform_data(std::string_view body,
+        std::vector<int>& handles, std::vector<float>& data)
+    {
+        uint32_t count = 0;
+        if (body.size() < sizeof(count)) {
+            return std::string("Invalid request: missing uniform count");
+        }
+        memcpy(&count, body.data(), sizeof(count));
+        body.remove_prefix(sizeof(count));
+
+        if (body.size() < (size_t) count * sizeof(int32_t)) {
+            return std::string("Invalid request: missing uniform handles");
+        }
+        handles.resize(count);
+        memcpy(handles.data(), body.data(), (size_t) count * sizeof(int32_t));
+        body.remove_prefix((size_t) count * sizeof(int32_t));
+
+        if (body.size() % sizeof(float) != 0) {
+            return std::string("Invalid request: uniform data is not a whole number of floats");
+        }
+        data.resize(body.size() / sizeof(float));
+        memcpy(data.data(), body.data(), body.size());
+        return {};
+    }
+
+    void setuniformdata(const drogon::HttpRequestPtr& req,
+        std::function<void (const drogon::HttpResponsePtr &)> &&callback)
+    {
+        auto start = StageLatency::clock::now();
+        auto handles = std::make_shared<std::vector<int>>();
+        auto data = std::make_shared<std::vector<float>>();
+        auto err = parse_uniform_data(req->getBody(), *handles, *data);
+        latency.record("parse", start);
+        if (err) {
+            callback(errorResponse(drogon::k400BadRequest, err.value()));
+            return;
+        }
+
+        submitRenderWork(callback, [this, handles, data] () -> Encoder {
+            auto material = viewer->getSelectedMaterial();
+            if (!material) {
+                return [] () { return errorResponse(drogon::k400BadRequest, "No material selected"); };
+            }
+            auto start = StageLatency::clock::now();
+            bool modified = material->modifyUniforms(*handles, data->data(), data->size());
+            latency.record("uniforms", start);
+            if (!modified) {
+                // Either the shader changed since the handles were resolved, or the data does not match them.
+                return [] () { return errorResponse(drogon::k409Conflict, "Stale uniform handles or mismatched data size"); };
+            }
+            return [] () { return drogon::HttpResponse::newHttpResponse(); };
         });
     }
 
@@ -550,7 +771,7 @@ class ServerController : public drogon::HttpController<ServerController, false>
     void setshader(const drogon::HttpRequestPtr& _req,
         std::function<void (const drogon::HttpResponsePtr &)> &&callback)
     {
-        auto req = _req->getJsonObject();
+        auto req = parseJson(_req);
         if (!req) {
             std::cout << "Invalid request: /setshader" << std::endl;
             callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
@@ -559,17 +780,43 @@ class ServerController : public drogon::HttpController<ServerController, false>
         }
         std::cout << "Got request for set shader " << glfwGetTime() << std::endl;
 
-        ng::async([=] () mutable
+        submitRenderWork(callback, [=] () -> Encoder
         {
             std::cout << "Dispatching request for set shader" << std::endl;
-            callback(set_shader_from_json(*req));
+            auto resp = set_shader_from_json(*req);
+            return [resp] () { return resp; };
         });
     }
 
+    /**
+     * A caller-provided shared memory file, mapped for the duration of one screenshot request.
+     */
+    struct SharedMapping {
+        int fd = -1;
+        void *ptr = nullptr;
+        size_t size = 0;
+
+        ~SharedMapping() {
+            close();
+        }
+
+        void close() {
+            if (ptr) {
+                msync(ptr, size, MS_SYNC);
+                munmap(ptr, size);
+                ptr = nullptr;
+            }
+            if (fd != -1) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    };
+
     void screenshot(const drogon::HttpRequestPtr& _req,
         std::function<void (const drogon::HttpResponsePtr &)> &&callback)
     {
-        auto req = _req->getJsonObject();
+        auto req = parseJson(_req);
         if (!req) {
             std::cout << "Invalid request: /screenshot" << std::endl;
             callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
@@ -581,40 +828,43 @@ class ServerController : public drogon::HttpController<ServerController, false>
         int h = req->get("height", viewer->height()).asInt();
         //std::cout << "Pending screenshot: " << " width=" << w << " height=" << h << " " << glfwGetTime() << std::endl;
 
-        ng::async([=] () mutable {
-            if (req->isMember("variants") &&
-                req->get("variants", Json::nullValue).isArray())
-            {
-                Json::Value response = Json::arrayValue;
-                auto variants = req->get("variants", Json::nullValue);
-                size_t offset = 0;
-
-                int mapfd = -1;
-                void *mapptr = nullptr;
-                size_t mapfile_size = w * h * 3 * variants.size();
-
-                if (req->isMember("mapfile") and req->get("mapfile", Json::nullValue).isString()) {
-                    std::string mapfile = req->get("mapfile", Json::nullValue).asString();
-
-                    mapfd = shm_open(mapfile.c_str(), O_RDWR, 0);
-                    if (mapfd == -1) {
-                        std::cout << "Failed to open mapfile: " << mapfile << std::endl;
-                        callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
-                                drogon::ContentType::CT_TEXT_HTML));
-                        return;
-                    }
+        if (req->isMember("variants") &&
+            req->get("variants", Json::nullValue).isArray())
+        {
+            auto variants = req->get("variants", Json::nullValue);
+            bool useRing = req->get("ring", false).asBool();
+
+            // Map the caller's file before queueing, so that a bad mapfile is refused without rendering.
+            auto mapping = std::make_shared<SharedMapping>();
+            if (req->isMember("mapfile") and req->get("mapfile", Json::nullValue).isString()) {
+                std::string mapfile = req->get("mapfile", Json::nullValue).asString();
+                mapping->size = w * h * 3 * variants.size();
+
+                mapping->fd = shm_open(mapfile.c_str(), O_RDWR, 0);
+                if (mapping->fd == -1) {
+                    std::cout << "Failed to open mapfile: " << mapfile << std::endl;
+                    callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
+                            drogon::ContentType::CT_TEXT_HTML));
+                    return;
+                }
 
-                    mapptr = mmap(nullptr, mapfile_size, PROT_WRITE, MAP_SHARED, mapfd, 0);
-                    if (mapptr == MAP_FAILED) {
-                        std::cout << "Failed to mmap mapfile: " << mapfile << " " << strerror(errno) << std::endl;
-                        close(mapfd);
-                        callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
-                                drogon::ContentType::CT_TEXT_HTML));
-                        return;
-                    }
+                void *ptr = mmap(nullptr, mapping->size, PROT_WRITE, MAP_SHARED, mapping->fd, 0);
+                if (ptr == MAP_FAILED) {
+                    std::cout << "Failed to mmap mapfile: " << mapfile << " " << strerror(errno) << std::endl;
+                    callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
+                            drogon::ContentType::CT_TEXT_HTML));
+                    return;
                 }
+                mapping->ptr = ptr;
+            }
 
+            submitRenderWork(callback, [=] () -> Encoder {
+                if (useRing && !frameRing) {
+                    return [] () { return errorResponse(drogon::k400BadRequest, "No frame ring registered"); };
+                }
 
+                std::vector<mx::ImagePtr> images;
+                Json::Value ringFrames = Json::arrayValue;
                 for (int i = 0; i < (int)variants.size(); ++i)
                 {
                     if (variants[i].isObject())
@@ -631,15 +881,52 @@ class ServerController : public drogon::HttpController<ServerController, false>
                             }
                         }
 
-                        auto imgdata = viewer->getNextRender(w, h);
+                        // Frame N+1 renders while the readback of frame N is in flight.
+                        viewer->requestRender(w, h, [&] (uint64_t, mx::ImagePtr imgdata) {
+                            if (useRing) {
+                                // Publish each frame as soon as its readback completes, so clients can consume it immediately.
+                                Json::Value frame = Json::objectValue;
+                                frame["width"] = imgdata->getWidth();
+                                frame["height"] = imgdata->getHeight();
+                                size_t bytesize = imgdata->getWidth() * imgdata->getHeight() * 3;
+                                uint64_t sequence = frameRing->write(imgdata->getResourceBuffer(),
+                                    imgdata->getWidth(), imgdata->getHeight(), bytesize);
+                                if (sequence) {
+                                    frame["sequence"] = Json::UInt64(sequence);
+                                    frame["slot"] = frameRing->getSlotIndex(sequence);
+                                } else {
+                                    frame["dropped"] = true;
+                                }
+                                ringFrames.append(frame);
+                            } else {
+                                images.push_back(imgdata);
+                            }
+                        });
+                    }
+                }
+
+                viewer->flushRenders();
+
+                if (useRing) {
+                    return [ringFrames] () { return drogon::HttpResponse::newHttpJsonResponse(ringFrames); };
+                }
+
+                // Copying and encoding the frames happens on a worker thread.
+                return [images, mapping] () {
+                    Json::Value response = Json::arrayValue;
+                    size_t offset = 0;
+                    for (auto& imgdata : images)
+                    {
                         Json::Value img = Json::objectValue;
                         img["width"] = imgdata->getWidth();
                         img["height"] = imgdata->getHeight();
                         img["offset"] = offset;
 
                         size_t bytesize = imgdata->getWidth() * imgdata->getHeight() * 3;
-                        if (mapptr) {
-                            memcpy((char*)mapptr + offset, imgdata->getResourceBuffer(), bytesize);
+                        if (mapping->ptr) {
+                            if (offset + bytesize <= mapping->size) {
+                                memcpy((char*)mapping->ptr + offset, imgdata->getResourceBuffer(), bytesize);
+                            }
                         } else {
                             img["data"] = drogon::utils::base64Encode(
                                 (const unsigned char*)imgdata->getResourceBuffer(), bytesize);
@@ -648,39 +935,62 @@ class ServerController : public drogon::HttpController<ServerController, false>
                         offset += bytesize;
                         response.append(img);
                     }
-                }
 
-                if (mapptr) {
-                    msync(mapptr, mapfile_size, MS_SYNC);
-                    munmap(mapptr, mapfile_size);
-                    close(mapfd);
-                }
-
-                callback(drogon::HttpResponse::newHttpJsonResponse(response));
-            } else
-            {
-                // single screenshot, older interface
+                    mapping->close();
+                    return drogon::HttpResponse::newHttpJsonResponse(response);
+                };
+            });
+        } else
+        {
+            // single screenshot, older interface
+            submitRenderWork(callback, [=] () -> Encoder {
                 auto img = viewer->getNextRender(w, h);
-                auto resp = drogon::HttpResponse::newHttpResponse();
-                resp->setContentTypeCode(drogon::CT_CUSTOM);
-                int width = img->getWidth();
-                int height = img->getHeight();
-
-                resp->addCookie("width", std::to_string(width));
-                resp->addCookie("height", std::to_string(height));
-                unsigned char* data = (unsigned char*)img->getResourceBuffer();
-                resp->setBody(std::string(data, data + width * height * 3));
-                callback(resp);
-            }
-        });
+                return [img] () {
+                    auto resp = drogon::HttpResponse::newHttpResponse();
+                    resp->setContentTypeCode(drogon::CT_CUSTOM);
+                    int width = img->getWidth();
+                    int height = img->getHeight();
+
+                    resp->addCookie("width", std::to_string(width));
+                    resp->addCookie("height", std::to_string(height));
+                    unsigned char* data = (unsigned char*)img->getResourceBuffer();
+                    resp->setBody(std::string(data, data + width * height * 3));
+                    return resp;
+                };
+            });
+        }
+    }
+
+    /**
+     * Report server telemetry in the Prometheus text format.  Answered directly from the HTTP
+     * thread, from snapshots published by the render thread.  For compatibility, a request with
+     * a JSON body runs the GPU benchmark of /benchmark instead.
+     */
+    void metrics(const drogon::HttpRequestPtr& req,
+            std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
+
+        if (req->getJsonObject()) {
+            benchmark(req, std::move(callback));
+            return;
+        }
+
+        serverMetrics.setValue("render_queue_depth", (double) renderQueue.getDepth());
+        serverMetrics.setValue("render_queue_max_depth", (double) renderQueue.getMaxDepth());
+        serverMetrics.setValue("render_queue_submitted_total", (double) renderQueue.getSubmitted());
+        serverMetrics.setValue("render_queue_rejected_total", (double) renderQueue.getRejected());
+        serverMetrics.setValue("render_queue_failed_total", (double) renderQueue.getFailed());
+
+        auto resp = drogon::HttpResponse::newHttpResponse(drogon::k200OK, drogon::ContentType::CT_TEXT_PLAIN);
+        resp->setBody(serverMetrics.format(latency));
+        callback(resp);
     }
 
-    void metrics(const drogon::HttpRequestPtr& _req,
+    void benchmark(const drogon::HttpRequestPtr& _req,
             std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
 
-        auto req = _req->getJsonObject();
+        auto req = parseJson(_req);
         if (!req) {
-            std::cout << "Invalid request: /metrics" << std::endl;
+            std::cout << "Invalid request: /benchmark" << std::endl;
             callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
                     drogon::ContentType::CT_TEXT_HTML));
             return;
@@ -697,33 +1007,129 @@ class ServerController : public drogon::HttpController<ServerController, false>
             return;
         }
 
-        ng::async([=] () mutable {
+        submitRenderWork(callback, [=] () -> Encoder {
             std::cout << "Running benchmark " << width << " " << height << " " << nr_frames << std::endl;
             GLuint64 speed = viewer->runBenchmark(warmup, nr_frames, width, height);
             std::cout << "Results: " << speed << std::endl;
             Json::Value r;
-            r["speed"] = speed;
-            callback(drogon::HttpResponse::newHttpJsonResponse(r));
+            r["speed"] = Json::UInt64(speed);
+            return [r] () { return drogon::HttpResponse::newHttpJsonResponse(r); };
+        });
+    }
+
+    void cachestats(const drogon::HttpRequestPtr& _req,
+            std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
+
+        submitRenderWork(callback, [=] () -> Encoder {
+            const ProgramCache::Stats& stats = programCache.getStats();
+            Json::Value r;
+            r["hits"] = Json::UInt64(stats.hits);
+            r["misses"] = Json::UInt64(stats.misses);
+            r["evictions"] = Json::UInt64(stats.evictions);
+            r["size"] = Json::UInt64(programCache.size());
+            r["capacity"] = Json::UInt64(programCache.getCapacity());
+            return [r] () { return drogon::HttpResponse::newHttpJsonResponse(r); };
+        });
+    }
+
+    void queuestats(const drogon::HttpRequestPtr& _req,
+            std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
+
+        // Answered directly from the HTTP thread, so it stays responsive while the render queue is busy.
+        Json::Value r;
+        r["depth"] = Json::UInt64(renderQueue.getDepth());
+        r["maxDepth"] = Json::UInt64(renderQueue.getMaxDepth());
+        r["submitted"] = Json::UInt64(renderQueue.getSubmitted());
+        r["rejected"] = Json::UInt64(renderQueue.getRejected());
+        r["failed"] = Json::UInt64(renderQueue.getFailed());
+        r["stages"] = Json::objectValue;
+        for (const auto& [stage, entry] : latency.getEntries()) {
+            Json::Value v;
+            v["count"] = Json::UInt64(entry.count);
+            v["meanSeconds"] = entry.count ? entry.totalSeconds / entry.count : 0.0;
+            v["maxSeconds"] = entry.maxSeconds;
+            r["stages"][stage] = v;
+        }
+        callback(drogon::HttpResponse::newHttpJsonResponse(r));
+    }
+
+    void registerring(const drogon::HttpRequestPtr& _req,
+            std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
+
+        auto req = parseJson(_req);
+        if (!req || !req->isObject()) {
+            std::cout << "Invalid request: /registerring" << std::endl;
+            callback(drogon::HttpResponse::newHttpResponse(drogon::k400BadRequest,
+                    drogon::ContentType::CT_TEXT_HTML));
+            return;
+        }
+
+        int slots = req->get("slots", 8).asInt();
+        int width = req->get("width", 0).asInt();
+        int height = req->get("height", 0).asInt();
+        std::string name = req->get("name", "/materialxview_ring_" + std::to_string(getpid())).asString();
+        if (slots <= 0 || slots > 1024 || width <= 0 || height <= 0 || width > 8192 || height > 8192 ||
+            name.size() < 2 || name[0] != '/') {
+            callback(errorResponse(drogon::k400BadRequest, "Invalid ring: expected slots, width, height and a '/name'"));
+            return;
+        }
+
+        submitRenderWork(callback, [=] () -> Encoder {
+            // Replacing a ring unlinks the previous one, so only one client owns the ring at a time.
+            frameRing.reset();
+            frameRing = FrameRing::create(name, (uint32_t) slots, (size_t) width * height * 3);
+            if (!frameRing) {
+                std::cout << "Failed to create frame ring: " << name << " " << strerror(errno) << std::endl;
+                return [] () { return errorResponse(drogon::k500InternalServerError, "Failed to create frame ring"); };
+            }
+
+            Json::Value r;
+            r["name"] = frameRing->getName();
+            r["slots"] = frameRing->getSlotCount();
+            r["headerSize"] = Json::UInt64(FrameRing::HEADER_SIZE);
+            r["slotHeaderSize"] = Json::UInt64(sizeof(FrameRing::FrameSlotHeader));
+            r["slotSize"] = Json::UInt64(frameRing->getSlotSize());
+            r["frameCapacity"] = Json::UInt64(frameRing->getFrameCapacity());
+            r["size"] = Json::UInt64(frameRing->getSize());
+            r["nextSequence"] = Json::UInt64(frameRing->getNextSequence());
+            return [r] () { return drogon::HttpResponse::newHttpJsonResponse(r); };
         });
     }
 
     ng::ref<Viewer> viewer;
     bool disableMaterialUniforms = false;
     bool enableLookAt = false;
-    ServerController(ng::ref<Viewer> viewer, bool disableMaterialUniforms, bool enableLookAt) :
-        viewer(viewer), disableMaterialUniforms(disableMaterialUniforms), enableLookAt(enableLookAt) {}
+    ServerController(ng::ref<Viewer> viewer, const ServerOptions& options) :
+        programCache(options.programCacheSize),
+        workers(options.workerThreads),
+        renderQueue([] (RenderQueue::Command command) { ng::async(command); }, latency, options.maxQueueDepth),
+        viewer(viewer),
+        disableMaterialUniforms(options.disableMaterialUniforms),
+        enableLookAt(options.enableLookAt)
+    {
+        viewer->setStageTimingCallback([this] (const std::string& stage, double seconds) {
+            latency.record(stage, seconds);
+        });
+        renderQueue.setErrorHandler([] (std::exception_ptr error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (std::exception& e) {
+                std::cout << "Render command failed: " << e.what() << std::endl;
+            } catch (...) {
+                std::cout << "Render command failed" << std::endl;
+            }
+        });
+    }
 };
 
 /**
  * A simple class which encapsulates the state used for setting the shader and current material remotely.
  */
 class Server {
-    bool disableMaterialUniforms;
-    bool enableLookAt;
+    ServerOptions options;
   public:
-    void start_server(ng::ref<Viewer> viewer, int port, bool disableMaterialUniforms, bool enableLookAt) {
-        this->disableMaterialUniforms = disableMaterialUniforms;
-        this->enableLookAt = enableLookAt;
+    void start_server(ng::ref<Viewer> viewer, int port, const ServerOptions& options) {
+        this->options = options;
         viewer->setFrameTiming(true);
         std::cout << "Starting HTTP Server... at port=" << port << std::endl;
         server_thread = std::thread([=] () {
@@ -750,14 +1156,18 @@ class Server {
             std::signal(SIGTERM, handle_signal);
         });
 
+        auto controller = std::make_shared<ServerController>(viewer, options);
         main_running = true;
         drogon::app()
             .setClientMaxBodySize(std::numeric_limits<size_t>::max())
             .setLogPath("./")
             .setLogLevel(trantor::Logger::kWarn)
             .addListener("0.0.0.0", port)
-            .setThreadNum(1)
-            .registerController(std::make_shared<ServerController>(viewer, disableMaterialUniforms, enableLookAt))
+            .setThreadNum(options.ioThreads)
+            .registerController(controller)
+            .registerPostHandlingAdvice([controller] (const drogon::HttpRequestPtr& req, const drogon::HttpResponsePtr& resp) {
+                controller->countRequest(req->path(), (int) resp->statusCode());
+            })
             .run();
     }
 
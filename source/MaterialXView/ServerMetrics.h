@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ServerQueue.h"
+
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+
+/**
+ * Counters and gauges of the render server, rendered together with the stage latency histograms
+ * in the Prometheus text exposition format.
+ *
+ * Requests are counted per endpoint and status code from the HTTP threads.  Values owned by the
+ * render thread, such as cache statistics, are published as snapshots after each render command,
+ * so that the metrics endpoint never waits on the render queue.  Values whose name ends in
+ * "_total" are exposed as counters, and all others as gauges.
+ */
+class ServerMetrics
+{
+  public:
+    static constexpr const char* PREFIX = "materialxview_";
+
+    void countRequest(const std::string& endpoint, int status)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _requests[{ endpoint, status }]++;
+    }
+
+    void setValue(const std::string& name, double value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _values[name] = value;
+    }
+
+    std::string format(const StageLatency& latency) const
+    {
+        std::ostringstream out;
+        out.precision(9);
+
+        auto entries = latency.getEntries();
+        out << "# HELP " << PREFIX << "stage_seconds Time spent in each stage of request processing.\n";
+        out << "# TYPE " << PREFIX << "stage_seconds histogram\n";
+        for (const auto& [stage, entry] : entries)
+        {
+            size_t cumulative = 0;
+            for (size_t i = 0; i < StageLatency::BUCKET_BOUNDS.size(); i++)
+            {
+                cumulative += entry.buckets[i];
+                out << PREFIX << "stage_seconds_bucket{stage=\"" << stage << "\",le=\""
+                    << StageLatency::BUCKET_BOUNDS[i] << "\"} " << cumulative << "\n";
+            }
+            out << PREFIX << "stage_seconds_bucket{stage=\"" << stage << "\",le=\"+Inf\"} " << entry.count << "\n";
+            out << PREFIX << "stage_seconds_sum{stage=\"" << stage << "\"} " << entry.totalSeconds << "\n";
+            out << PREFIX << "stage_seconds_count{stage=\"" << stage << "\"} " << entry.count << "\n";
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        out << "# HELP " << PREFIX << "requests_total Requests handled per endpoint and status code.\n";
+        out << "# TYPE " << PREFIX << "requests_total counter\n";
+        for (const auto& [key, count] : _requests)
+        {
+            out << PREFIX << "requests_total{endpoint=\"" << key.first << "\",code=\"" << key.second << "\"} " << count << "\n";
+        }
+
+        for (const auto& [name, value] : _values)
+        {
+            bool counter = name.size() > 6 && name.compare(name.size() - 6, 6, "_total") == 0;
+            out << "# TYPE " << PREFIX << name << (counter ? " counter\n" : " gauge\n");
+            out << PREFIX << name << " " << value << "\n";
+        }
+        return out.str();
+    }
+
+  private:
+    mutable std::mutex _mutex;
+    std::map<std::pair<std::string, int>, size_t> _requests;
+    std::map<std::string, double> _values;
+};
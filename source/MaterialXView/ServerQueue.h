@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Thread-safe latency statistics, accumulated per named stage of request processing.
+ *
+ * Each stage keeps a histogram over fixed bucket bounds, from 100 microseconds to 10 seconds,
+ * with a final bucket for longer samples.
+ */
+class StageLatency
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr std::array<double, 16> BUCKET_BOUNDS = {
+        0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+        0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+    };
+
+    struct Entry {
+        size_t count = 0;
+        double totalSeconds = 0.0;
+        double maxSeconds = 0.0;
+        // Sample counts per bucket, not cumulative, with the last bucket counting samples above every bound.
+        std::array<size_t, BUCKET_BOUNDS.size() + 1> buckets = {};
+    };
+
+    void record(const std::string& stage, double seconds)
+    {
+        size_t bucket = std::lower_bound(BUCKET_BOUNDS.begin(), BUCKET_BOUNDS.end(), seconds) - BUCKET_BOUNDS.begin();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        Entry& entry = _entries[stage];
+        entry.count++;
+        entry.totalSeconds += seconds;
+        entry.maxSeconds = std::max(entry.maxSeconds, seconds);
+        entry.buckets[bucket]++;
+    }
+
+    void record(const std::string& stage, clock::time_point start)
+    {
+        record(stage, std::chrono::duration<double>(clock::now() - start).count());
+    }
+
+    std::map<std::string, Entry> getEntries() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _entries;
+    }
+
+  private:
+    mutable std::mutex _mutex;
+    std::map<std::string, Entry> _entries;
+};
+
+/**
+ * A fixed pool of worker threads running tasks in submission order, used for request
+ * parsing and response encoding away from the render thread.
+ */
+class WorkerPool
+{
+  public:
+    explicit WorkerPool(size_t threadCount)
+    {
+        for (size_t i = 0; i < std::max<size_t>(threadCount, 1); i++)
+        {
+            _threads.emplace_back([this] () { run(); });
+        }
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        for (auto& thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push_back(std::move(task));
+        }
+        _condition.notify_one();
+    }
+
+  private:
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this] () { return _stopping || !_tasks.empty(); });
+                if (_tasks.empty())
+                {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<std::function<void()>> _tasks;
+    std::vector<std::thread> _threads;
+    bool _stopping = false;
+};
+
+/**
+ * A bounded, single-consumer queue of commands which must run on the render thread.
+ *
+ * Producers on any thread submit commands, which are refused once the queue holds its maximum
+ * depth so that callers can apply back-pressure.  The consumer is scheduled through the given
+ * dispatch function, and executes pipelined commands back to back in submission order, yielding
+ * after each batch so that the render thread keeps processing its own events.  Commands are
+ * expected to report their own errors; an exception escaping a command is passed to the error
+ * handler, and never stops the processing of later commands.
+ */
+class RenderQueue
+{
+  public:
+    using Command = std::function<void()>;
+    using Dispatch = std::function<void(Command)>;
+    using ErrorHandler = std::function<void(std::exception_ptr)>;
+
+    static constexpr size_t DEFAULT_MAX_DEPTH = 64;
+
+    RenderQueue(Dispatch dispatch, StageLatency& latency, size_t maxDepth = DEFAULT_MAX_DEPTH) :
+        _dispatch(std::move(dispatch)),
+        _latency(latency),
+        _maxDepth(std::max<size_t>(maxDepth, 1))
+    {
+    }
+
+    /// Submit a command for the render thread, returning false if the queue is full.
+    bool submit(Command command)
+    {
+        bool scheduleDrain = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_commands.size() >= _maxDepth)
+            {
+                _rejected++;
+                return false;
+            }
+            _commands.push_back({ std::move(command), StageLatency::clock::now() });
+            _submitted++;
+            scheduleDrain = !_drainScheduled;
+            _drainScheduled = true;
+        }
+
+        if (scheduleDrain)
+        {
+            _dispatch([this] () { drain(); });
+        }
+        return true;
+    }
+
+    /// Set the handler called with exceptions escaping a command.
+    void setErrorHandler(ErrorHandler handler)
+    {
+        _errorHandler = std::move(handler);
+    }
+
+    /// Execute the pending commands.  Must be called on the render thread.
+    void drain()
+    {
+        size_t batchSize;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            batchSize = _commands.size();
+        }
+
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            Pending pending;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                pending = std::move(_commands.front());
+                _commands.pop_front();
+            }
+
+            auto start = StageLatency::clock::now();
+            _latency.record("queue", std::chrono::duration<double>(start - pending.submitTime).count());
+            try
+            {
+                pending.command();
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _failed++;
+                }
+                if (_errorHandler)
+                {
+                    _errorHandler(std::current_exception());
+                }
+            }
+            _latency.record("render", start);
+        }
+
+        bool scheduleDrain = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            scheduleDrain = !_commands.empty();
+            _drainScheduled = scheduleDrain;
+        }
+        if (scheduleDrain)
+        {
+            _dispatch([this] () { drain(); });
+        }
+    }
+
+    size_t getDepth() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _commands.size();
+    }
+
+    size_t getMaxDepth() const
+    {
+        return _maxDepth;
+    }
+
+    size_t getSubmitted() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _submitted;
+    }
+
+    size_t getRejected() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _rejected;
+    }
+
+    size_t getFailed() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _failed;
+    }
+
+  private:
+    struct Pending {
+        Command command;
+        StageLatency::clock::time_point submitTime;
+    };
+
+    Dispatch _dispatch;
+    ErrorHandler _errorHandler;
+    StageLatency& _latency;
+    const size_t _maxDepth;
+
+    mutable std::mutex _mutex;
+    std::deque<Pending> _commands;
+    bool _drainScheduled = false;
+    size_t _submitted = 0;
+    size_t _rejected = 0;
+    size_t _failed = 0;
+};
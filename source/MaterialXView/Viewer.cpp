@@ -12,6 +12,7 @@
 #include <MaterialXGenMsl/MslShaderGenerator.h>
 #include <nanogui/metal.h>
 #else
+#include <MaterialXRenderGlsl/GLReadbackTarget.h>
 #include <MaterialXRenderGlsl/GLUtil.h>
 #include <MaterialXView/RenderPipelineGL.h>
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
@@ -129,7 +130,7 @@ void applyModifiers(mx::DocumentPtr doc, const DocumentModifiers& modifiers)
         if (node && node->getCategory() == "texcoord")
         {
             mx::InputPtr index = node->getInput("index");
-            mx::ValuePtr value = index ? index->getValue() : nullptr;
+            mx::ConstValuePtr value = index ? index->getValue() : nullptr;
             if (value && value->isA<int>() && value->asA<int>() != 0)
             {
                 index->setValue(0);
@@ -1283,7 +1284,7 @@ void Viewer::loadDocument(const mx::FilePath& filename, mx::DocumentPtr librarie
         }
 
         // Check for any udim set.
-        mx::ValuePtr udimSetValue = doc->getGeomPropValue(mx::UDIM_SET_PROPERTY);
+        mx::ConstValuePtr udimSetValue = doc->getGeomPropValue(mx::UDIM_SET_PROPERTY);
 
         // Create new materials.
         mx::TypedElementPtr udimElement;
@@ -1330,40 +1331,38 @@ void Viewer::loadDocument(const mx::FilePath& filename, mx::DocumentPtr librarie
             // Add new materials to the global vector.
             _materials.insert(_materials.end(), newMaterials.begin(), newMaterials.end());
 
-            mx::MaterialPtr udimMaterial = nullptr;
-            for (mx::MaterialPtr mat : newMaterials)
-            {
-                // Clear cached implementations, in case libraries on the file system have changed.
-                _genContext.clearNodeImplementations();
+            // Clear cached implementations, in case libraries on the file system have changed.
+            _genContext.clearNodeImplementations();
 #ifndef MATERIALXVIEW_METAL_BACKEND
-                _genContextEssl.clearNodeImplementations();
+            _genContextEssl.clearNodeImplementations();
 #endif
 
-                mx::TypedElementPtr elem = mat->getElement();
-
-                std::string udim = mat->getUdim();
-                if (!udim.empty())
+            // Select the materials needing a shader of their own, reusing a single shader
+            // across all udims of an element.
+            std::vector<mx::MaterialPtr> generatedMaterials;
+            std::vector<std::pair<mx::MaterialPtr, mx::MaterialPtr>> udimCopies;
+            mx::MaterialPtr udimMaterial = nullptr;
+            for (mx::MaterialPtr mat : newMaterials)
+            {
+                if (!mat->getUdim().empty() && udimElement == mat->getElement())
                 {
-                    if ((udimElement == elem) && udimMaterial)
+                    if (udimMaterial)
                     {
-                        // Reuse existing material for all udims
-                        mat->copyShader(udimMaterial);
+                        udimCopies.emplace_back(mat, udimMaterial);
+                        continue;
                     }
-                    else
-                    {
-                        // Generate a shader for the new material.
-                        mat->generateShader(_genContext);
-                        if (udimElement == elem)
-                        {
-                            udimMaterial = mat;
-                        }
-                    }
-                }
-                else
-                {
-                    // Generate a shader for the new material.
-                    mat->generateShader(_genContext);
+                    udimMaterial = mat;
                 }
+                generatedMaterials.push_back(mat);
+            }
+
+            // Generate shaders for the new materials in parallel.
+            mx::ScopedTimer generateTimer;
+            mx::generateShaders(generatedMaterials, _genContext);
+            recordStage("generate", generateTimer.elapsedTime());
+            for (auto& [mat, sourceMaterial] : udimCopies)
+            {
+                mat->copyShader(sourceMaterial);
             }
 
             // Apply material assignments in the order in which they are declared within the document,
@@ -1464,14 +1463,40 @@ void Viewer::loadDocument(const mx::FilePath& filename, mx::DocumentPtr librarie
     perform_layout();
 }
 
-void Viewer::reloadShaders()
+bool Viewer::loadMaterialDocument(const mx::FilePath& filename)
 {
-    try
+    _materialFilename = _searchPath.find(filename);
+    loadDocument(_materialFilename, _stdLib);
+    return !_materials.empty() && !_materialAssignments.empty();
+}
+
+#ifndef MATERIALXVIEW_METAL_BACKEND
+void Viewer::setMaterialProgram(mx::GlslMaterialPtr material, mx::GlslProgramPtr program)
+{
+    std::vector<mx::MeshPartitionPtr> assignedMeshes;
+    for (auto& [mesh, materialAssignment] : _materialAssignments)
     {
-        for (mx::MaterialPtr material : _materials)
+        if (materialAssignment == material)
         {
-            material->generateShader(_genContext);
+            assignedMeshes.push_back(mesh);
         }
+    }
+    for (mx::MeshPartitionPtr mesh : assignedMeshes)
+    {
+        assignMaterial(mesh, material, false);
+    }
+
+    // Programs are shared between materials, and each material binds its
+    // own uniform values to the program in GlslMaterial::bindShader.
+    material->setProgram(program);
+}
+#endif
+
+void Viewer::reloadShaders()
+{
+    try
+    {
+        mx::generateShaders(_materials, _genContext);
         return;
     }
     catch (mx::ExceptionRenderError& e)
@@ -2148,21 +2173,6 @@ void Viewer::_finish_frame()
         _frameTimer.startTimer();
     }
 
-    if (requestedRenderResolution.has_value()) {
-        if (this->size() == requestedRenderResolution.value()) {
-            requestedRenderResolution.reset();
-
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->framebuffer);
-            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-
-            glBlitFramebuffer(0, 0, this->size().x(), this->size().y(),
-                0, 0, this->size().x(), this->size().y(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
-            glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
-            this->requestedRender = _renderPipeline->getFrameImage();
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        }
-    }
-
     // Capture the current frame.
     if (hasPendingCaptureRequest() && !_turntableEnabled)
     {
@@ -2202,31 +2212,6 @@ void Viewer::draw_contents()
 {
     int w, h;
     glfwGetFramebufferSize(this->glfw_window(), &w, &h);
-    if (this->fb_width != w || this->fb_height != h) {
-        if (this->framebuffer == -1) {
-            glGenFramebuffers(1, &this->framebuffer);
-            glGenTextures(1, &this->color0);
-
-            glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
-            glBindTexture(GL_TEXTURE_2D, this->color0);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->color0, 0);
-        } else {
-            glBindTexture(GL_TEXTURE_2D, this->color0);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-            glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
-        }
-
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        this->fb_width = w;
-        this->fb_height = h;
-    }
-
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glViewport(0, 0, w, h);
     _prepare_frame();
@@ -2377,7 +2362,8 @@ void Viewer::updateCameras()
     auto& createOrthographicMatrix = mx::Camera::createOrthographicMatrix;
 #endif
     mx::Matrix44 viewMatrix, projectionMatrix;
-    float aspectRatio = (float) m_size.x() / (float) m_size.y();
+    ng::Vector2i viewSize = _offscreenSize.value_or(m_size);
+    float aspectRatio = (float) viewSize.x() / (float) viewSize.y();
     if (_cameraViewAngle != 0.0f)
     {
         viewMatrix = mx::Camera::createViewMatrix(_cameraPosition, _cameraTarget, _cameraUp);
@@ -2425,7 +2411,7 @@ void Viewer::updateCameras()
         float r = (sphereCenter - _geometryHandler->getMinimumBounds()).getMagnitude();
         _shadowCamera->setWorldMatrix(meshRotation * mx::Matrix44::createTranslation(-sphereCenter));
         _shadowCamera->setProjectionMatrix(mx::Camera::createOrthographicMatrixZP(-r, r, -r, r, 0.0f, r * 2.0f));
-        mx::ValuePtr value = dirLight->getInputValue("direction");
+        mx::ConstValuePtr value = dirLight->getInputValue("direction");
         if (value->isA<mx::Vector3>())
         {
             mx::Vector3 dir = mx::Matrix44::createRotationY(_lightRotation / 180.0f * PI).transformVector(value->asA<mx::Vector3>());
@@ -2565,19 +2551,65 @@ void Viewer::setShaderInterfaceType(mx::ShaderInterfaceType interfaceType)
 
 mx::ImagePtr Viewer::getNextRender(int width, int height)
 {
-    this->requestedRenderResolution = {width, height};
+    mx::ImagePtr image;
+    requestRender(width, height, [&image](uint64_t, mx::ImagePtr frame)
+    {
+        image = frame;
+    });
+    flushRenders();
+    return image;
+}
 
-    while (this->requestedRenderResolution.has_value()) {
-        this->set_size({width, height});
+uint64_t Viewer::requestRender(int width, int height, mx::FrameReadbackQueue::FrameCallback callback)
+{
+    if (!_readbackQueue)
+    {
+        _readbackQueue = mx::FrameReadbackQueue::create(mx::GLReadbackTarget::create());
+    }
 
-        m_redraw = true;
-        draw_all();
+    // Resizing the offscreen target replaces resizing the window, so there is
+    // no need to wait for GLFW.  Frames in flight at another size are completed first.
+    _readbackQueue->setResolution((unsigned int) width, (unsigned int) height);
+    mx::GLReadbackTargetPtr target = std::static_pointer_cast<mx::GLReadbackTarget>(_readbackQueue->getTarget());
 
-        if (this->requestedRenderResolution.has_value()) {
-            // Wait for GLFW to resize the window to the appropriate size
-            usleep(100);
-        }
+    _offscreenSize = ng::Vector2i(width, height);
+    updateCameras();
+    mx::ScopedTimer drawTimer;
+    target->getFramebuffer()->bind();
+    clear();
+    try
+    {
+        _renderPipeline->renderFrame(_colorTexture, SHADOW_MAP_SIZE, DIR_LIGHT_NODE_CATEGORY.c_str());
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Failed to render frame: " << e.what() << std::endl;
+        glDisable(GL_FRAMEBUFFER_SRGB);
     }
+    _offscreenSize.reset();
+    recordStage("draw", drawTimer.elapsedTime());
+
+    // Start the readback, and complete any earlier frames that have already arrived.
+    mx::ScopedTimer readbackTimer;
+    uint64_t frame = _readbackQueue->submit(callback);
+    _readbackQueue->poll();
+    recordStage("readback", readbackTimer.elapsedTime());
 
-    return std::move(this->requestedRender);
+    // Restore state for rendering to the window.
+    updateCameras();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDrawBuffer(GL_BACK);
+    glViewport(0, 0, m_fbsize[0], m_fbsize[1]);
+
+    return frame;
+}
+
+void Viewer::flushRenders()
+{
+    if (_readbackQueue)
+    {
+        mx::ScopedTimer readbackTimer;
+        _readbackQueue->flush();
+        recordStage("readback", readbackTimer.elapsedTime());
+    }
 }
@@ -10,11 +10,15 @@
 #include <MaterialXView/RenderPipeline.h>
 
 #include <MaterialXRender/ShaderMaterial.h>
+#include <MaterialXRender/FrameReadback.h>
 #include <MaterialXRender/Camera.h>
 #include <MaterialXRender/GeometryHandler.h>
 #include <MaterialXRender/LightHandler.h>
 #include <MaterialXRender/ImageHandler.h>
 #include <MaterialXRender/Timer.h>
+#ifndef MATERIALXVIEW_METAL_BACKEND
+#include <MaterialXRenderGlsl/GlslMaterial.h>
+#endif
 #include <nanogui/opengl.h>
 
 #include <MaterialXCore/Unit.h>
@@ -266,6 +270,32 @@ class Viewer : public ng::Screen
 
     mx::ImagePtr getNextRender(int width, int height);
 
+    // Render the current scene into an offscreen target of the given size, and start
+    // the asynchronous readback of the frame.  The callback is invoked with the image
+    // once its readback completes, which may be during a later call.
+    uint64_t requestRender(int width, int height, mx::FrameReadbackQueue::FrameCallback callback);
+
+    // Complete the readback of all requested renders.
+    void flushRenders();
+
+    // Set a callback receiving the duration in seconds of each timed stage: "generate" for
+    // shader generation, "draw" for submitting an offscreen render, and "readback" for
+    // waiting on and delivering rendered frames.
+    void setStageTimingCallback(std::function<void(const std::string&, double)> callback)
+    {
+        _stageTimingCallback = callback;
+    }
+
+    // Load the MaterialX document with the given filename, replacing the current
+    // materials.  Returns true if any renderable material was loaded.
+    bool loadMaterialDocument(const mx::FilePath& filename);
+
+#ifndef MATERIALXVIEW_METAL_BACKEND
+    // Replace the program of the given material, reassigning its geometry and
+    // rebinding its uniform values to the new program.
+    void setMaterialProgram(mx::GlslMaterialPtr material, mx::GlslProgramPtr program);
+#endif
+
     // Assign the given material to the given geometry, or remove any
     // existing assignment if the given material is nullptr.
     void assignMaterial(mx::MeshPartitionPtr geometry, mx::MaterialPtr material, bool updateProperties = true);
@@ -276,12 +306,20 @@ class Viewer : public ng::Screen
     int overdraw_counter = 0;
     GLuint64 last_timer_result = 0;
 
-    int fb_width = 0, fb_height = 0;
-    GLuint framebuffer = -1;
-    GLuint color0;
+    // Readback of offscreen renders, and the size of the offscreen render in progress.
+    mx::FrameReadbackQueuePtr _readbackQueue;
+    std::optional<nanogui::Vector2i> _offscreenSize;
+
+    // Report the duration of a timed stage.
+    void recordStage(const std::string& stage, double seconds)
+    {
+        if (_stageTimingCallback)
+        {
+            _stageTimingCallback(stage, seconds);
+        }
+    }
 
-    std::optional<nanogui::Vector2i> requestedRenderResolution;
-    mx::ImagePtr requestedRender = nullptr;
+    std::function<void(const std::string&, double)> _stageTimingCallback;
 
     void draw_contents() override;
     void _prepare_frame();
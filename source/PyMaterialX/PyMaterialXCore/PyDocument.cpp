@@ -30,19 +30,29 @@ void bindPyDocument(py::module& mod)
         .def("initialize", &mx::Document::initialize)
         .def("copy", &mx::Document::copy)
         .def("importLibrary", &mx::Document::importLibrary)
+        .def("setDataLibrary", &mx::Document::setDataLibrary)
+        .def("getDataLibrary", &mx::Document::getDataLibrary)
+        .def("hasDataLibrary", &mx::Document::hasDataLibrary)
         .def("getReferencedSourceUris", &mx::Document::getReferencedSourceUris)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getNodeGraph", &mx::Document::getNodeGraph)
         .def("getNodeGraphs", &mx::Document::getNodeGraphs)
         .def("removeNodeGraph", &mx::Document::removeNodeGraph)
-        .def("getMatchingPorts", &mx::Document::getMatchingPorts)
+        .def("getMatchingPorts", [](const mx::Document& doc, const std::string& nodeName)
+            {
+                return doc.getMatchingPorts(nodeName).getVector();
+            })
         .def("addGeomInfo", &mx::Document::addGeomInfo,
             py::arg("name") = mx::EMPTY_STRING, py::arg("geom") = mx::UNIVERSAL_GEOM_NAME)
         .def("getGeomInfo", &mx::Document::getGeomInfo)
         .def("getGeomInfos", &mx::Document::getGeomInfos)
         .def("removeGeomInfo", &mx::Document::removeGeomInfo)
-        .def("getGeomPropValue", &mx::Document::getGeomPropValue,
+        .def("getGeomPropValue", [](const mx::Document& doc, const std::string& geomPropName, const std::string& geom) -> mx::ValuePtr
+            {
+                mx::ConstValuePtr value = doc.getGeomPropValue(geomPropName, geom);
+                return value ? value->copy() : nullptr;
+            }),
             py::arg("geomPropName"), py::arg("geom") = mx::UNIVERSAL_GEOM_NAME)
         .def("addGeomPropDef", &mx::Document::addGeomPropDef)
         .def("getGeomPropDef", &mx::Document::getGeomPropDef)
@@ -77,7 +87,10 @@ void bindPyDocument(py::module& mod)
         .def("getNodeDef", &mx::Document::getNodeDef)
         .def("getNodeDefs", &mx::Document::getNodeDefs)
         .def("removeNodeDef", &mx::Document::removeNodeDef)
-        .def("getMatchingNodeDefs", &mx::Document::getMatchingNodeDefs)
+        .def("getMatchingNodeDefs", [](const mx::Document& doc, const std::string& nodeName)
+            {
+                return doc.getMatchingNodeDefs(nodeName).getVector();
+            })
         .def("addAttributeDef", &mx::Document::addAttributeDef)
         .def("getAttributeDef", &mx::Document::getAttributeDef)
         .def("getAttributeDefs", &mx::Document::getAttributeDefs)
@@ -101,7 +114,10 @@ void bindPyDocument(py::module& mod)
         .def("getImplementation", &mx::Document::getImplementation)
         .def("getImplementations", &mx::Document::getImplementations)
         .def("removeImplementation", &mx::Document::removeImplementation)
-        .def("getMatchingImplementations", &mx::Document::getMatchingImplementations)
+        .def("getMatchingImplementations", [](const mx::Document& doc, const std::string& nodeDef)
+            {
+                return doc.getMatchingImplementations(nodeDef).getVector();
+            })
         .def("addUnitDef", &mx::Document::addUnitDef)
         .def("getUnitDef", &mx::Document::getUnitDef)
         .def("getUnitDefs", &mx::Document::getUnitDefs)
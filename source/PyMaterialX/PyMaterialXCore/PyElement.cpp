@@ -141,8 +141,16 @@ void bindPyElement(py::module& mod)
         .def("setImplementationName", &mx::ValueElement::setImplementationName)
         .def("hasImplementationName", &mx::ValueElement::hasImplementationName)
         .def("getImplementationName", &mx::ValueElement::getImplementationName)
-        .def("_getValue", &mx::ValueElement::getValue)
-        .def("_getDefaultValue", &mx::ValueElement::getDefaultValue)
+        .def("_getValue", [](const mx::ValueElement& elem) -> mx::ValuePtr
+            {
+                mx::ConstValuePtr value = elem.getValue();
+                return value ? value->copy() : nullptr;
+            })
+        .def("_getDefaultValue", [](const mx::ValueElement& elem) -> mx::ValuePtr
+            {
+                mx::ConstValuePtr value = elem.getDefaultValue();
+                return value ? value->copy() : nullptr;
+            })
         .def("setUnit", &mx::ValueElement::setUnit)
         .def("hasUnit", &mx::ValueElement::hasUnit)
         .def("getUnit", &mx::ValueElement::getUnit)
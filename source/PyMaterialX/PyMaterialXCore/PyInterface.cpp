@@ -76,7 +76,11 @@ void bindPyInterface(py::module& mod)
         .def("getActiveTokens", &mx::InterfaceElement::getActiveTokens)
         .def("getActiveValueElement", &mx::InterfaceElement::getActiveValueElement)
         .def("getActiveValueElements", &mx::InterfaceElement::getActiveValueElements)
-        .def("_getInputValue", &mx::InterfaceElement::getInputValue)
+        .def("_getInputValue", [](const mx::InterfaceElement& elem, const std::string& name, const std::string& target) -> mx::ValuePtr
+            {
+                mx::ConstValuePtr value = elem.getInputValue(name, target);
+                return value ? value->copy() : nullptr;
+            })
         .def("setTokenValue", &mx::InterfaceElement::setTokenValue)
         .def("getTokenValue", &mx::InterfaceElement::getTokenValue)
         .def("setTarget", &mx::InterfaceElement::setTarget)
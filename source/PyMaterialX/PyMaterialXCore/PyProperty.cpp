@@ -36,7 +36,11 @@ void bindPyProperty(py::module& mod)
         .def("addProperty", &mx::PropertySet::addProperty)
         .def("getProperties", &mx::PropertySet::getProperties)
         .def("removeProperty", &mx::PropertySet::removeProperty)
-        .def("_getPropertyValue", &mx::PropertySet::getPropertyValue)
+        .def("_getPropertyValue", [](const mx::PropertySet& propertySet, const std::string& name) -> mx::ValuePtr
+            {
+                mx::ConstValuePtr value = propertySet.getPropertyValue(name);
+                return value ? value->copy() : nullptr;
+            })
         BIND_PROPERTYSET_TYPE_INSTANCE(integer, int)
         BIND_PROPERTYSET_TYPE_INSTANCE(boolean, bool)
         BIND_PROPERTYSET_TYPE_INSTANCE(float, float)
@@ -7,6 +7,7 @@
 
 #include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/Shader.h>
 
 namespace py = pybind11;
 namespace mx = MaterialX;
@@ -15,6 +16,27 @@ void bindPyGenContext(py::module& mod)
 {
     py::class_<mx::ApplicationVariableHandler>(mod, "ApplicationVariableHandler");
 
+    py::class_<mx::SourceFileCache, mx::SourceFileCachePtr>(mod, "SourceFileCache")
+        .def_static("create", &mx::SourceFileCache::create)
+        .def_static("getDefault", &mx::SourceFileCache::getDefault)
+        .def("readFile", &mx::SourceFileCache::readFile)
+        .def("addFile", &mx::SourceFileCache::addFile)
+        .def("hasAddedFile", &mx::SourceFileCache::hasAddedFile)
+        .def("hasAddedFiles", &mx::SourceFileCache::hasAddedFiles)
+        .def("removeFile", &mx::SourceFileCache::removeFile)
+        .def("clear", &mx::SourceFileCache::clear);
+
+    py::class_<mx::ShaderCache, mx::ShaderCachePtr>(mod, "ShaderCache")
+        .def_static("create", &mx::ShaderCache::create, py::arg("directory") = mx::FilePath())
+        .def("getDirectory", &mx::ShaderCache::getDirectory)
+        .def("generate", &mx::ShaderCache::generate)
+        .def("generateSourceCode", &mx::ShaderCache::generateSourceCode)
+        .def_static("getShaderDescription", &mx::ShaderCache::getShaderDescription)
+        .def_static("getShaderKey", &mx::ShaderCache::getShaderKey)
+        .def("getHitCount", &mx::ShaderCache::getHitCount)
+        .def("getMissCount", &mx::ShaderCache::getMissCount)
+        .def("clear", &mx::ShaderCache::clear);
+
     py::class_<mx::GenContext, mx::GenContextPtr>(mod, "GenContext")
         .def(py::init<mx::ShaderGeneratorPtr>())
         .def("getShaderGenerator", &mx::GenContext::getShaderGenerator)
@@ -22,6 +44,13 @@ void bindPyGenContext(py::module& mod)
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FilePath&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FileSearchPath&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("resolveSourceFile", &mx::GenContext::resolveSourceFile)
+        .def("setSourceFileCache", &mx::GenContext::setSourceFileCache)
+        .def("getSourceFileCache", &mx::GenContext::getSourceFileCache)
+        .def("readSourceFile", &mx::GenContext::readSourceFile)
+        .def("setShaderCache", &mx::GenContext::setShaderCache)
+        .def("getShaderCache", &mx::GenContext::getShaderCache)
+        .def("setTokenSubstitution", &mx::GenContext::setTokenSubstitution)
+        .def("getTokenSubstitutions", &mx::GenContext::getTokenSubstitutions)
         .def("pushUserData", &mx::GenContext::pushUserData)
         .def("setApplicationVariableHandler", &mx::GenContext::setApplicationVariableHandler)
         .def("getApplicationVariableHandler", &mx::GenContext::getApplicationVariableHandler);
@@ -41,5 +41,6 @@ void bindPyGenOptions(py::module& mod)
         .def_readwrite("hwWriteEnvPrefilter", &mx::GenOptions::hwWriteEnvPrefilter)
         .def_readwrite("hwImplicitBitangents", &mx::GenOptions::hwImplicitBitangents)
         .def_readwrite("emitColorTransforms", &mx::GenOptions::emitColorTransforms)
+        .def_readwrite("optimizeShaderGraph", &mx::GenOptions::optimizeShaderGraph)
         .def(py::init<>());
 }
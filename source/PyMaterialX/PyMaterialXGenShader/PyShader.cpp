@@ -20,6 +20,7 @@ void bindPyShader(py::module& mod)
     py::class_<mx::Shader, mx::ShaderPtr>(mod, "Shader")
         .def(py::init<const std::string&, mx::ShaderGraphPtr>())
         .def("getName", &mx::Shader::getName)
+        .def("copy", &mx::Shader::copy)
         .def("hasStage", &mx::Shader::hasStage)
         .def("numStages", &mx::Shader::numStages)
         .def("getStage", static_cast<mx::ShaderStage& (mx::Shader::*)(size_t)>(&mx::Shader::getStage), py::return_value_policy::reference)